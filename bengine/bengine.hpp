@@ -6,9 +6,27 @@
 #include "bengine_fast_vector_2d.hpp"
 #include "bengine_colliders.hpp"
 #include "bengine_physics.hpp"
+#include "bengine_particles.hpp"
+#include "bengine_profiler.hpp"
+#include "bengine_job_system.hpp"
+#include "bengine_frame_pacer.hpp"
 
+#include "bengine_circle_shapes.hpp"
+#include "bengine_software_canvas.hpp"
 #include "bengine_texture.hpp"
+#include "bengine_texture_manager.hpp"
+#include "bengine_animation.hpp"
+#include "bengine_texture_atlas.hpp"
+#include "bengine_text_cache.hpp"
+#include "bengine_async_loader.hpp"
+#include "bengine_draw_command_buffer.hpp"
+#include "bengine_frame_capture.hpp"
+#include "bengine_sprite_batch.hpp"
+#include "bengine_tilemap.hpp"
+#include "bengine_viewport_transform.hpp"
 #include "bengine_render_window.hpp"
+#include "bengine_event_dispatcher.hpp"
+#include "bengine_event_recording.hpp"
 #include "bengine_mouse.hpp"
 #include "bengine_loop.hpp"
 
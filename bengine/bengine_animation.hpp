@@ -0,0 +1,475 @@
+#ifndef BENGINE_ANIMATION_hpp
+#define BENGINE_ANIMATION_hpp
+
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "bengine_texture.hpp"
+
+namespace bengine {
+    /** Holds the frames of every animation clip in one contiguous table (each clip is a run of frames with their durations)
+     * Frames are worked out once when a clip is added, so playing an animation only has to pick the current frame out of the table instead of building an SDL_Rect every tick
+     */
+    class animation_library {
+        public:
+            // \brief What a clip does once it reaches its last frame
+            enum class loop_mode : unsigned char {
+                // \brief Stop on the last frame
+                ONCE = 0,
+                // \brief Go back to the first frame
+                LOOP = 1,
+                // \brief Play backwards to the first frame, then forwards again
+                PING_PONG = 2
+            };
+
+            // \brief A run of frames in the frame table
+            struct clip {
+                Uint32 first = 0;
+                Uint32 count = 0;
+                bengine::animation_library::loop_mode mode = bengine::animation_library::loop_mode::LOOP;
+                // \brief How long it takes to get back to the same frame going the same direction (s) (0 for clips that play once)
+                float cycle = 0;
+            };
+
+        private:
+            std::vector<SDL_Rect> frames;
+            // \brief How long each frame is shown (s)
+            std::vector<float> durations;
+            std::vector<bengine::animation_library::clip> clips;
+
+        public:
+            // \brief bengine::animation_library constructor
+            animation_library() {}
+            // \brief bengine::animation_library deconstructor
+            ~animation_library() {}
+
+            /** Add a clip made of frames with their own durations
+             * \param frames The portion of the texture to show for each frame
+             * \param durations How long to show each frame (s) (anything shorter than a microsecond is lengthened to one)
+             * \param count The amount of frames
+             * \param mode What the clip does once it reaches its last frame
+             * \returns The index of the clip or -1 if it has no frames
+             */
+            int add_clip(const SDL_Rect *frames, const float *durations, const std::size_t &count, const bengine::animation_library::loop_mode &mode = bengine::animation_library::loop_mode::LOOP) {
+                if (count == 0) {
+                    std::cout << "Animation clip has no frames [bengine::animation_library::add_clip]\n";
+                    return -1;
+                }
+                bengine::animation_library::clip output;
+                output.first = static_cast<Uint32>(this->frames.size());
+                output.count = static_cast<Uint32>(count);
+                output.mode = mode;
+
+                float total = 0;
+                for (std::size_t i = 0; i < count; i++) {
+                    // zero-length frames would keep stepping forever without using up any time
+                    const float duration = durations[i] > 0.000001f ? durations[i] : 0.000001f;
+                    this->frames.push_back(frames[i]);
+                    this->durations.push_back(duration);
+                    total += duration;
+                }
+                if (mode == bengine::animation_library::loop_mode::LOOP) {
+                    output.cycle = total;
+                } else if (mode == bengine::animation_library::loop_mode::PING_PONG) {
+                    // the first and last frames are only shown once per trip there and back
+                    output.cycle = count > 1 ? total * 2 - this->durations[output.first] - this->durations[output.first + count - 1] : total;
+                }
+                this->clips.push_back(output);
+                return static_cast<int>(this->clips.size() - 1);
+            }
+            /** Add a clip made of frames that are all shown for the same amount of time
+             * \param frames The portion of the texture to show for each frame
+             * \param duration How long to show each frame (s)
+             * \param mode What the clip does once it reaches its last frame
+             * \returns The index of the clip or -1 if it has no frames
+             */
+            int add_clip(const std::vector<SDL_Rect> &frames, const float &duration, const bengine::animation_library::loop_mode &mode = bengine::animation_library::loop_mode::LOOP) {
+                const std::vector<float> durations(frames.size(), duration);
+                return this->add_clip(frames.data(), durations.data(), frames.size(), mode);
+            }
+            /** Add a clip from a sprite sheet laid out as a grid (frames go left to right, then top to bottom)
+             * \param x x-position of the first frame on the texture (px)
+             * \param y y-position of the first frame on the texture (px)
+             * \param w Width of each frame (px)
+             * \param h Height of each frame (px)
+             * \param columns The amount of frames in each row of the grid
+             * \param count The amount of frames
+             * \param duration How long to show each frame (s)
+             * \param mode What the clip does once it reaches its last frame
+             * \returns The index of the clip or -1 if it has no frames
+             */
+            int add_grid_clip(const int &x, const int &y, const int &w, const int &h, const int &columns, const std::size_t &count, const float &duration, const bengine::animation_library::loop_mode &mode = bengine::animation_library::loop_mode::LOOP) {
+                std::vector<SDL_Rect> frames(count);
+                const int row_length = columns > 0 ? columns : 1;
+                for (std::size_t i = 0; i < count; i++) {
+                    frames[i] = {x + static_cast<int>(i % row_length) * w, y + static_cast<int>(i / row_length) * h, w, h};
+                }
+                return this->add_clip(frames, duration, mode);
+            }
+
+            /** Get a clip
+             * \param index The index of the clip (must be valid)
+             * \returns The clip
+             */
+            const bengine::animation_library::clip& get_clip(const std::size_t &index) const {
+                return this->clips[index];
+            }
+            /** Get the amount of clips
+             * \returns The amount of clips
+             */
+            std::size_t get_clip_count() const {
+                return this->clips.size();
+            }
+            /** Get a frame out of the frame table
+             * \param clip The index of the clip (must be valid)
+             * \param frame The frame within the clip (must be valid)
+             * \returns The portion of the texture to show
+             */
+            const SDL_Rect& get_frame(const Uint32 &clip, const Uint32 &frame) const {
+                return this->frames[this->clips[clip].first + frame];
+            }
+            // \brief Remove every clip (anything playing them has to be given new clips)
+            void clear() {
+                this->frames.clear();
+                this->durations.clear();
+                this->clips.clear();
+            }
+
+            /** Move a clip's playback forward; shared by bengine::animated_texture and bengine::animation_set so that they always agree
+             * \param clip The index of the clip being played (must be valid)
+             * \param frame The current frame within the clip (gets updated)
+             * \param time How long the current frame has been shown (s) (gets updated)
+             * \param direction 1 while playing forwards or -1 while playing backwards (gets updated, only ping-pong clips go backwards)
+             * \param dt How much time to move forward by (s) (already multiplied by the playback rate)
+             * \returns Whether the clip is still playing or not (clips that play once stop on their last frame)
+             */
+            bool step(const Uint32 &clip, Uint32 &frame, float &time, signed char &direction, const float &dt) const {
+                const bengine::animation_library::clip &current = this->clips[clip];
+                const float *durations = this->durations.data() + current.first;
+                time += dt;
+                // skipping whole cycles ends up on the same frame going the same way, so long frames never have to be walked one frame at a time
+                if (current.cycle > 0 && time >= current.cycle) {
+                    time = std::fmod(time, current.cycle);
+                }
+                while (time >= durations[frame]) {
+                    time -= durations[frame];
+                    if (current.mode == bengine::animation_library::loop_mode::LOOP) {
+                        frame = frame + 1 < current.count ? frame + 1 : 0;
+                    } else if (current.mode == bengine::animation_library::loop_mode::ONCE) {
+                        if (frame + 1 >= current.count) {
+                            time = 0;
+                            return false;
+                        }
+                        frame++;
+                    } else if (current.count > 1) {
+                        if ((direction > 0 && frame + 1 >= current.count) || (direction < 0 && frame == 0)) {
+                            direction = -direction;
+                        }
+                        frame += direction;
+                    }
+                }
+                return true;
+            }
+    };
+
+    // \brief A bengine::shifting_texture that plays clips from a bengine::animation_library (for a handful of sprites; bengine::animation_set updates lots of them at once)
+    class animated_texture : public bengine::shifting_texture {
+        private:
+            const bengine::animation_library *library = NULL;
+            Uint32 clip = 0;
+            Uint32 frame = 0;
+            float time = 0;
+            // \brief How fast the clip plays (1 = normal speed)
+            float rate = 1;
+            signed char direction = 1;
+            bool playing = false;
+
+            // \brief Show the current frame of the clip
+            void update_frame() {
+                if (this->library != NULL && this->clip < this->library->get_clip_count()) {
+                    this->set_frame(this->library->get_frame(this->clip, this->frame));
+                }
+            }
+
+        public:
+            /** bengine::animated_texture constructor
+             * \param texture The SDL_Texture to use as a source (usually a sprite sheet)
+             * \param library The clips to play (must outlive this)
+             * \param owns_texture Whether the source texture should be destroyed along with this or not
+             */
+            animated_texture(SDL_Texture *texture = NULL, const bengine::animation_library *library = NULL, const bool &owns_texture = true) : bengine::shifting_texture(texture, {}, {}, 0, {255, 255, 255, 255}, owns_texture) {
+                this->library = library;
+            }
+            // \brief bengine::animated_texture deconstructor
+            ~animated_texture() {}
+            // \brief Copy constructor; the copy shares the source texture but never owns it
+            animated_texture(const bengine::animated_texture &rhs) = default;
+            // \brief Move constructor; ownership of the source texture moves over as well
+            animated_texture(bengine::animated_texture &&rhs) = default;
+            bengine::animated_texture& operator=(const bengine::animated_texture &rhs) = default;
+            bengine::animated_texture& operator=(bengine::animated_texture &&rhs) = default;
+
+            /** Set the clips to play (stops the current clip)
+             * \param library The clips to play (must outlive this)
+             */
+            void set_library(const bengine::animation_library *library) {
+                this->library = library;
+                this->playing = false;
+            }
+            /** Start playing a clip
+             * \param clip The index of the clip in the library
+             * \param restart Whether to start over if the clip is already the current one
+             * \returns 0 on success or -1 if the clip doesn't exist
+             */
+            int play(const Uint32 &clip, const bool &restart = false) {
+                if (this->library == NULL || clip >= this->library->get_clip_count()) {
+                    std::cout << "Animated texture can't play clip " << clip << " [bengine::animated_texture::play]\n";
+                    return -1;
+                }
+                if (restart || clip != this->clip || !this->playing) {
+                    this->clip = clip;
+                    this->frame = 0;
+                    this->time = 0;
+                    this->direction = 1;
+                }
+                this->playing = true;
+                this->update_frame();
+                return 0;
+            }
+            // \brief Stop on the current frame
+            void pause() {
+                this->playing = false;
+            }
+            // \brief Continue from the current frame
+            void resume() {
+                this->playing = this->library != NULL && this->clip < this->library->get_clip_count();
+            }
+            /** Get whether a clip is playing or not (clips that play once stop by themselves)
+             * \returns Whether a clip is playing or not
+             */
+            bool is_playing() const {
+                return this->playing;
+            }
+            /** Get the clip being played
+             * \returns The index of the clip in the library
+             */
+            Uint32 get_clip() const {
+                return this->clip;
+            }
+            /** Get the current frame within the clip
+             * \returns The current frame within the clip
+             */
+            Uint32 get_frame_index() const {
+                return this->frame;
+            }
+            /** Get how fast the clip plays
+             * \returns The playback rate (1 = normal speed)
+             */
+            float get_rate() const {
+                return this->rate;
+            }
+            /** Set how fast the clip plays
+             * \param rate The playback rate (1 = normal speed, negative rates are treated as 0)
+             */
+            void set_rate(const float &rate) {
+                this->rate = rate > 0 ? rate : 0;
+            }
+
+            /** Move the animation forward
+             * \param dt How much time has passed (s)
+             */
+            void advance(const double &dt) {
+                if (!this->playing) {
+                    return;
+                }
+                this->playing = this->library->step(this->clip, this->frame, this->time, this->direction, static_cast<float>(dt) * this->rate);
+                this->update_frame();
+            }
+    };
+
+    /** Plays clips from a bengine::animation_library for lots of sprites at once
+     * The state of every animation is stored as structure-of-arrays and advance_all() steps them all in one plain loop (no virtual calls, no per-sprite objects), leaving the current frames in a contiguous array that can be read straight into something like a bengine::sprite_batch
+     */
+    class animation_set {
+        private:
+            const bengine::animation_library *library = NULL;
+
+            std::vector<Uint32> clips;
+            std::vector<Uint32> frames;
+            std::vector<float> times;
+            std::vector<float> rates;
+            std::vector<signed char> directions;
+            std::vector<unsigned char> playing;
+            // \brief The current frame of every animation, kept up to date by advance_all()
+            std::vector<SDL_Rect> current_frames;
+
+        public:
+            /** bengine::animation_set constructor
+             * \param library The clips to play (must outlive this)
+             */
+            animation_set(const bengine::animation_library *library = NULL) {
+                this->library = library;
+            }
+            // \brief bengine::animation_set deconstructor
+            ~animation_set() {}
+
+            /** Set the clips to play (removes every animation, since their clips belonged to the old library)
+             * \param library The clips to play (must outlive this)
+             */
+            void set_library(const bengine::animation_library *library) {
+                this->clear();
+                this->library = library;
+            }
+            /** Make room for animations ahead of time
+             * \param count The amount of animations to make room for
+             */
+            void reserve(const std::size_t &count) {
+                this->clips.reserve(count);
+                this->frames.reserve(count);
+                this->times.reserve(count);
+                this->rates.reserve(count);
+                this->directions.reserve(count);
+                this->playing.reserve(count);
+                this->current_frames.reserve(count);
+            }
+            // \brief Remove every animation
+            void clear() {
+                this->clips.clear();
+                this->frames.clear();
+                this->times.clear();
+                this->rates.clear();
+                this->directions.clear();
+                this->playing.clear();
+                this->current_frames.clear();
+            }
+            /** Get the amount of animations
+             * \returns The amount of animations
+             */
+            std::size_t get_count() const {
+                return this->clips.size();
+            }
+
+            /** Add an animation that starts playing a clip from its first frame
+             * \param clip The index of the clip in the library
+             * \param rate How fast the clip plays (1 = normal speed)
+             * \returns The index of the animation or -1 if the clip doesn't exist
+             */
+            int add(const Uint32 &clip, const float &rate = 1) {
+                if (this->library == NULL || clip >= this->library->get_clip_count()) {
+                    std::cout << "Animation set can't play clip " << clip << " [bengine::animation_set::add]\n";
+                    return -1;
+                }
+                this->clips.push_back(clip);
+                this->frames.push_back(0);
+                this->times.push_back(0);
+                this->rates.push_back(rate > 0 ? rate : 0);
+                this->directions.push_back(1);
+                this->playing.push_back(1);
+                this->current_frames.push_back(this->library->get_frame(clip, 0));
+                return static_cast<int>(this->clips.size() - 1);
+            }
+            /** Remove an animation by moving the last one into its place (so the last animation's index becomes this one)
+             * \param index The index of the animation (must be valid)
+             */
+            void remove(const std::size_t &index) {
+                const std::size_t last = this->clips.size() - 1;
+                this->clips[index] = this->clips[last];
+                this->frames[index] = this->frames[last];
+                this->times[index] = this->times[last];
+                this->rates[index] = this->rates[last];
+                this->directions[index] = this->directions[last];
+                this->playing[index] = this->playing[last];
+                this->current_frames[index] = this->current_frames[last];
+                this->clips.pop_back();
+                this->frames.pop_back();
+                this->times.pop_back();
+                this->rates.pop_back();
+                this->directions.pop_back();
+                this->playing.pop_back();
+                this->current_frames.pop_back();
+            }
+
+            /** Start playing a different clip from its first frame
+             * \param index The index of the animation (must be valid)
+             * \param clip The index of the clip in the library
+             * \returns 0 on success or -1 if the clip doesn't exist
+             */
+            int play(const std::size_t &index, const Uint32 &clip) {
+                if (clip >= this->library->get_clip_count()) {
+                    std::cout << "Animation set can't play clip " << clip << " [bengine::animation_set::play]\n";
+                    return -1;
+                }
+                this->clips[index] = clip;
+                this->frames[index] = 0;
+                this->times[index] = 0;
+                this->directions[index] = 1;
+                this->playing[index] = 1;
+                this->current_frames[index] = this->library->get_frame(clip, 0);
+                return 0;
+            }
+            /** Set whether an animation is playing (paused animations stay on their current frame)
+             * \param index The index of the animation (must be valid)
+             * \param playing Whether the animation is playing or not
+             */
+            void set_playing(const std::size_t &index, const bool &playing) {
+                this->playing[index] = playing;
+            }
+            /** Get whether an animation is playing or not (clips that play once stop by themselves)
+             * \param index The index of the animation (must be valid)
+             * \returns Whether the animation is playing or not
+             */
+            bool is_playing(const std::size_t &index) const {
+                return this->playing[index] != 0;
+            }
+            /** Set how fast an animation plays
+             * \param index The index of the animation (must be valid)
+             * \param rate The playback rate (1 = normal speed, negative rates are treated as 0)
+             */
+            void set_rate(const std::size_t &index, const float &rate) {
+                this->rates[index] = rate > 0 ? rate : 0;
+            }
+            /** Get the current frame within an animation's clip
+             * \param index The index of the animation (must be valid)
+             * \returns The current frame within the clip
+             */
+            Uint32 get_frame_index(const std::size_t &index) const {
+                return this->frames[index];
+            }
+            /** Get the portion of the texture an animation is currently showing
+             * \param index The index of the animation (must be valid)
+             * \returns The portion of the texture to show
+             */
+            const SDL_Rect& get_frame(const std::size_t &index) const {
+                return this->current_frames[index];
+            }
+            /** Get the portion of the texture every animation is currently showing (in the same order as the animations)
+             * \returns The current frames (get_count() of them)
+             */
+            const SDL_Rect* get_frames() const {
+                return this->current_frames.data();
+            }
+
+            /** Move every playing animation forward
+             * \param dt How much time has passed (s)
+             */
+            void advance_all(const double &dt) {
+                const float step = static_cast<float>(dt);
+                const std::size_t count = this->clips.size();
+                for (std::size_t i = 0; i < count; i++) {
+                    if (!this->playing[i]) {
+                        continue;
+                    }
+                    const Uint32 previous = this->frames[i];
+                    this->playing[i] = this->library->step(this->clips[i], this->frames[i], this->times[i], this->directions[i], step * this->rates[i]);
+                    // most animations stay on the same frame from one tick to the next, so the frame table is only touched when they don't
+                    if (this->frames[i] != previous) {
+                        this->current_frames[i] = this->library->get_frame(this->clips[i], this->frames[i]);
+                    }
+                }
+            }
+    };
+}
+
+#endif // BENGINE_ANIMATION_hpp
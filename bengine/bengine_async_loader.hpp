@@ -0,0 +1,289 @@
+#ifndef BENGINE_ASYNC_LOADER_hpp
+#define BENGINE_ASYNC_LOADER_hpp
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bengine_texture_atlas.hpp"
+
+namespace bengine {
+    /** Decodes image files on background threads and uploads them to textures on the main thread a few at a time
+     * Decoding (the slow part) never touches the renderer, so it can overlap with rendering; uploading has to happen on the thread that owns the renderer, which is what bengine::async_loader::update() is for
+     */
+    class async_loader {
+        public:
+            // \brief Where a request is in the pipeline
+            enum class load_status : unsigned char {
+                // \brief Waiting to be decoded or uploaded
+                LOADING = 0,
+                // \brief Uploaded and ready to use
+                READY = 1,
+                // \brief The file couldn't be decoded or uploaded
+                FAILED = 2
+            };
+
+        private:
+            // \brief The state shared between a request's handle and the loader
+            struct request {
+                std::string path;
+                // \brief The atlas to pack the image into (NULL gives the image its own texture)
+                bengine::texture_atlas *atlas = NULL;
+                bengine::async_loader::load_status status = bengine::async_loader::load_status::LOADING;
+                SDL_Surface *surface = NULL;
+                SDL_Texture *texture = NULL;
+                SDL_Rect frame = {};
+            };
+
+        public:
+            // \brief A request's result; it can be checked every frame without blocking
+            class handle {
+                friend class bengine::async_loader;
+
+                private:
+                    std::shared_ptr<bengine::async_loader::request> state;
+
+                    handle(const std::shared_ptr<bengine::async_loader::request> &state) {
+                        this->state = state;
+                    }
+
+                public:
+                    // \brief bengine::async_loader::handle constructor (an empty handle that never becomes ready)
+                    handle() {}
+
+                    /** Get where the request is in the pipeline (only changes during bengine::async_loader::update(), so it is safe to check from the main thread)
+                     * \returns Where the request is in the pipeline
+                     */
+                    bengine::async_loader::load_status get_status() const {
+                        return this->state ? this->state->status : bengine::async_loader::load_status::FAILED;
+                    }
+                    /** Get whether the texture is ready to use or not
+                     * \returns Whether the texture is ready to use or not
+                     */
+                    bool is_ready() const {
+                        return this->get_status() == bengine::async_loader::load_status::READY;
+                    }
+                    /** Get whether the request is finished (successfully or not) or not
+                     * \returns Whether the request is finished or not
+                     */
+                    bool is_finished() const {
+                        return this->get_status() == bengine::async_loader::load_status::READY || this->get_status() == bengine::async_loader::load_status::FAILED;
+                    }
+                    /** Get the path of the file being loaded
+                     * \returns The path of the file being loaded
+                     */
+                    std::string get_path() const {
+                        return this->state ? this->state->path : "";
+                    }
+                    /** Get the loaded texture; the caller owns it (like with bengine::render_window::load_texture()) unless it was packed into an atlas or taken with bengine::async_loader::handle::take_texture()
+                     * \returns The loaded texture, or NULL if it isn't ready or has been taken
+                     */
+                    SDL_Texture* get_texture() const {
+                        return this->is_ready() ? this->state->texture : NULL;
+                    }
+                    /** Get the loaded image as a bengine::basic_texture that never owns the texture (so it can be called as often as needed)
+                     * \returns The loaded image, or an empty texture if it isn't ready or has been taken
+                     */
+                    bengine::basic_texture get_basic_texture() const {
+                        if (!this->is_ready()) {
+                            return bengine::basic_texture(NULL, {}, false);
+                        }
+                        return bengine::basic_texture(this->state->texture, this->state->frame, false);
+                    }
+                    /** Take the loaded image as a bengine::basic_texture that owns the texture (unless it was packed into an atlas); only the first call gets the texture, and every handle to the request is left without one afterwards
+                     * \returns The loaded image, or an empty texture if it isn't ready or has already been taken
+                     */
+                    bengine::basic_texture take_texture() {
+                        if (!this->is_ready() || this->state->texture == NULL) {
+                            return bengine::basic_texture(NULL, {}, false);
+                        }
+                        SDL_Texture *texture = this->state->texture;
+                        this->state->texture = NULL;
+                        return bengine::basic_texture(texture, this->state->frame, this->state->atlas == NULL);
+                    }
+            };
+
+        private:
+            std::vector<std::thread> workers;
+            // \brief The amount of worker threads to start once the first request comes in
+            unsigned int worker_count;
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool stopping = false;
+
+            // \brief Requests waiting for a worker (guarded by the mutex)
+            std::deque<std::shared_ptr<bengine::async_loader::request>> decode_queue;
+            // \brief Requests waiting to be uploaded (guarded by the mutex)
+            std::deque<std::shared_ptr<bengine::async_loader::request>> upload_queue;
+
+            // \brief Counts for progress reporting (only touched on the main thread)
+            unsigned long requested = 0;
+            unsigned long finished = 0;
+            unsigned long failed = 0;
+
+            void work() {
+                while (true) {
+                    std::shared_ptr<bengine::async_loader::request> request;
+                    {
+                        std::unique_lock<std::mutex> lock(this->mutex);
+                        this->wake.wait(lock, [this]() {return this->stopping || !this->decode_queue.empty();});
+                        if (this->stopping) {
+                            return;
+                        }
+                        request = this->decode_queue.front();
+                        this->decode_queue.pop_front();
+                    }
+
+                    SDL_Surface *surface = IMG_Load(request->path.c_str());
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    request->surface = surface;
+                    this->upload_queue.push_back(request);
+                }
+            }
+
+        public:
+            /** bengine::async_loader constructor (no threads are started until the first request)
+             * \param worker_count The amount of threads to decode with (0 uses one fewer than the amount of CPU cores, but at least one)
+             */
+            async_loader(const unsigned int &worker_count = 0) {
+                this->worker_count = worker_count;
+            }
+            // \brief bengine::async_loader deconstructor; stops the workers and frees anything that was never uploaded
+            ~async_loader() {
+                this->shutdown();
+            }
+            async_loader(const bengine::async_loader&) = delete;
+            bengine::async_loader& operator=(const bengine::async_loader&) = delete;
+
+            // \brief Stop every worker thread, dropping any requests that haven't been decoded or uploaded yet (they are marked as failed)
+            void shutdown() {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->stopping = true;
+                }
+                this->wake.notify_all();
+                for (std::size_t i = 0; i < this->workers.size(); i++) {
+                    this->workers[i].join();
+                }
+                this->workers.clear();
+                this->stopping = false;
+
+                for (std::size_t i = 0; i < this->decode_queue.size(); i++) {
+                    this->decode_queue[i]->status = bengine::async_loader::load_status::FAILED;
+                }
+                for (std::size_t i = 0; i < this->upload_queue.size(); i++) {
+                    SDL_FreeSurface(this->upload_queue[i]->surface);
+                    this->upload_queue[i]->surface = NULL;
+                    this->upload_queue[i]->status = bengine::async_loader::load_status::FAILED;
+                }
+                this->failed += this->decode_queue.size() + this->upload_queue.size();
+                this->finished += this->decode_queue.size() + this->upload_queue.size();
+                this->decode_queue.clear();
+                this->upload_queue.clear();
+            }
+
+            /** Start loading an image file
+             * \param path The path of the image file
+             * \param atlas The atlas to pack the image into when it is uploaded (NULL gives the image its own texture)
+             * \returns A handle to check on the request with
+             */
+            bengine::async_loader::handle load(const std::string &path, bengine::texture_atlas *atlas = NULL) {
+                if (this->workers.empty()) {
+                    const int cores = SDL_GetCPUCount();
+                    const unsigned int count = this->worker_count > 0 ? this->worker_count : (cores > 2 ? cores - 1 : 1);
+                    for (unsigned int i = 0; i < count; i++) {
+                        this->workers.emplace_back(&bengine::async_loader::work, this);
+                    }
+                }
+
+                std::shared_ptr<bengine::async_loader::request> request = std::make_shared<bengine::async_loader::request>();
+                request->path = path;
+                request->atlas = atlas;
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->decode_queue.push_back(request);
+                }
+                this->wake.notify_one();
+                this->requested++;
+                return bengine::async_loader::handle(request);
+            }
+
+            /** Upload decoded images to textures; call once per frame on the thread that owns the renderer
+             * \param renderer The renderer to make the textures with
+             * \param max_uploads The most images to upload this call (keeps big loads from stalling a single frame)
+             * \returns The amount of requests that finished during this call
+             */
+            unsigned int update(SDL_Renderer *renderer, const unsigned int &max_uploads = 4) {
+                unsigned int output = 0;
+                while (output < max_uploads) {
+                    std::shared_ptr<bengine::async_loader::request> request;
+                    {
+                        std::lock_guard<std::mutex> lock(this->mutex);
+                        if (this->upload_queue.empty()) {
+                            break;
+                        }
+                        request = this->upload_queue.front();
+                        this->upload_queue.pop_front();
+                    }
+
+                    if (request->surface == NULL) {
+                        std::cout << "Async loader failed to decode \"" << request->path << "\" [bengine::async_loader::update]\nERROR [" << SDL_GetTicks() << "]: " << IMG_GetError() << "\n";
+                    } else if (request->atlas != NULL) {
+                        const bengine::basic_texture packed = request->atlas->add(request->path, request->surface);
+                        request->texture = packed.get_texture();
+                        request->frame = packed.get_frame();
+                    } else if ((request->texture = SDL_CreateTextureFromSurface(renderer, request->surface)) == NULL) {
+                        std::cout << "Async loader failed to upload \"" << request->path << "\" [bengine::async_loader::update]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                    } else {
+                        request->frame = {0, 0, request->surface->w, request->surface->h};
+                    }
+                    SDL_FreeSurface(request->surface);
+                    request->surface = NULL;
+
+                    request->status = request->texture == NULL ? bengine::async_loader::load_status::FAILED : bengine::async_loader::load_status::READY;
+                    this->failed += request->texture == NULL ? 1 : 0;
+                    this->finished++;
+                    output++;
+                }
+                return output;
+            }
+
+            /** Get the amount of requests that haven't finished yet
+             * \returns The amount of requests that haven't finished yet
+             */
+            unsigned long get_pending_count() const {
+                return this->requested - this->finished;
+            }
+            /** Get the amount of requests that failed
+             * \returns The amount of requests that failed
+             */
+            unsigned long get_failed_count() const {
+                return this->failed;
+            }
+            /** Get how much of everything requested so far has finished
+             * \returns The fraction of requests that have finished (1 when nothing has been requested)
+             */
+            double get_progress() const {
+                return this->requested == 0 ? 1 : static_cast<double>(this->finished) / this->requested;
+            }
+            /** Block until every request has been decoded and uploaded (useful for loading screens that can't show anything until everything is in)
+             * \param renderer The renderer to make the textures with
+             */
+            void finish(SDL_Renderer *renderer) {
+                while (this->get_pending_count() > 0) {
+                    if (this->update(renderer, static_cast<unsigned int>(-1)) == 0) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+    };
+}
+
+#endif // BENGINE_ASYNC_LOADER_hpp
@@ -0,0 +1,93 @@
+#ifndef BENGINE_CIRCLE_SHAPES_hpp
+#define BENGINE_CIRCLE_SHAPES_hpp
+
+#include <SDL2/SDL.h>
+#include <unordered_map>
+#include <vector>
+
+namespace bengine {
+    // \brief Rasterized circles (from the midpoint algorithm) keyed by radius, so that each radius only gets generated once no matter what draws it
+    class circle_shape_cache {
+        public:
+            // \brief The shape of a circle of a given radius, relative to its center
+            struct shape {
+                // \brief Every point on the perimeter (from the midpoint algorithm, all eight octants)
+                std::vector<SDL_Point> outline;
+                // \brief Half of the width of the filled span on each row, from the top row (-r) to the bottom row (r)
+                std::vector<int> half_widths;
+            };
+
+        private:
+            std::unordered_map<int, bengine::circle_shape_cache::shape> shapes;
+
+        public:
+            // \brief bengine::circle_shape_cache constructor
+            circle_shape_cache() {}
+            // \brief bengine::circle_shape_cache deconstructor
+            ~circle_shape_cache() {}
+
+            // \brief Forget every generated shape
+            void clear() {
+                this->shapes.clear();
+            }
+
+            /** Get the shape of a circle, generating and caching it if it hasn't been used before
+             * \param r Radius of the circle (px)
+             * \returns The shape of the circle
+             */
+            const bengine::circle_shape_cache::shape& get(const int &r) {
+                std::unordered_map<int, bengine::circle_shape_cache::shape>::iterator found = this->shapes.find(r);
+                if (found != this->shapes.end()) {
+                    return found->second;
+                }
+                bengine::circle_shape_cache::shape &shape = this->shapes[r];
+
+                // perimeter
+                const int diameter = r * 2;
+                int ox = r - 1;
+                int oy = 0;
+                int tx = 1;
+                int ty = 1;
+                int error = tx - diameter;
+                while (ox >= oy) {
+                    shape.outline.insert(shape.outline.end(), {{ox, -oy}, {ox, oy}, {-ox, -oy}, {-ox, oy}, {oy, -ox}, {oy, ox}, {-oy, -ox}, {-oy, ox}});
+                    if (error <= 0) {
+                        oy++;
+                        error += ty;
+                        ty += 2;
+                    } else {
+                        ox--;
+                        tx += 2;
+                        error += tx - diameter;
+                    }
+                }
+
+                // spans; each row keeps the widest span that lands on it
+                shape.half_widths.assign(r * 2 + 1, -1);
+                ox = 0;
+                oy = r;
+                error = r - 1;
+                while (oy >= ox) {
+                    const int rows[4][2] = {{ox, oy}, {oy, ox}, {-oy, ox}, {-ox, oy}};
+                    for (unsigned char i = 0; i < 4; i++) {
+                        int &half_width = shape.half_widths[rows[i][0] + r];
+                        half_width = rows[i][1] > half_width ? rows[i][1] : half_width;
+                    }
+                    if (error >= ox * 2) {
+                        error -= ox * 2 + 1;
+                        ox++;
+                    } else if (error < 2 * (r - oy)) {
+                        error += oy * 2 - 1;
+                        oy--;
+                    } else {
+                        error += 2 * (oy - ox - 1);
+                        oy--;
+                        ox++;
+                    }
+                }
+                return shape;
+            }
+    };
+}
+
+#endif // BENGINE_CIRCLE_SHAPES_hpp
@@ -6,7 +6,13 @@
 #include "bengine_fast_vector_2d.hpp"
 #include "bengine_colliders.hpp"
 #include "bengine_physics.hpp"
+#include "bengine_particles.hpp"
+#include "bengine_profiler.hpp"
+#include "bengine_job_system.hpp"
+#include "bengine_input_recording.hpp"
 
+#include "bengine_terminal_output.hpp"
+#include "bengine_virtual_terminal.hpp"
 #include "bengine_curses_window.hpp"
 #include "bengine_curses_loop.hpp"
 
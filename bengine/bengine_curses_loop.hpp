@@ -3,11 +3,23 @@
 
 #include <chrono>
 #include <cmath>
+#include <cwchar>
 
 #include "bengine_curses_window.hpp"
+#include "bengine_job_system.hpp"
+#include "bengine_profiler.hpp"
+#include "bengine_input_recording.hpp"
 
 namespace bengine {
     class curses_loop {
+        public:
+            // \brief How the loop decides how often to render and sleep
+            enum class pacing_modes : unsigned char {
+                FIXED,          // always run at refresh_rate
+                ADAPTIVE,       // run at maximum_refresh_rate while there is input or visual changes, then drop to minimum_refresh_rate once the loop has been idle for activity_timeout
+                EVENT_DRIVEN    // same as ADAPTIVE while active, but sleep until the next input once idle (time doesn't advance while asleep, so idle stretches aren't computed afterwards)
+            };
+
         protected:
             std::chrono::system_clock::time_point epoch;
 
@@ -18,6 +30,8 @@ namespace bengine {
 
             // \brief How long the loop has been active (in seconds)
             long double time = 0.0;
+            // \brief The amount of compute ticks that have happened since the loop started running
+            unsigned long long tick = 0;
 
             // \brief How long each computation frame should take (in seconds)
             double delta_time = 0.01;
@@ -25,12 +39,41 @@ namespace bengine {
             // \brief A replacement for a monitor's refresh rate, lower values decrease performance impacts but also decrease program responsiveness; overall timing should be constant though
             unsigned short refresh_rate = 5;
 
+            // \brief How the loop decides how often to render and sleep (see bengine::curses_loop::pacing_modes)
+            bengine::curses_loop::pacing_modes pacing_mode = bengine::curses_loop::pacing_modes::FIXED;
+            // \brief The refresh rate used by the adaptive pacing modes while idle
+            unsigned short minimum_refresh_rate = 5;
+            // \brief The refresh rate used by the adaptive pacing modes while there is input or visual changes
+            unsigned short maximum_refresh_rate = 60;
+            // \brief How long the loop has to go without input or visual changes before being considered idle (in milliseconds)
+            unsigned short activity_timeout = 500;
+
+            // \brief Whether to skip rendering for frames where the frame's time budget was already used up before rendering (frame-budget policy; lets compute catch up)
+            bool skip_late_renders = false;
+            // \brief The maximum amount of renders that can be skipped in a row by the frame-budget policy so that the screen never goes stale
+            unsigned char maximum_skipped_renders = 4;
+
             // \brief Whether the loop is running or not
             bool loop_running = true;
             // \brief Whether the to update the visuals or not (saves on performance when nothing visual is happening)
             bool visuals_changed = true;
 
             int input_character = ERR;
+            // \brief The mouse event that goes along with input_character when it is KEY_MOUSE (see enable_mouse())
+            bengine::terminal_output::mouse_event mouse;
+
+            // \brief Per-phase timings of the loop (disabled by default, see bengine::frame_profiler::enable())
+            bengine::frame_profiler profiler;
+            // \brief Spreads work inside of compute() across every core with parallel_for() and task graphs (no threads are started until it is first used); the time spent in its jobs is profiled as the jobs phase
+            bengine::job_system jobs;
+            // \brief Finish the profiler's frame, adding the time spent in jobs during it
+            void end_profiler_frame() {
+                this->profiler.add_to_phase(bengine::frame_profiler::phases::JOBS, this->jobs.take_busy_time());
+                this->jobs.set_timing(this->profiler.is_enabled());
+                this->profiler.end_frame();
+            }
+            // \brief Whether to draw the profiler's statistics over the top-left corner of the terminal each frame or not
+            bool show_profiler_hud = false;
 
             unsigned short minimum_cols = 1;
             unsigned short minimum_rows = 1;
@@ -42,6 +85,97 @@ namespace bengine {
         private:
             // whether the tests required for ncurses to run as intented are passed or not
             bool can_support_colors = true;
+            // the output that the loop was constructed with when running headlessly (nullptr when running on ncurses)
+            bengine::terminal_output *headless_output = nullptr;
+            // whether mouse events are being reported or not
+            bool mouse_enabled = false;
+
+            // the tick (ms) that input or a visual change last happened on
+            unsigned long long last_activity_ticks = 0;
+            // the amount of renders that have been skipped in a row by the frame-budget policy
+            unsigned char skipped_renders = 0;
+
+            // the kinds of input that can be held in a recording's payloads (the first byte of each payload)
+            enum class recorded_input_types : unsigned char {
+                KEY = 0,     // followed by the input character as a zigzag varint
+                MOUSE = 1    // a KEY_MOUSE input, followed by the mouse's x and y as zigzag varints and its buttons as a varint
+            };
+            // where inputs are recorded to while recording
+            bengine::input_recorder recorder;
+            // scratch space reused for each recorded payload
+            std::string recorded_payload;
+
+            // write the current input character to the recording, if there is one
+            void record_input() {
+                if (!this->recorder.is_open()) {
+                    return;
+                }
+                this->recorded_payload.clear();
+                if (this->input_character == KEY_MOUSE) {
+                    this->recorded_payload += static_cast<char>(bengine::curses_loop::recorded_input_types::MOUSE);
+                    bengine::input_encoding::write_varint(this->recorded_payload, bengine::input_encoding::zigzag_encode(this->mouse.x));
+                    bengine::input_encoding::write_varint(this->recorded_payload, bengine::input_encoding::zigzag_encode(this->mouse.y));
+                    bengine::input_encoding::write_varint(this->recorded_payload, this->mouse.buttons);
+                } else {
+                    this->recorded_payload += static_cast<char>(bengine::curses_loop::recorded_input_types::KEY);
+                    bengine::input_encoding::write_varint(this->recorded_payload, bengine::input_encoding::zigzag_encode(this->input_character));
+                }
+                this->recorder.record(this->tick, this->recorded_payload);
+            }
+            // set the current input from a recorded payload, returning whether the payload was understood or not
+            bool load_recorded_input(const char *payload, const std::size_t &size) {
+                std::size_t position = 1;
+                unsigned long long x = 0, y = 0, buttons = 0;
+                if (size < 1) {
+                    return false;
+                }
+                switch (static_cast<bengine::curses_loop::recorded_input_types>(payload[0])) {
+                    case bengine::curses_loop::recorded_input_types::KEY:
+                        if (!bengine::input_encoding::read_varint(payload, size, position, x)) {
+                            return false;
+                        }
+                        this->input_character = static_cast<int>(bengine::input_encoding::zigzag_decode(x));
+                        return true;
+                    case bengine::curses_loop::recorded_input_types::MOUSE:
+                        if (!bengine::input_encoding::read_varint(payload, size, position, x) || !bengine::input_encoding::read_varint(payload, size, position, y) || !bengine::input_encoding::read_varint(payload, size, position, buttons)) {
+                            return false;
+                        }
+                        this->input_character = KEY_MOUSE;
+                        this->mouse.x = static_cast<int>(bengine::input_encoding::zigzag_decode(x));
+                        this->mouse.y = static_cast<int>(bengine::input_encoding::zigzag_decode(y));
+                        this->mouse.buttons = buttons;
+                        return true;
+                }
+                return false;
+            }
+
+            // read the next input (along with its mouse event if it is KEY_MOUSE) and record it, returning whether there is an input to handle or not
+            bool poll_input(bengine::terminal_output &output) {
+                if ((this->input_character = output.read_input()) == ERR) {
+                    return false;
+                }
+                if (this->input_character == KEY_MOUSE && !output.read_mouse(this->mouse)) {
+                    return false;
+                }
+                this->record_input();
+                return true;
+            }
+
+            // the window that the profiler's statistics are written into when the hud is shown
+            bengine::curses_window profiler_hud = bengine::curses_window(0, 0, 42, bengine::frame_profiler::phase_count + 1);
+
+            // write the profiler's statistics into the hud window and put it on the screen
+            void render_profiler_hud() {
+                wchar_t line[64];
+                this->profiler_hud.write_string(0, 0, L"phase          p50    p95    p99    max", bengine::curses_window::make_write_args(bengine::curses_window::write_arg_options::ATTRIBUTES | bengine::curses_window::write_arg_options::WRAPPING_MODE, {bengine::curses_window::cell_attributes::REVERSED_COLOR, bengine::curses_window::wrapping_modes::NONE}));
+                for (unsigned char i = 0; i < bengine::frame_profiler::phase_count; i++) {
+                    const bengine::frame_profiler::phases phase = static_cast<bengine::frame_profiler::phases>(i);
+                    const bengine::frame_profiler::phase_statistics stats = this->profiler.get_statistics(phase);
+                    std::swprintf(line, 64, L"%-12s %6.2f %6.2f %6.2f %6.2f", bengine::frame_profiler::get_phase_name(phase), stats.p50, stats.p95, stats.p99, stats.max);
+                    this->profiler_hud.write_string(0, i + 1, line, bengine::curses_window::make_write_args(bengine::curses_window::write_arg_options::WRAPPING_MODE, {bengine::curses_window::wrapping_modes::NONE}));
+                }
+                this->profiler_hud.apply_to_screen();
+            }
 
         public:
             curses_loop() {
@@ -80,8 +214,74 @@ namespace bengine {
                     init_pair(pair, pair, 0);    // make 15 color pairs with each non-black color as foreground and black as background
                 }
             }
+            /** Headless constructor, nothing is initialized within ncurses and everything is drawn to/read from the given output instead (it is made the active output)
+             * \param output The output to run on, such as a bengine::virtual_terminal (must outlive the loop)
+             */
+            curses_loop(bengine::terminal_output &output) {
+                this->headless_output = &output;
+                bengine::terminal_output::set_active(this->headless_output);
+            }
             ~curses_loop() {
-                endwin();
+                this->stop_recording();
+                if (this->mouse_enabled) {
+                    this->disable_mouse();
+                }
+                if (this->headless_output == nullptr) {
+                    endwin();
+                } else if (&bengine::terminal_output::get_active() == this->headless_output) {
+                    bengine::terminal_output::set_active(nullptr);
+                }
+            }
+
+            /** Get whether the loop has gone long enough without input or visual changes to be considered idle
+             * \returns Whether the loop is idle or not
+             */
+            bool is_idle() const {
+                return this->get_ticks() - this->last_activity_ticks >= this->activity_timeout;
+            }
+            /** Get the refresh rate that the loop is currently running at based off of its pacing mode
+             * \returns The refresh rate that the loop is currently running at
+             */
+            unsigned short get_current_refresh_rate() const {
+                switch (this->pacing_mode) {
+                    default:
+                    case bengine::curses_loop::pacing_modes::FIXED:
+                        return this->refresh_rate;
+                    case bengine::curses_loop::pacing_modes::ADAPTIVE:
+                    case bengine::curses_loop::pacing_modes::EVENT_DRIVEN:
+                        return this->is_idle() ? this->minimum_refresh_rate : this->maximum_refresh_rate;
+                }
+            }
+
+            /** Start reporting mouse events; they are handed to handle_event() as KEY_MOUSE inputs with the event itself in `mouse`
+             * \param report_motion Whether to also report the mouse moving while no buttons are held (needed for hovering; turns on xterm's any-event tracking)
+             */
+            void enable_mouse(const bool &report_motion = true) {
+                bengine::terminal_output::get_active().enable_mouse(report_motion);
+                this->mouse_enabled = true;
+            }
+            // \brief Stop reporting mouse events
+            void disable_mouse() {
+                bengine::terminal_output::get_active().disable_mouse();
+                this->mouse_enabled = false;
+            }
+
+            /** Start recording every input along with the compute tick it was handled on; the recording is finished when run() returns (or by stop_recording())
+             * \param path The path of the file to record to
+             * \returns 0 on success or -1 if the file couldn't be opened
+             */
+            int start_recording(const std::string &path) {
+                return this->recorder.open(path);
+            }
+            // \brief Finish the current recording, if there is one
+            void stop_recording() {
+                this->recorder.close(this->tick);
+            }
+            /** Get whether inputs are being recorded or not
+             * \returns Whether inputs are being recorded or not
+             */
+            bool is_recording() const {
+                return this->recorder.is_open();
             }
 
             int run() {
@@ -97,6 +297,7 @@ namespace bengine {
                 }
 
                 this->epoch = std::chrono::high_resolution_clock::now();
+                bengine::terminal_output &output = bengine::terminal_output::get_active();
 
                 unsigned long long start_ticks = 0;
                 unsigned long long frame_ticks = 0;
@@ -104,31 +305,71 @@ namespace bengine {
                 long double new_time = 0.0;
                 double accumulator = 0.0;
 
+                this->last_activity_ticks = this->get_ticks();
+                unsigned short frame_rate = this->get_current_refresh_rate();
+                bool had_input = false;
+
                 while (this->loop_running) {
                     start_ticks = this->get_ticks();
                     new_time = this->get_ticks() * 0.01;
                     accumulator += new_time - current_time;
                     current_time = new_time;
+                    this->profiler.begin_frame();
+                    had_input = false;
 
                     while (accumulator >= this->delta_time) {
-                        if ((this->input_character = getch()) != ERR) {
+                        if (this->poll_input(output)) {
+                            had_input = true;
+                            this->profiler.begin_phase(bengine::frame_profiler::phases::HANDLE_EVENT);
                             this->handle_event();
+                            this->profiler.end_phase(bengine::frame_profiler::phases::HANDLE_EVENT);
                         }
+                        this->profiler.begin_phase(bengine::frame_profiler::phases::COMPUTE);
                         this->compute();
+                        this->profiler.end_phase(bengine::frame_profiler::phases::COMPUTE);
                         this->time += this->delta_time;
+                        this->tick++;
                         accumulator -= this->delta_time;
                     }
 
-                    if (this->visuals_changed) {
-                        this->visuals_changed = false;
-                        this->render();
+                    if (had_input || this->visuals_changed) {
+                        this->last_activity_ticks = this->get_ticks();
                     }
+                    frame_rate = this->get_current_refresh_rate();
+
+                    // frame-budget policy: leave visuals_changed set so that the skipped render happens on a later frame
+                    if (this->visuals_changed && this->skip_late_renders && this->skipped_renders < this->maximum_skipped_renders && this->get_ticks() - start_ticks >= (unsigned long long)(1000 / frame_rate)) {
+                        this->skipped_renders++;
+                    } else if (this->visuals_changed || this->show_profiler_hud) {
+                        if (this->visuals_changed) {
+                            this->skipped_renders = 0;
+                            this->visuals_changed = false;
+                            this->profiler.begin_phase(bengine::frame_profiler::phases::RENDER);
+                            this->render();
+                            this->profiler.end_phase(bengine::frame_profiler::phases::RENDER);
+                        }
+                        if (this->show_profiler_hud) {
+                            this->render_profiler_hud();
+                        }
+                        this->profiler.begin_phase(bengine::frame_profiler::phases::PRESENT);
+                        output.refresh();
+                        this->profiler.end_phase(bengine::frame_profiler::phases::PRESENT);
+                    }
+                    this->end_profiler_frame();
 
-                    if ((frame_ticks = this->get_ticks() - start_ticks) < (unsigned long long)(1000 / this->refresh_rate)) {
-                        napms(1000 / this->refresh_rate - frame_ticks);
+                    if (this->pacing_mode == bengine::curses_loop::pacing_modes::EVENT_DRIVEN && !this->visuals_changed && this->is_idle()) {
+                        // block until there is input, then hand it back to the next frame's handle_event()
+                        const int character = output.read_input(true);
+                        if (character != ERR) {
+                            output.push_input(character);
+                        }
+                        this->last_activity_ticks = this->get_ticks();
+                        current_time = this->get_ticks() * 0.01;
+                    } else if ((frame_ticks = this->get_ticks() - start_ticks) < (unsigned long long)(1000 / frame_rate)) {
+                        output.sleep(1000 / frame_rate - frame_ticks);
                     }
 
-                    if (COLS < this->minimum_cols || LINES < this->minimum_rows) {
+                    if (this->headless_output == nullptr && (COLS < this->minimum_cols || LINES < this->minimum_rows)) {
                         short r1, g1, b1, r2, g2, b2, r3, g3, b3, r4, g4, b4;
                         color_content( 0, &r1, &g1, &b1);
                         color_content( 1, &r2, &g2, &b2);
@@ -198,6 +439,107 @@ namespace bengine {
                         init_pair(10, fg3, bg3);
                     }
                 }
+
+                this->stop_recording();
+                if (!this->profiler.get_csv_path().empty()) {
+                    this->profiler.dump_csv();
+                }
+                return 0;
+            }
+
+            /** Run a set amount of frames as fast as possible without any timing or sleeping; each frame handles at most one input, computes once (advancing time by delta_time), and renders if the visuals changed
+             * \param frames The amount of frames to run
+             * \returns The amount of frames that were run (less than requested if loop_running was set to false)
+             */
+            unsigned long long run_frames(const unsigned long long &frames) {
+                bengine::terminal_output &output = bengine::terminal_output::get_active();
+
+                unsigned long long frame = 0;
+                for (; frame < frames && this->loop_running; frame++) {
+                    this->profiler.begin_frame();
+
+                    if (this->poll_input(output)) {
+                        this->profiler.begin_phase(bengine::frame_profiler::phases::HANDLE_EVENT);
+                        this->handle_event();
+                        this->profiler.end_phase(bengine::frame_profiler::phases::HANDLE_EVENT);
+                    }
+                    this->profiler.begin_phase(bengine::frame_profiler::phases::COMPUTE);
+                    this->compute();
+                    this->profiler.end_phase(bengine::frame_profiler::phases::COMPUTE);
+                    this->time += this->delta_time;
+                    this->tick++;
+
+                    if (this->visuals_changed || this->show_profiler_hud) {
+                        if (this->visuals_changed) {
+                            this->visuals_changed = false;
+                            this->profiler.begin_phase(bengine::frame_profiler::phases::RENDER);
+                            this->render();
+                            this->profiler.end_phase(bengine::frame_profiler::phases::RENDER);
+                        }
+                        if (this->show_profiler_hud) {
+                            this->render_profiler_hud();
+                        }
+                        this->profiler.begin_phase(bengine::frame_profiler::phases::PRESENT);
+                        output.refresh();
+                        this->profiler.end_phase(bengine::frame_profiler::phases::PRESENT);
+                    }
+                    this->end_profiler_frame();
+                }
+                return frame;
+            }
+
+            /** Play back a recording made with start_recording(), running compute as fast as possible with the recorded inputs handed to handle_event on the ticks they were originally handled on (time and tick start over from 0, and it runs even if the loop was stopped before)
+             * \param path The path of the recording
+             * \param render_interval How many compute ticks to go between renders (0 to never render)
+             * \returns 0 on success or -1 if the recording couldn't be read
+             */
+            int replay(const std::string &path, const unsigned long long &render_interval = 0) {
+                bengine::input_replayer replayer;
+                if (replayer.open(path) != 0) {
+                    std::cout << "Curses loop failed to replay \"" << path << "\" [bengine::curses_loop::replay]\n";
+                    return -1;
+                }
+                bengine::terminal_output &output = bengine::terminal_output::get_active();
+
+                this->loop_running = true;
+                this->time = 0.0;
+                this->tick = 0;
+                const char *payload = nullptr;
+                std::size_t size = 0;
+
+                while (this->loop_running && (this->tick < replayer.get_final_tick() || !replayer.is_finished())) {
+                    this->profiler.begin_frame();
+
+                    while (replayer.read(this->tick, payload, size)) {
+                        if (!this->load_recorded_input(payload, size)) {
+                            continue;
+                        }
+                        this->profiler.begin_phase(bengine::frame_profiler::phases::HANDLE_EVENT);
+                        this->handle_event();
+                        this->profiler.end_phase(bengine::frame_profiler::phases::HANDLE_EVENT);
+                    }
+                    this->profiler.begin_phase(bengine::frame_profiler::phases::COMPUTE);
+                    this->compute();
+                    this->profiler.end_phase(bengine::frame_profiler::phases::COMPUTE);
+                    this->time += this->delta_time;
+                    this->tick++;
+
+                    if (render_interval > 0 && this->tick % render_interval == 0 && (this->visuals_changed || this->show_profiler_hud)) {
+                        if (this->visuals_changed) {
+                            this->visuals_changed = false;
+                            this->profiler.begin_phase(bengine::frame_profiler::phases::RENDER);
+                            this->render();
+                            this->profiler.end_phase(bengine::frame_profiler::phases::RENDER);
+                        }
+                        if (this->show_profiler_hud) {
+                            this->render_profiler_hud();
+                        }
+                        this->profiler.begin_phase(bengine::frame_profiler::phases::PRESENT);
+                        output.refresh();
+                        this->profiler.end_phase(bengine::frame_profiler::phases::PRESENT);
+                    }
+                    this->end_profiler_frame();
+                }
                 return 0;
             }
     };
@@ -5,6 +5,8 @@
 #include <locale.h>
 
 #include "bengine_helpers.hpp"
+#include "bengine_particles.hpp"
+#include "bengine_terminal_output.hpp"
 
 namespace bengine {
     class curses_window {
@@ -148,96 +150,26 @@ namespace bengine {
             // \brief y-position (row) of the top-left corner of the window
             int y_pos = 0;
 
-            unsigned short width_2 = COLS / 2;
-            unsigned short height_2 = LINES / 2;
+            unsigned short width_2 = bengine::terminal_output::get_active().get_cols() / 2;
+            unsigned short height_2 = bengine::terminal_output::get_active().get_lines() / 2;
 
-            std::vector<std::vector<bengine::curses_window::cell>> grid = std::vector<std::vector<bengine::curses_window::cell>>(LINES, std::vector<bengine::curses_window::cell>(COLS));
+            std::vector<std::vector<bengine::curses_window::cell>> grid = std::vector<std::vector<bengine::curses_window::cell>>(bengine::terminal_output::get_active().get_lines(), std::vector<bengine::curses_window::cell>(bengine::terminal_output::get_active().get_cols()));
 
-            void apply_cell_to_screen(const unsigned short &x, const unsigned short &y) const {
-                attron(COLOR_PAIR(this->grid.at(y).at(x).color_pair));
-                this->toggle_attributes(this->grid.at(y).at(x).attributes, true);
+            // \brief Clickable regions of the window (positions are relative to the window)
+            bengine::uniform_grid_index click_regions;
+            // \brief The click region that the mouse was last over (-1 for none)
+            int hovered_click_region = -1;
 
-                if (this->grid.at(y).at(x).character == L'%') {
-                    mvaddch(this->y_pos + y, this->x_pos + x, '%');
-                } else {
-                    mvaddwstr(this->y_pos + y, this->x_pos + x, std::wstring(1, this->grid.at(y).at(x).character).c_str());
+            // make sure that the click region index covers the entire window
+            void fit_click_regions() {
+                if (this->click_regions.get_width() != this->get_width() || this->click_regions.get_height() != this->get_height()) {
+                    this->click_regions.resize(this->get_width(), this->get_height());
                 }
-
-                this->toggle_attributes(this->grid.at(y).at(x).attributes, false);
-                attroff(COLOR_PAIR(this->grid.at(y).at(x).color_pair));
             }
 
-            void toggle_attributes(const unsigned short &attributes, const bool &attribute_state) const {
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::BOLD))) {
-                    if (attribute_state) {
-                        attron(A_BOLD);
-                    } else {
-                        attroff(A_BOLD);
-                    }
-                }
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::ITALIC))) {
-                    if (attribute_state) {
-                        attron(A_ITALIC);
-                    } else {
-                        attroff(A_ITALIC);
-                    }
-                }
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::UNDERLINED))) {
-                    if (attribute_state) {
-                        attron(A_UNDERLINE);
-                    } else {
-                        attroff(A_UNDERLINE);
-                    }
-                }
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::REVERSED_COLOR))) {
-                    if (attribute_state) {
-                        attron(A_REVERSE);
-                    } else {
-                        attroff(A_REVERSE);
-                    }
-                }
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::BLINKING))) {
-                    if (attribute_state) {
-                        attron(A_BLINK);
-                    } else {
-                        attroff(A_BLINK);
-                    }
-                }
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::DIM))) {
-                    if (attribute_state) {
-                        attron(A_DIM);
-                    } else {
-                        attroff(A_DIM);
-                    }
-                }
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::INVISIBLE))) {
-                    if (attribute_state) {
-                        attron(A_INVIS);
-                    } else {
-                        attroff(A_INVIS);
-                    }
-                }
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::STANDOUT))) {
-                    if (attribute_state) {
-                        attron(A_STANDOUT);
-                    } else {
-                        attroff(A_STANDOUT);
-                    }
-                }
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::PROTECTED))) {
-                    if (attribute_state) {
-                        attron(A_PROTECT);
-                    } else {
-                        attroff(A_PROTECT);
-                    }
-                }
-                if (bengine::bitwise_manipulator::check_for_activated_bits(attributes, static_cast<unsigned short>(bengine::curses_window::cell_attributes::ALTERNATE_CHARACTER))) {
-                    if (attribute_state) {
-                        attron(A_ALTCHARSET);
-                    } else {
-                        attroff(A_ALTCHARSET);
-                    }
-                }
+            void apply_cell_to_screen(bengine::terminal_output &output, const unsigned short &x, const unsigned short &y) const {
+                const bengine::curses_window::cell &cell = this->grid[y][x];
+                output.put_cell(this->x_pos + x, this->y_pos + y, cell.character, cell.color_pair, cell.attributes);
             }
 
             bool check_coordinate_bounds(const int &x, const int &y) const {
@@ -260,8 +192,8 @@ namespace bengine {
             }
             // position is centered relative to the terminal
             curses_window(const unsigned short &width, const unsigned short &height) {
-                this->x_pos = COLS / 2 - width / 2;
-                this->y_pos = LINES / 2 - height / 2;
+                this->x_pos = bengine::terminal_output::get_active().get_cols() / 2 - width / 2;
+                this->y_pos = bengine::terminal_output::get_active().get_lines() / 2 - height / 2;
                 this->grid = std::vector<std::vector<bengine::curses_window::cell>>(height == 0 ? 1 : height, std::vector<bengine::curses_window::cell>(width == 0 ? 1 : width));
                 this->width_2 = this->get_width() / 2;
                 this->height_2 = this->get_height() / 2;
@@ -329,6 +261,7 @@ namespace bengine {
                     }
                 }
                 this->width_2 = this->get_width() / 2;
+                this->fit_click_regions();
             }
             void set_height(const unsigned short &height) {
                 const unsigned short processed_height = height == 0 ? 1 : height;
@@ -336,12 +269,88 @@ namespace bengine {
                     for (unsigned short row = this->get_height() - processed_height + 1; row > 1; row--) {
                         this->grid.pop_back();
                     }
+                    this->fit_click_regions();
                     return;
                 }
                 for (unsigned short row = processed_height - this->get_height() + 1; row > 1; row--) {
                     this->grid.emplace_back(std::vector<bengine::curses_window::cell>(this->get_width()));
                 }
                 this->height_2 = this->get_height() / 2;
+                this->fit_click_regions();
+            }
+
+            /** Add a clickable region to the window
+             * \param x x-position (col) of the region's top-left corner relative to the window
+             * \param y y-position (row) of the region's top-left corner relative to the window
+             * \param width Width of the region
+             * \param height Height of the region
+             * \returns The id of the region (ids of removed regions get reused); regions added later sit on top of earlier ones
+             */
+            int add_click_region(const int &x, const int &y, const unsigned short &width, const unsigned short &height) {
+                this->fit_click_regions();
+                return this->click_regions.insert(x, y, width, height);
+            }
+            /** Move/resize a clickable region of the window, putting it on top of every other region
+             * \param id The id of the region
+             * \param x The new x-position (col) of the region's top-left corner relative to the window
+             * \param y The new y-position (row) of the region's top-left corner relative to the window
+             * \param width The new width of the region
+             * \param height The new height of the region
+             * \returns 0 on success or -1 if there is no region with the given id
+             */
+            int move_click_region(const int &id, const int &x, const int &y, const unsigned short &width, const unsigned short &height) {
+                this->fit_click_regions();
+                return this->click_regions.move(id, x, y, width, height);
+            }
+            /** Remove a clickable region from the window
+             * \param id The id of the region
+             * \returns 0 on success or -1 if there is no region with the given id
+             */
+            int remove_click_region(const int &id) {
+                if (this->hovered_click_region == id) {
+                    this->hovered_click_region = -1;
+                }
+                return this->click_regions.remove(id);
+            }
+            // \brief Remove every clickable region from the window
+            void clear_click_regions() {
+                this->click_regions.clear();
+                this->hovered_click_region = -1;
+            }
+            /** Find the top-most clickable region at a position within the window
+             * \param x x-position (col) relative to the window
+             * \param y y-position (row) relative to the window
+             * \returns The id of the region, or -1 if there isn't one
+             */
+            int find_click_region(const int &x, const int &y) const {
+                return this->click_regions.query_point(x, y);
+            }
+            /** Find the top-most clickable region at a position on the screen (such as the position of a mouse event)
+             * \param x x-position (col) on the screen
+             * \param y y-position (row) on the screen
+             * \returns The id of the region, or -1 if there isn't one
+             */
+            int find_click_region_on_screen(const int &x, const int &y) const {
+                return this->click_regions.query_point(x - this->x_pos, y - this->y_pos);
+            }
+            /** Update which clickable region the mouse is over
+             * \param x x-position (col) of the mouse on the screen
+             * \param y y-position (row) of the mouse on the screen
+             * \returns Whether the hovered region changed or not
+             */
+            bool update_hovered_click_region(const int &x, const int &y) {
+                const int region = this->find_click_region_on_screen(x, y);
+                if (region == this->hovered_click_region) {
+                    return false;
+                }
+                this->hovered_click_region = region;
+                return true;
+            }
+            /** Get the clickable region that the mouse was last over
+             * \returns The id of the region, or -1 if the mouse wasn't over one
+             */
+            int get_hovered_click_region() const {
+                return this->hovered_click_region;
             }
 
             // get desired cell's character, if cell is out of bounds then return `bengine::curses_window::default_cell_character`
@@ -365,19 +374,21 @@ namespace bengine {
             }
 
             void apply_to_screen() const {
-                if (this->get_left_x() >= COLS || this->get_right_x() < 0 || this->get_bottom_y() < 0 || this->get_top_y() >= LINES) {
+                bengine::terminal_output &output = bengine::terminal_output::get_active();
+                if (this->get_left_x() >= output.get_cols() || this->get_right_x() < 0 || this->get_bottom_y() < 0 || this->get_top_y() >= output.get_lines()) {
                     return;
                 }
-                const unsigned short x_f = this->x_pos + this->get_width() > COLS ? COLS - this->x_pos : this->get_width();
-                const unsigned short y_f = this->y_pos + this->get_height() > LINES ? LINES - this->y_pos : this->get_height();
+                const unsigned short x_f = this->x_pos + this->get_width() > output.get_cols() ? output.get_cols() - this->x_pos : this->get_width();
+                const unsigned short y_f = this->y_pos + this->get_height() > output.get_lines() ? output.get_lines() - this->y_pos : this->get_height();
                 for (unsigned short row = this->y_pos < 0 ? -this->y_pos : 0; row < y_f; row++) {
                     for (unsigned short col = this->x_pos < 0 ? -this->x_pos : 0; col < x_f; col++) {
-                        this->apply_cell_to_screen(col, row);
+                        this->apply_cell_to_screen(output, col, row);
                     }
                 }
             }
             void apply_region_to_screen(int x, int y, int width, int height) const {
-                if (this->get_left_x() >= COLS || this->get_left_x() < 0 || this->get_top_y() < 0 || this->get_top_y() >= LINES) {
+                bengine::terminal_output &output = bengine::terminal_output::get_active();
+                if (this->get_left_x() >= output.get_cols() || this->get_left_x() < 0 || this->get_top_y() < 0 || this->get_top_y() >= output.get_lines()) {
                     return;
                 }
                 
@@ -411,29 +422,31 @@ namespace bengine {
                     height = this->get_height() - y;
                 }
 
-                const unsigned short x_f = this->x_pos + x + width > COLS ? COLS - this->x_pos - x : x + width;
-                const unsigned short y_f = this->y_pos + y + height > LINES ? LINES - this->y_pos - y : y + height;
+                const unsigned short x_f = this->x_pos + x + width > output.get_cols() ? output.get_cols() - this->x_pos - x : x + width;
+                const unsigned short y_f = this->y_pos + y + height > output.get_lines() ? output.get_lines() - this->y_pos - y : y + height;
                 for (unsigned short row = this->y_pos + y < 0 ? -this->y_pos : y; row < y_f; row++) {
                     for (unsigned short col = this->x_pos + x < 0 ? -this->x_pos : x; col < x_f; col++) {
-                        this->apply_cell_to_screen(col, row);
+                        this->apply_cell_to_screen(output, col, row);
                     }
                 }
             }
 
             void clear_from_screen() const {
-                if (this->get_left_x() >= COLS || this->get_right_x() < 0 || this->get_bottom_y() < 0 || this->get_top_y() >= LINES) {
+                bengine::terminal_output &output = bengine::terminal_output::get_active();
+                if (this->get_left_x() >= output.get_cols() || this->get_right_x() < 0 || this->get_bottom_y() < 0 || this->get_top_y() >= output.get_lines()) {
                     return;
                 }
-                const unsigned short x_f = this->x_pos + this->get_width() > COLS ? COLS - this->x_pos : this->get_width();
-                const unsigned short y_f = this->y_pos + this->get_height() > LINES ? LINES - this->y_pos : this->get_height();
+                const unsigned short x_f = this->x_pos + this->get_width() > output.get_cols() ? output.get_cols() - this->x_pos : this->get_width();
+                const unsigned short y_f = this->y_pos + this->get_height() > output.get_lines() ? output.get_lines() - this->y_pos : this->get_height();
                 for (unsigned short y = this->y_pos < 0 ? -this->y_pos : 0; y < y_f; y++) {
                     for (unsigned short x = this->x_pos < 0 ? -this->x_pos : 0; x < x_f; x++) {
-                        mvaddch(y, x, ' ');
+                        output.put_cell(this->x_pos + x, this->y_pos + y, L' ', 0, 0);
                     }
                 }
             }
             void clear_region_from_screen(int x, int y, int width, int height) const {
-                if (this->get_left_x() >= COLS || this->get_left_x() < 0 || this->get_top_y() < 0 || this->get_top_y() >= LINES) {
+                bengine::terminal_output &output = bengine::terminal_output::get_active();
+                if (this->get_left_x() >= output.get_cols() || this->get_left_x() < 0 || this->get_top_y() < 0 || this->get_top_y() >= output.get_lines()) {
                     return;
                 }
 
@@ -467,11 +480,11 @@ namespace bengine {
                     height = this->get_height() - y;
                 }
 
-                const unsigned short x_f = this->x_pos + x + width > COLS ? COLS - this->x_pos - x : x + width;
-                const unsigned short y_f = this->y_pos + y + height > LINES ? LINES - this->y_pos - y : y + height;
+                const unsigned short x_f = this->x_pos + x + width > output.get_cols() ? output.get_cols() - this->x_pos - x : x + width;
+                const unsigned short y_f = this->y_pos + y + height > output.get_lines() ? output.get_lines() - this->y_pos - y : y + height;
                 for (unsigned short row = this->y_pos + y < 0 ? -this->y_pos : y; row < y_f; row++) {
                     for (unsigned short col = this->x_pos + x < 0 ? -this->x_pos : x; col < x_f; col++) {
-                        mvaddch(row, col, ' ');
+                        output.put_cell(this->x_pos + col, this->y_pos + row, L' ', 0, 0);
                     }
                 }
             }
@@ -505,6 +518,34 @@ namespace bengine {
                 return this->write_character(pos.first, pos.second, character, args);
             }
 
+            /** Write a character onto the cell of every live particle of a bengine::particle_system that lands in the window
+             * \param particles The particles to write
+             * \param character The character to write for each particle
+             * \param args How to write the character (only the color pair and attributes are used)
+             * \param cell_width How many of the particles' units wide each cell is
+             * \param cell_height How many of the particles' units tall each cell is
+             * \returns The amount of particles that landed in the window
+             */
+            std::size_t write_particles(const bengine::particle_system &particles, const wchar_t &character, const bengine::curses_window::write_args &args = bengine::curses_window::default_write_args, const float &cell_width = 1, const float &cell_height = 1) {
+                const std::size_t count = particles.get_count();
+                const float *x_pos = particles.get_x_positions(), *y_pos = particles.get_y_positions();
+                const float width = this->get_width(), height = this->get_height();
+                std::size_t written = 0;
+                for (std::size_t i = 0; i < count; i++) {
+                    const float column = x_pos[i] / cell_width, row = y_pos[i] / cell_height;
+                    // checked as floats so that far away particles can't overflow when truncated
+                    if (!(column >= 0 && row >= 0 && column < width && row < height)) {
+                        continue;
+                    }
+                    bengine::curses_window::cell &cell = this->grid[static_cast<int>(row)][static_cast<int>(column)];
+                    cell.character = character;
+                    cell.color_pair = args.color_pair;
+                    cell.attributes = args.attributes;
+                    written++;
+                }
+                return written;
+            }
+
             // TODO: Fix it so that negative x and y dont fuck shit up
             std::pair<int, int> write_string(int x, int y, const std::wstring &string, const bengine::curses_window::write_args &args = bengine::curses_window::default_write_args) {
                 if (!this->check_coordinate_bounds(x, y)) {
@@ -0,0 +1,197 @@
+#ifndef BENGINE_DIRTY_REGIONS_hpp
+#define BENGINE_DIRTY_REGIONS_hpp
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+namespace bengine {
+    /** Keeps track of which parts of a surface need to be redrawn
+     * Overlapping or nearby regions get merged as they come in, and once there are too many (or they cover most of the surface) everything is considered dirty, since a few big redraws are cheaper than lots of small ones
+     */
+    class dirty_regions {
+        private:
+            std::vector<SDL_Rect> regions;
+            // \brief The area that regions get clipped to
+            SDL_Rect bounds = {0, 0, 0, 0};
+            // \brief Whether the entirety of the bounds is dirty
+            bool full = false;
+
+            // \brief The most regions to keep before merging the closest ones together
+            std::size_t max_regions = 8;
+            // \brief How much of the bounds (0-1) the regions can cover before everything is considered dirty
+            double full_threshold = 0.5;
+
+            static long long get_area(const SDL_Rect &rect) {
+                return static_cast<long long>(rect.w) * rect.h;
+            }
+            static SDL_Rect get_union(const SDL_Rect &a, const SDL_Rect &b) {
+                SDL_Rect output;
+                SDL_UnionRect(&a, &b, &output);
+                return output;
+            }
+            /** Get how much area merging two regions would redraw that neither needed to
+             * \param a One of the regions
+             * \param b The other region
+             * \returns How much area would be wasted by merging the regions (can be negative if they overlap)
+             */
+            static long long get_waste(const SDL_Rect &a, const SDL_Rect &b) {
+                return bengine::dirty_regions::get_area(bengine::dirty_regions::get_union(a, b)) - bengine::dirty_regions::get_area(a) - bengine::dirty_regions::get_area(b);
+            }
+
+            // \brief Merge regions until none of them are worth keeping separate and there are at most max_regions of them, then check whether everything should just be redrawn
+            void consolidate() {
+                while (true) {
+                    bool merged = true;
+                    while (merged) {
+                        merged = false;
+                        for (std::size_t i = 0; i < this->regions.size() && !merged; i++) {
+                            for (std::size_t j = i + 1; j < this->regions.size(); j++) {
+                                // overlapping regions (or ones close enough that merging them costs nothing extra) get redrawn together
+                                if (bengine::dirty_regions::get_waste(this->regions[i], this->regions[j]) <= 0 || SDL_HasIntersection(&this->regions[i], &this->regions[j])) {
+                                    this->regions[i] = bengine::dirty_regions::get_union(this->regions[i], this->regions[j]);
+                                    this->regions.erase(this->regions.begin() + j);
+                                    merged = true;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                    if (this->regions.size() <= this->max_regions) {
+                        break;
+                    }
+
+                    // too many regions, so the pair that wastes the least area gets merged (which can create new overlaps)
+                    std::size_t best_i = 0, best_j = 1;
+                    long long best_waste = bengine::dirty_regions::get_waste(this->regions[0], this->regions[1]);
+                    for (std::size_t i = 0; i < this->regions.size(); i++) {
+                        for (std::size_t j = i + 1; j < this->regions.size(); j++) {
+                            const long long waste = bengine::dirty_regions::get_waste(this->regions[i], this->regions[j]);
+                            if (waste < best_waste) {
+                                best_waste = waste;
+                                best_i = i;
+                                best_j = j;
+                            }
+                        }
+                    }
+                    this->regions[best_i] = bengine::dirty_regions::get_union(this->regions[best_i], this->regions[best_j]);
+                    this->regions.erase(this->regions.begin() + best_j);
+                }
+
+                long long total = 0;
+                for (std::size_t i = 0; i < this->regions.size(); i++) {
+                    total += bengine::dirty_regions::get_area(this->regions[i]);
+                }
+                if (total > bengine::dirty_regions::get_area(this->bounds) * this->full_threshold) {
+                    this->invalidate_all();
+                }
+            }
+
+        public:
+            /** bengine::dirty_regions constructor
+             * \param width The width of the area being tracked
+             * \param height The height of the area being tracked
+             */
+            dirty_regions(const int &width = 0, const int &height = 0) {
+                this->set_bounds(width, height);
+            }
+            // \brief bengine::dirty_regions deconstructor
+            ~dirty_regions() {}
+
+            /** Change the size of the area being tracked (everything becomes dirty if it actually changes)
+             * \param width The width of the area being tracked
+             * \param height The height of the area being tracked
+             */
+            void set_bounds(const int &width, const int &height) {
+                if (width == this->bounds.w && height == this->bounds.h) {
+                    return;
+                }
+                this->bounds = {0, 0, width, height};
+                this->invalidate_all();
+            }
+            /** Get the area being tracked
+             * \returns The area being tracked
+             */
+            SDL_Rect get_bounds() const {
+                return this->bounds;
+            }
+
+            /** Set the most regions to keep before merging the closest ones together
+             * \param max_regions The most regions to keep (at least 1)
+             */
+            void set_max_regions(const std::size_t &max_regions) {
+                this->max_regions = max_regions > 0 ? max_regions : 1;
+            }
+            /** Set how much of the area the regions can cover before everything is considered dirty
+             * \param threshold The fraction of the area (0-1)
+             */
+            void set_full_threshold(const double &threshold) {
+                this->full_threshold = threshold;
+            }
+
+            /** Mark a region as needing to be redrawn
+             * \param x x-position of the region (px) (assuming positive width and height)
+             * \param y y-position of the region (px) (assuming positive width and height)
+             * \param w Width of the region (px) (can be negative)
+             * \param h Height of the region (px) (can be negative)
+             */
+            void invalidate(const int &x, const int &y, const int &w, const int &h) {
+                if (this->full || w == 0 || h == 0) {
+                    return;
+                }
+                const SDL_Rect region = {w < 0 ? x + w : x, h < 0 ? y + h : y, w < 0 ? -w : w, h < 0 ? -h : h};
+                SDL_Rect clipped;
+                if (!SDL_IntersectRect(&region, &this->bounds, &clipped)) {
+                    return;
+                }
+                this->regions.push_back(clipped);
+                this->consolidate();
+            }
+            // \brief Mark everything as needing to be redrawn
+            void invalidate_all() {
+                this->full = true;
+                this->regions.assign(1, this->bounds);
+            }
+            // \brief Forget every region (once they have been redrawn)
+            void clear() {
+                this->full = false;
+                this->regions.clear();
+            }
+
+            /** Get whether anything needs to be redrawn or not
+             * \returns Whether nothing needs to be redrawn
+             */
+            bool is_empty() const {
+                return this->regions.empty();
+            }
+            /** Get whether everything needs to be redrawn or not
+             * \returns Whether everything needs to be redrawn or not
+             */
+            bool is_full() const {
+                return this->full;
+            }
+            /** Get the regions that need to be redrawn (they never overlap each other)
+             * \returns The regions that need to be redrawn
+             */
+            const std::vector<SDL_Rect>& get_regions() const {
+                return this->regions;
+            }
+            /** Get whether any part of a rectangle needs to be redrawn (for skipping things that haven't changed)
+             * \param x x-position of the rectangle (px)
+             * \param y y-position of the rectangle (px)
+             * \param w Width of the rectangle (px)
+             * \param h Height of the rectangle (px)
+             * \returns Whether any part of the rectangle needs to be redrawn
+             */
+            bool intersects(const int &x, const int &y, const int &w, const int &h) const {
+                const SDL_Rect rect = {w < 0 ? x + w : x, h < 0 ? y + h : y, w < 0 ? -w : w, h < 0 ? -h : h};
+                for (std::size_t i = 0; i < this->regions.size(); i++) {
+                    if (SDL_HasIntersection(&rect, &this->regions[i])) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+    };
+}
+
+#endif // BENGINE_DIRTY_REGIONS_hpp
@@ -0,0 +1,294 @@
+#ifndef BENGINE_DRAW_COMMAND_BUFFER_hpp
+#define BENGINE_DRAW_COMMAND_BUFFER_hpp
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace bengine {
+    /** Records draw calls as quads so that they can be sorted by renderer state and submitted in as few SDL_RenderGeometry calls as possible (used by bengine::render_window's deferred rendering)
+     * Commands are sorted stably by (layer, texture, blend mode, color), so within a layer, draws that use different states can end up reordered; use layers to keep overlapping draws in order
+     */
+    class draw_command_buffer {
+        public:
+            // \brief Counts of what happened during a frame (everything recorded and submitted between two calls to bengine::draw_command_buffer::end_frame(), however many flushes that took)
+            struct statistics {
+                // \brief The amount of draw calls that were recorded (what would have been submitted without batching)
+                unsigned long recorded_calls = 0;
+                // \brief The amount of calls that were actually submitted to the renderer after batching
+                unsigned long submitted_calls = 0;
+                // \brief The amount of quads that were submitted
+                unsigned long quads = 0;
+            };
+
+        private:
+            // \brief A single recorded draw call, made up of one or more quads that share the same state
+            struct command {
+                unsigned char layer = 0;
+                SDL_Texture *texture = NULL;
+                SDL_BlendMode blend_mode = SDL_BLENDMODE_NONE;
+                // \brief The color that was drawn with packed as 0xRRGGBBAA (only used for sorting; colors are kept per-vertex)
+                Uint32 color = 0;
+                // \brief The index of the first vertex of the command's quads
+                unsigned int first_vertex = 0;
+                unsigned int quad_count = 0;
+            };
+
+            std::vector<bengine::draw_command_buffer::command> commands;
+            // \brief The vertices of every recorded quad, four per quad (top-left, top-right, bottom-right, bottom-left)
+            std::vector<SDL_Vertex> vertices;
+            // \brief Scratch space for the order that commands get submitted in
+            std::vector<unsigned int> order;
+            // \brief Scratch space for the vertices of each submitted batch (so that the renderer only processes the batch's own vertices instead of every recorded vertex)
+            std::vector<SDL_Vertex> batch_vertices;
+            // \brief Scratch space for the indices of each submitted batch (relative to batch_vertices)
+            std::vector<int> indices;
+
+            bengine::draw_command_buffer::statistics current_statistics;
+            bengine::draw_command_buffer::statistics last_statistics;
+
+            static Uint32 pack_color(const SDL_Color &color) {
+                return static_cast<Uint32>(color.r) << 24 | static_cast<Uint32>(color.g) << 16 | static_cast<Uint32>(color.b) << 8 | color.a;
+            }
+            // start a new command (or extend the previous one if it has the exact same state and was recorded immediately before)
+            bengine::draw_command_buffer::command& begin_command(const unsigned char &layer, SDL_Texture *texture, const SDL_BlendMode &blend_mode, const SDL_Color &color) {
+                this->current_statistics.recorded_calls++;
+                bengine::draw_command_buffer::command command;
+                command.layer = layer;
+                command.texture = texture;
+                command.blend_mode = blend_mode;
+                command.color = bengine::draw_command_buffer::pack_color(color);
+                command.first_vertex = this->vertices.size();
+                this->commands.emplace_back(command);
+                return this->commands.back();
+            }
+            void append_vertex(const float &x, const float &y, const SDL_Color &color, const float &u = 0, const float &v = 0) {
+                SDL_Vertex vertex;
+                vertex.position = {x, y};
+                vertex.color = color;
+                vertex.tex_coord = {u, v};
+                this->vertices.emplace_back(vertex);
+            }
+
+        public:
+            // \brief bengine::draw_command_buffer constructor
+            draw_command_buffer() {}
+            // \brief bengine::draw_command_buffer deconstructor
+            ~draw_command_buffer() {}
+
+            /** Get whether anything is waiting to be submitted or not
+             * \returns Whether anything is waiting to be submitted or not
+             */
+            bool is_empty() const {
+                return this->commands.empty();
+            }
+            /** Get the counts of the frame being recorded
+             * \returns The counts of everything recorded and submitted since the frame began
+             */
+            bengine::draw_command_buffer::statistics get_current_statistics() const {
+                return this->current_statistics;
+            }
+            /** Get the counts of the last finished frame
+             * \returns The counts of everything that was recorded and submitted during the last finished frame
+             */
+            bengine::draw_command_buffer::statistics get_last_statistics() const {
+                return this->last_statistics;
+            }
+
+            /** Record filled rectangles that share the same state as a single draw call
+             * \param layer The layer to draw on (lower layers are drawn first)
+             * \param blend_mode The blend mode to draw with
+             * \param rects The rectangles to fill (px)
+             * \param count The amount of rectangles
+             * \param color The color to fill the rectangles with
+             */
+            void add_rects(const unsigned char &layer, const SDL_BlendMode &blend_mode, const SDL_FRect *rects, const std::size_t &count, const SDL_Color &color) {
+                if (count == 0) {
+                    return;
+                }
+                bengine::draw_command_buffer::command &command = this->begin_command(layer, NULL, blend_mode, color);
+                for (std::size_t i = 0; i < count; i++) {
+                    this->append_vertex(rects[i].x, rects[i].y, color);
+                    this->append_vertex(rects[i].x + rects[i].w, rects[i].y, color);
+                    this->append_vertex(rects[i].x + rects[i].w, rects[i].y + rects[i].h, color);
+                    this->append_vertex(rects[i].x, rects[i].y + rects[i].h, color);
+                }
+                command.quad_count = count;
+            }
+            /** Record a filled rectangle
+             * \param layer The layer to draw on (lower layers are drawn first)
+             * \param blend_mode The blend mode to draw with
+             * \param rect The rectangle to fill (px)
+             * \param color The color to fill the rectangle with
+             */
+            void add_rect(const unsigned char &layer, const SDL_BlendMode &blend_mode, const SDL_FRect &rect, const SDL_Color &color) {
+                this->add_rects(layer, blend_mode, &rect, 1, color);
+            }
+            /** Record a line as a quad that is one pixel thick
+             * \param layer The layer to draw on (lower layers are drawn first)
+             * \param blend_mode The blend mode to draw with
+             * \param x1 x-position of the starting point (px)
+             * \param y1 y-position of the starting point (px)
+             * \param x2 x-position of the ending point (px)
+             * \param y2 y-position of the ending point (px)
+             * \param color The color to draw the line with
+             */
+            void add_line(const unsigned char &layer, const SDL_BlendMode &blend_mode, const float &x1, const float &y1, const float &x2, const float &y2, const SDL_Color &color) {
+                // lines run through the centers of the pixels at each end
+                const float dx = x2 - x1, dy = y2 - y1;
+                const float length = std::sqrt(dx * dx + dy * dy);
+                if (length == 0) {
+                    this->add_rect(layer, blend_mode, {x1, y1, 1, 1}, color);
+                    return;
+                }
+                const float nx = -dy / length * 0.5f, ny = dx / length * 0.5f;
+                const float sx = x1 + 0.5f - dx / length * 0.5f, sy = y1 + 0.5f - dy / length * 0.5f;
+                const float ex = x2 + 0.5f + dx / length * 0.5f, ey = y2 + 0.5f + dy / length * 0.5f;
+
+                bengine::draw_command_buffer::command &command = this->begin_command(layer, NULL, blend_mode, color);
+                this->append_vertex(sx + nx, sy + ny, color);
+                this->append_vertex(ex + nx, ey + ny, color);
+                this->append_vertex(ex - nx, ey - ny, color);
+                this->append_vertex(sx - nx, sy - ny, color);
+                command.quad_count = 1;
+            }
+            /** Record a (portion of a) texture being copied onto a rectangle
+             * \param layer The layer to draw on (lower layers are drawn first)
+             * \param texture The texture to copy from
+             * \param src The portion of the texture to copy (px), or NULL for the entire texture
+             * \param dst Where to copy the texture to (px)
+             * \param angle How far to rotate the destination clockwise (degrees)
+             * \param center The point to rotate around relative to the top-left corner of the destination (px), or NULL for the center of the destination
+             * \param flip How to flip the texture (SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL can be OR'd together)
+             * \returns 0 on success or -1 if the texture couldn't be queried
+             */
+            int add_texture(const unsigned char &layer, SDL_Texture *texture, const SDL_Rect *src, const SDL_FRect &dst, const double &angle = 0, const SDL_FPoint *center = NULL, const SDL_RendererFlip &flip = SDL_FLIP_NONE) {
+                int width, height;
+                SDL_BlendMode blend_mode;
+                SDL_Color color;
+                if (SDL_QueryTexture(texture, NULL, NULL, &width, &height) != 0 || width == 0 || height == 0) {
+                    return -1;
+                }
+                SDL_GetTextureBlendMode(texture, &blend_mode);
+                SDL_GetTextureColorMod(texture, &color.r, &color.g, &color.b);
+                SDL_GetTextureAlphaMod(texture, &color.a);
+
+                const SDL_Rect source = src == NULL ? SDL_Rect{0, 0, width, height} : *src;
+                float u1 = static_cast<float>(source.x) / width, u2 = static_cast<float>(source.x + source.w) / width;
+                float v1 = static_cast<float>(source.y) / height, v2 = static_cast<float>(source.y + source.h) / height;
+                if ((flip & SDL_FLIP_HORIZONTAL) == SDL_FLIP_HORIZONTAL) {
+                    std::swap(u1, u2);
+                }
+                if ((flip & SDL_FLIP_VERTICAL) == SDL_FLIP_VERTICAL) {
+                    std::swap(v1, v2);
+                }
+
+                float corners[4][2] = {{dst.x, dst.y}, {dst.x + dst.w, dst.y}, {dst.x + dst.w, dst.y + dst.h}, {dst.x, dst.y + dst.h}};
+                if (angle != 0) {
+                    const float pivot_x = dst.x + (center == NULL ? dst.w / 2 : center->x), pivot_y = dst.y + (center == NULL ? dst.h / 2 : center->y);
+                    const float cosine = std::cos(angle * M_PI / 180), sine = std::sin(angle * M_PI / 180);
+                    for (unsigned char i = 0; i < 4; i++) {
+                        const float x = corners[i][0] - pivot_x, y = corners[i][1] - pivot_y;
+                        corners[i][0] = pivot_x + x * cosine - y * sine;
+                        corners[i][1] = pivot_y + x * sine + y * cosine;
+                    }
+                }
+
+                bengine::draw_command_buffer::command &command = this->begin_command(layer, texture, blend_mode, color);
+                this->append_vertex(corners[0][0], corners[0][1], color, u1, v1);
+                this->append_vertex(corners[1][0], corners[1][1], color, u2, v1);
+                this->append_vertex(corners[2][0], corners[2][1], color, u2, v2);
+                this->append_vertex(corners[3][0], corners[3][1], color, u1, v2);
+                command.quad_count = 1;
+                return 0;
+            }
+
+            /** Record quads that have already been made into vertices (such as glyphs from a bengine::text_cache) as a single draw call
+             * \param layer The layer to draw on (lower layers are drawn first)
+             * \param texture The texture that the quads sample from (NULL for solid quads)
+             * \param blend_mode The blend mode to draw with
+             * \param vertices The vertices of the quads, four per quad (top-left, top-right, bottom-right, bottom-left)
+             * \param quad_count The amount of quads
+             */
+            void add_quads(const unsigned char &layer, SDL_Texture *texture, const SDL_BlendMode &blend_mode, const SDL_Vertex *vertices, const std::size_t &quad_count) {
+                if (quad_count == 0) {
+                    return;
+                }
+                bengine::draw_command_buffer::command &command = this->begin_command(layer, texture, blend_mode, vertices[0].color);
+                this->vertices.insert(this->vertices.end(), vertices, vertices + quad_count * 4);
+                command.quad_count = quad_count;
+            }
+
+            // \brief Throw away everything that has been recorded without submitting it
+            void discard() {
+                this->commands.clear();
+                this->vertices.clear();
+            }
+            /** Sort everything that has been recorded and submit it in as few calls as possible; commands that share a layer, texture, and blend mode are merged into a single SDL_RenderGeometry call
+             * \param renderer The renderer to submit to
+             * \returns 0 on success or -1 if a submission failed
+             */
+            int flush(SDL_Renderer *renderer) {
+                int output = 0;
+                this->order.resize(this->commands.size());
+                for (unsigned int i = 0; i < this->order.size(); i++) {
+                    this->order[i] = i;
+                }
+                std::stable_sort(this->order.begin(), this->order.end(), [this](const unsigned int &lhs, const unsigned int &rhs) {
+                    const bengine::draw_command_buffer::command &a = this->commands[lhs], &b = this->commands[rhs];
+                    if (a.layer != b.layer) {
+                        return a.layer < b.layer;
+                    }
+                    if (a.texture != b.texture) {
+                        return a.texture < b.texture;
+                    }
+                    if (a.blend_mode != b.blend_mode) {
+                        return a.blend_mode < b.blend_mode;
+                    }
+                    return a.color < b.color;
+                });
+
+                for (std::size_t i = 0; i < this->order.size();) {
+                    const bengine::draw_command_buffer::command &first = this->commands[this->order[i]];
+                    this->batch_vertices.clear();
+                    this->indices.clear();
+                    for (; i < this->order.size(); i++) {
+                        const bengine::draw_command_buffer::command &command = this->commands[this->order[i]];
+                        if (command.layer != first.layer || command.texture != first.texture || command.blend_mode != first.blend_mode) {
+                            break;
+                        }
+                        for (unsigned int quad = 0; quad < command.quad_count; quad++) {
+                            const int vertex = this->batch_vertices.size() + quad * 4;
+                            this->indices.insert(this->indices.end(), {vertex, vertex + 1, vertex + 2, vertex, vertex + 2, vertex + 3});
+                        }
+                        this->batch_vertices.insert(this->batch_vertices.end(), this->vertices.begin() + command.first_vertex, this->vertices.begin() + command.first_vertex + command.quad_count * 4);
+                        this->current_statistics.quads += command.quad_count;
+                    }
+
+                    // the blend mode that was recorded is used rather than whatever the texture has been set to since
+                    if (first.texture == NULL) {
+                        SDL_SetRenderDrawBlendMode(renderer, first.blend_mode);
+                    } else {
+                        SDL_SetTextureBlendMode(first.texture, first.blend_mode);
+                    }
+                    if (SDL_RenderGeometry(renderer, first.texture, this->batch_vertices.data(), this->batch_vertices.size(), this->indices.data(), this->indices.size()) != 0) {
+                        std::cout << "Draw command buffer failed to submit a batch [bengine::draw_command_buffer::flush]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                        output = -1;
+                    }
+                    this->current_statistics.submitted_calls++;
+                }
+
+                this->discard();
+                return output;
+            }
+            // \brief Finish the frame, moving its counts into the last frame's (a frame can be flushed more than once, like when switching render targets partway through)
+            void end_frame() {
+                this->last_statistics = this->current_statistics;
+                this->current_statistics = bengine::draw_command_buffer::statistics();
+            }
+    };
+}
+
+#endif // BENGINE_DRAW_COMMAND_BUFFER_hpp
@@ -0,0 +1,320 @@
+#ifndef BENGINE_EVENT_DISPATCHER_hpp
+#define BENGINE_EVENT_DISPATCHER_hpp
+
+#include <SDL2/SDL.h>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bengine {
+    /** Sends SDL events to handlers registered for their type
+     * Events are drained from SDL in bulk into one contiguous buffer and then dispatched in runs of the same type, so a flood of mouse motion only looks up its handlers once per run (and can optionally be merged into a single event)
+     */
+    class event_dispatcher {
+        public:
+            // \brief A function that handles an event
+            typedef std::function<void(const SDL_Event&)> handler;
+
+        private:
+            // \brief A registered handler and the ID used to remove it
+            struct entry {
+                unsigned long id;
+                bengine::event_dispatcher::handler function;
+                // \brief Set when the handler gets removed during dispatching (it is skipped until it can be erased)
+                bool removed;
+            };
+
+            // \brief The handlers for each event type
+            std::unordered_map<Uint32, std::vector<bengine::event_dispatcher::entry>> handlers;
+            // \brief Called for events with no handlers of their own
+            bengine::event_dispatcher::handler fallback;
+            unsigned long next_id = 1;
+
+            // \brief Whether events are being dispatched (handlers registered by other handlers wait until dispatching is done, and removed ones are skipped until they can be erased)
+            bool dispatching = false;
+            std::vector<std::pair<Uint32, bengine::event_dispatcher::entry>> pending_additions;
+            std::vector<unsigned long> pending_removals;
+            bool pending_clear = false;
+
+            // \brief The events drained this frame (reused between frames)
+            std::vector<SDL_Event> buffer;
+            // \brief How many events are pulled out of SDL's queue per call
+            static const int chunk_size = 64;
+
+            // \brief Whether consecutive mouse motion events get merged into one
+            bool coalesce_motion = false;
+
+            /** Register a handler for an event type
+             * \param type The type of event
+             * \param function The handler
+             * \returns The handler's ID (for bengine::event_dispatcher::remove())
+             */
+            unsigned long add(const Uint32 &type, const bengine::event_dispatcher::handler &function) {
+                return this->add(type, function, this->next_id++);
+            }
+            /** Register a handler for an event type under an existing ID
+             * \param type The type of event
+             * \param function The handler
+             * \param id The handler's ID
+             * \returns The handler's ID
+             */
+            unsigned long add(const Uint32 &type, const bengine::event_dispatcher::handler &function, const unsigned long &id) {
+                if (this->dispatching) {
+                    this->pending_additions.push_back({type, {id, function, false}});
+                } else {
+                    this->handlers[type].push_back({id, function, false});
+                }
+                return id;
+            }
+
+        public:
+            // \brief bengine::event_dispatcher constructor
+            event_dispatcher() {}
+            // \brief bengine::event_dispatcher deconstructor
+            ~event_dispatcher() {}
+
+            /** Register a handler for any event type
+             * \param type The type of event (like SDL_QUIT or SDL_DROPFILE)
+             * \param function The handler
+             * \returns The handler's ID (for bengine::event_dispatcher::remove())
+             */
+            unsigned long on(const Uint32 &type, const bengine::event_dispatcher::handler &function) {
+                return this->add(type, function);
+            }
+            /** Register a handler for key presses and releases (SDL_KEYDOWN and SDL_KEYUP)
+             * \param function The handler
+             * \returns The handler's ID (shared by both types)
+             */
+            unsigned long on_key(const std::function<void(const SDL_KeyboardEvent&)> &function) {
+                const bengine::event_dispatcher::handler wrapped = [function](const SDL_Event &event) {function(event.key);};
+                return this->add(SDL_KEYUP, wrapped, this->add(SDL_KEYDOWN, wrapped));
+            }
+            /** Register a handler for mouse motion (SDL_MOUSEMOTION)
+             * \param function The handler
+             * \returns The handler's ID
+             */
+            unsigned long on_mouse_motion(const std::function<void(const SDL_MouseMotionEvent&)> &function) {
+                return this->add(SDL_MOUSEMOTION, [function](const SDL_Event &event) {function(event.motion);});
+            }
+            /** Register a handler for mouse button presses and releases (SDL_MOUSEBUTTONDOWN and SDL_MOUSEBUTTONUP)
+             * \param function The handler
+             * \returns The handler's ID (shared by both types)
+             */
+            unsigned long on_mouse_button(const std::function<void(const SDL_MouseButtonEvent&)> &function) {
+                const bengine::event_dispatcher::handler wrapped = [function](const SDL_Event &event) {function(event.button);};
+                return this->add(SDL_MOUSEBUTTONUP, wrapped, this->add(SDL_MOUSEBUTTONDOWN, wrapped));
+            }
+            /** Register a handler for the mouse wheel (SDL_MOUSEWHEEL)
+             * \param function The handler
+             * \returns The handler's ID
+             */
+            unsigned long on_mouse_wheel(const std::function<void(const SDL_MouseWheelEvent&)> &function) {
+                return this->add(SDL_MOUSEWHEEL, [function](const SDL_Event &event) {function(event.wheel);});
+            }
+            /** Register a handler for window events (SDL_WINDOWEVENT)
+             * \param function The handler
+             * \returns The handler's ID
+             */
+            unsigned long on_window(const std::function<void(const SDL_WindowEvent&)> &function) {
+                return this->add(SDL_WINDOWEVENT, [function](const SDL_Event &event) {function(event.window);});
+            }
+            /** Register a handler for text input (SDL_TEXTINPUT, only sent between SDL_StartTextInput() and SDL_StopTextInput())
+             * \param function The handler
+             * \returns The handler's ID
+             */
+            unsigned long on_text_input(const std::function<void(const SDL_TextInputEvent&)> &function) {
+                return this->add(SDL_TEXTINPUT, [function](const SDL_Event &event) {function(event.text);});
+            }
+            /** Register a handler for a user event type
+             * \param type The type of event (from bengine::event_dispatcher::register_user_event() or SDL_USEREVENT)
+             * \param function The handler
+             * \returns The handler's ID
+             */
+            unsigned long on_user(const Uint32 &type, const std::function<void(const SDL_UserEvent&)> &function) {
+                return this->add(type, [function](const SDL_Event &event) {function(event.user);});
+            }
+            /** Set the handler for events that don't have any handlers of their own
+             * \param function The handler (an empty function to ignore those events)
+             */
+            void set_fallback(const bengine::event_dispatcher::handler &function) {
+                this->fallback = function;
+            }
+            /** Remove a handler
+             * \param id The ID returned when the handler was registered
+             */
+            void remove(const unsigned long &id) {
+                if (this->dispatching) {
+                    for (std::unordered_map<Uint32, std::vector<bengine::event_dispatcher::entry>>::iterator it = this->handlers.begin(); it != this->handlers.end(); it++) {
+                        for (std::size_t i = 0; i < it->second.size(); i++) {
+                            it->second[i].removed = it->second[i].removed || it->second[i].id == id;
+                        }
+                    }
+                    this->pending_removals.push_back(id);
+                    return;
+                }
+                for (std::unordered_map<Uint32, std::vector<bengine::event_dispatcher::entry>>::iterator it = this->handlers.begin(); it != this->handlers.end(); it++) {
+                    for (std::size_t i = 0; i < it->second.size();) {
+                        if (it->second[i].id == id) {
+                            it->second.erase(it->second.begin() + i);
+                        } else {
+                            i++;
+                        }
+                    }
+                }
+            }
+            // \brief Remove every handler (and the fallback)
+            void clear() {
+                if (this->dispatching) {
+                    for (std::unordered_map<Uint32, std::vector<bengine::event_dispatcher::entry>>::iterator it = this->handlers.begin(); it != this->handlers.end(); it++) {
+                        for (std::size_t i = 0; i < it->second.size(); i++) {
+                            it->second[i].removed = true;
+                        }
+                    }
+                    this->pending_clear = true;
+                    this->pending_additions.clear();
+                    return;
+                }
+                this->handlers.clear();
+                this->fallback = bengine::event_dispatcher::handler();
+            }
+
+            /** Get a new event type for user events
+             * \returns The new event type, or (Uint32)-1 if SDL has run out of them
+             */
+            static Uint32 register_user_event() {
+                return SDL_RegisterEvents(1);
+            }
+            /** Add a user event to SDL's queue (safe to call from other threads)
+             * \param type The type of event (from bengine::event_dispatcher::register_user_event())
+             * \param code A number to send with the event
+             * \param data1 A pointer to send with the event
+             * \param data2 Another pointer to send with the event
+             * \returns 1 on success, 0 if the event was filtered, or a negative error code on failure
+             */
+            static int push_user_event(const Uint32 &type, const Sint32 &code = 0, void *data1 = NULL, void *data2 = NULL) {
+                SDL_Event event;
+                SDL_zero(event);
+                event.type = type;
+                event.user.code = code;
+                event.user.data1 = data1;
+                event.user.data2 = data2;
+                return SDL_PushEvent(&event);
+            }
+
+            /** Get whether consecutive mouse motion events get merged into one or not
+             * \returns Whether consecutive mouse motion events get merged into one or not
+             */
+            bool is_coalescing_motion() const {
+                return this->coalesce_motion;
+            }
+            /** Set whether consecutive mouse motion events (from the same mouse and window) get merged into one; the merged event has the last position and the total relative motion
+             * \param coalesce Whether to merge consecutive mouse motion events or not
+             */
+            void set_coalescing_motion(const bool &coalesce) {
+                this->coalesce_motion = coalesce;
+            }
+
+            /** Pull every waiting event out of SDL's queue and into the buffer (replacing whatever was there)
+             * \returns The amount of events in the buffer
+             */
+            std::size_t drain() {
+                this->buffer.clear();
+                SDL_PumpEvents();
+                while (true) {
+                    const std::size_t start = this->buffer.size();
+                    this->buffer.resize(start + bengine::event_dispatcher::chunk_size);
+                    const int count = SDL_PeepEvents(this->buffer.data() + start, bengine::event_dispatcher::chunk_size, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+                    this->buffer.resize(start + (count > 0 ? count : 0));
+                    if (count < bengine::event_dispatcher::chunk_size) {
+                        break;
+                    }
+                }
+
+                if (this->coalesce_motion) {
+                    std::size_t kept = 0;
+                    for (std::size_t i = 0; i < this->buffer.size(); i++) {
+                        const SDL_Event &event = this->buffer[i];
+                        if (kept > 0 && event.type == SDL_MOUSEMOTION && this->buffer[kept - 1].type == SDL_MOUSEMOTION && this->buffer[kept - 1].motion.which == event.motion.which && this->buffer[kept - 1].motion.windowID == event.motion.windowID) {
+                            SDL_MouseMotionEvent &merged = this->buffer[kept - 1].motion;
+                            const Sint32 xrel = merged.xrel + event.motion.xrel, yrel = merged.yrel + event.motion.yrel;
+                            merged = event.motion;
+                            merged.xrel = xrel;
+                            merged.yrel = yrel;
+                        } else {
+                            this->buffer[kept++] = event;
+                        }
+                    }
+                    this->buffer.resize(kept);
+                }
+                return this->buffer.size();
+            }
+            /** Put events into the buffer without going through SDL's queue (like events being replayed), replacing whatever was there
+             * \param events The events to put into the buffer
+             * \param count The amount of events
+             * \returns The amount of events in the buffer
+             */
+            std::size_t load(const SDL_Event *events, const std::size_t &count) {
+                this->buffer.assign(events, events + count);
+                return this->buffer.size();
+            }
+            /** Get the events drained by the last call to bengine::event_dispatcher::drain()
+             * \returns The drained events in the order that they happened
+             */
+            const std::vector<SDL_Event>& get_events() const {
+                return this->buffer;
+            }
+
+            /** Send every drained event to its handlers
+             * \returns The amount of events that had at least one handler (or went to the fallback)
+             */
+            std::size_t dispatch() {
+                std::size_t output = 0;
+                this->dispatching = true;
+                for (std::size_t i = 0; i < this->buffer.size();) {
+                    // every event in a run of the same type goes through the same handlers, so they only get looked up once
+                    const Uint32 type = this->buffer[i].type;
+                    std::size_t end = i + 1;
+                    while (end < this->buffer.size() && this->buffer[end].type == type) {
+                        end++;
+                    }
+
+                    const std::unordered_map<Uint32, std::vector<bengine::event_dispatcher::entry>>::const_iterator found = this->handlers.find(type);
+                    if (found != this->handlers.end() && !found->second.empty()) {
+                        const std::vector<bengine::event_dispatcher::entry> &entries = found->second;
+                        for (; i < end; i++) {
+                            for (std::size_t j = 0; j < entries.size(); j++) {
+                                if (!entries[j].removed) {
+                                    entries[j].function(this->buffer[i]);
+                                }
+                            }
+                            output++;
+                        }
+                    } else if (this->fallback) {
+                        for (; i < end; i++) {
+                            this->fallback(this->buffer[i]);
+                            output++;
+                        }
+                    }
+                    i = end;
+                }
+
+                this->dispatching = false;
+                if (this->pending_clear) {
+                    this->pending_clear = false;
+                    this->clear();
+                }
+                for (std::size_t i = 0; i < this->pending_additions.size(); i++) {
+                    this->handlers[this->pending_additions[i].first].push_back(this->pending_additions[i].second);
+                }
+                for (std::size_t i = 0; i < this->pending_removals.size(); i++) {
+                    this->remove(this->pending_removals[i]);
+                }
+                this->pending_additions.clear();
+                this->pending_removals.clear();
+                return output;
+            }
+    };
+}
+
+#endif // BENGINE_EVENT_DISPATCHER_hpp
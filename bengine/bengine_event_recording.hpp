@@ -0,0 +1,184 @@
+#ifndef BENGINE_EVENT_RECORDING_hpp
+#define BENGINE_EVENT_RECORDING_hpp
+
+#include <SDL2/SDL.h>
+#include <cstring>
+#include <string>
+
+#include "bengine_input_recording.hpp"
+
+namespace bengine {
+    /* Layout of an SDL_Event payload (the payloads of a bengine::input_recorder recording):
+     * - a single format byte (see bengine::event_encoding::formats)
+     * - MOTION, BUTTON, and KEY events (the bulk of any session) are written field by field as varints, signed fields zigzag-encoded
+     * - everything else is written as the raw bytes of the SDL_Event with its timestamp zeroed and its trailing zero bytes cut off
+     * Timestamps aren't kept (replayed events get stamped with the current time) and events that only carry pointers (user events, dropped files, system window manager events) aren't recorded at all, since their pointers mean nothing once the session is over
+     */
+
+    // \brief Turns SDL_Events into compact payloads for bengine::input_recorder and back
+    class event_encoding {
+        public:
+            // \brief How a payload is laid out (its first byte)
+            enum class formats : unsigned char {
+                // \brief The raw bytes of the event, with its trailing zero bytes cut off
+                RAW = 0,
+                // \brief windowID, which, state, then x, y, xrel, and yrel zigzag-encoded
+                MOTION = 1,
+                // \brief type, windowID, which, button, state, clicks, then x and y zigzag-encoded
+                BUTTON = 2,
+                // \brief type, windowID, state, repeat, scancode, sym (zigzag-encoded), then mod
+                KEY = 3
+            };
+
+            /** Check whether an event can be recorded or not
+             * \param event The event to check
+             * \returns Whether the event can be recorded or not (events that only carry pointers can't be)
+             */
+            static bool is_recordable(const SDL_Event &event) {
+                return event.type != SDL_SYSWMEVENT && event.type != SDL_TEXTEDITING_EXT && event.type != SDL_DROPFILE && event.type != SDL_DROPTEXT && event.type < SDL_USEREVENT;
+            }
+
+            /** Write an event as a payload
+             * \param event The event to write
+             * \param payload Where to write the payload (replaced)
+             * \returns Whether the event was written or not (see bengine::event_encoding::is_recordable())
+             */
+            static bool encode(const SDL_Event &event, std::string &payload) {
+                payload.clear();
+                if (!bengine::event_encoding::is_recordable(event)) {
+                    return false;
+                }
+                switch (event.type) {
+                    case SDL_MOUSEMOTION:
+                        payload += static_cast<char>(bengine::event_encoding::formats::MOTION);
+                        bengine::input_encoding::write_varint(payload, event.motion.windowID);
+                        bengine::input_encoding::write_varint(payload, event.motion.which);
+                        bengine::input_encoding::write_varint(payload, event.motion.state);
+                        bengine::input_encoding::write_varint(payload, bengine::input_encoding::zigzag_encode(event.motion.x));
+                        bengine::input_encoding::write_varint(payload, bengine::input_encoding::zigzag_encode(event.motion.y));
+                        bengine::input_encoding::write_varint(payload, bengine::input_encoding::zigzag_encode(event.motion.xrel));
+                        bengine::input_encoding::write_varint(payload, bengine::input_encoding::zigzag_encode(event.motion.yrel));
+                        return true;
+                    case SDL_MOUSEBUTTONDOWN:
+                    case SDL_MOUSEBUTTONUP:
+                        payload += static_cast<char>(bengine::event_encoding::formats::BUTTON);
+                        bengine::input_encoding::write_varint(payload, event.type);
+                        bengine::input_encoding::write_varint(payload, event.button.windowID);
+                        bengine::input_encoding::write_varint(payload, event.button.which);
+                        bengine::input_encoding::write_varint(payload, event.button.button);
+                        bengine::input_encoding::write_varint(payload, event.button.state);
+                        bengine::input_encoding::write_varint(payload, event.button.clicks);
+                        bengine::input_encoding::write_varint(payload, bengine::input_encoding::zigzag_encode(event.button.x));
+                        bengine::input_encoding::write_varint(payload, bengine::input_encoding::zigzag_encode(event.button.y));
+                        return true;
+                    case SDL_KEYDOWN:
+                    case SDL_KEYUP:
+                        payload += static_cast<char>(bengine::event_encoding::formats::KEY);
+                        bengine::input_encoding::write_varint(payload, event.type);
+                        bengine::input_encoding::write_varint(payload, event.key.windowID);
+                        bengine::input_encoding::write_varint(payload, event.key.state);
+                        bengine::input_encoding::write_varint(payload, event.key.repeat);
+                        bengine::input_encoding::write_varint(payload, event.key.keysym.scancode);
+                        bengine::input_encoding::write_varint(payload, bengine::input_encoding::zigzag_encode(event.key.keysym.sym));
+                        bengine::input_encoding::write_varint(payload, event.key.keysym.mod);
+                        return true;
+                }
+
+                SDL_Event copy = event;
+                copy.common.timestamp = 0;
+                const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&copy);
+                std::size_t size = sizeof(SDL_Event);
+                while (size > 0 && bytes[size - 1] == 0) {
+                    size--;
+                }
+                payload += static_cast<char>(bengine::event_encoding::formats::RAW);
+                payload.append(reinterpret_cast<const char*>(bytes), size);
+                return true;
+            }
+
+            /** Read an event back out of a payload
+             * \param payload The payload
+             * \param size The size of the payload in bytes
+             * \param event Where to put the event (stamped with the current time)
+             * \returns Whether the payload was understood or not
+             */
+            static bool decode(const char *payload, const std::size_t &size, SDL_Event &event) {
+                if (size < 1) {
+                    return false;
+                }
+                std::memset(&event, 0, sizeof(SDL_Event));
+                std::size_t position = 1;
+                unsigned long long fields[8];
+                switch (static_cast<bengine::event_encoding::formats>(payload[0])) {
+                    case bengine::event_encoding::formats::RAW:
+                        if (size - 1 > sizeof(SDL_Event)) {
+                            return false;
+                        }
+                        std::memcpy(&event, payload + 1, size - 1);
+                        break;
+                    case bengine::event_encoding::formats::MOTION:
+                        if (!bengine::event_encoding::read_fields(payload, size, position, fields, 7)) {
+                            return false;
+                        }
+                        event.type = SDL_MOUSEMOTION;
+                        event.motion.windowID = static_cast<Uint32>(fields[0]);
+                        event.motion.which = static_cast<Uint32>(fields[1]);
+                        event.motion.state = static_cast<Uint32>(fields[2]);
+                        event.motion.x = static_cast<Sint32>(bengine::input_encoding::zigzag_decode(fields[3]));
+                        event.motion.y = static_cast<Sint32>(bengine::input_encoding::zigzag_decode(fields[4]));
+                        event.motion.xrel = static_cast<Sint32>(bengine::input_encoding::zigzag_decode(fields[5]));
+                        event.motion.yrel = static_cast<Sint32>(bengine::input_encoding::zigzag_decode(fields[6]));
+                        break;
+                    case bengine::event_encoding::formats::BUTTON:
+                        if (!bengine::event_encoding::read_fields(payload, size, position, fields, 8)) {
+                            return false;
+                        }
+                        event.type = static_cast<Uint32>(fields[0]);
+                        event.button.windowID = static_cast<Uint32>(fields[1]);
+                        event.button.which = static_cast<Uint32>(fields[2]);
+                        event.button.button = static_cast<Uint8>(fields[3]);
+                        event.button.state = static_cast<Uint8>(fields[4]);
+                        event.button.clicks = static_cast<Uint8>(fields[5]);
+                        event.button.x = static_cast<Sint32>(bengine::input_encoding::zigzag_decode(fields[6]));
+                        event.button.y = static_cast<Sint32>(bengine::input_encoding::zigzag_decode(fields[7]));
+                        break;
+                    case bengine::event_encoding::formats::KEY:
+                        if (!bengine::event_encoding::read_fields(payload, size, position, fields, 7)) {
+                            return false;
+                        }
+                        event.type = static_cast<Uint32>(fields[0]);
+                        event.key.windowID = static_cast<Uint32>(fields[1]);
+                        event.key.state = static_cast<Uint8>(fields[2]);
+                        event.key.repeat = static_cast<Uint8>(fields[3]);
+                        event.key.keysym.scancode = static_cast<SDL_Scancode>(fields[4]);
+                        event.key.keysym.sym = static_cast<SDL_Keycode>(bengine::input_encoding::zigzag_decode(fields[5]));
+                        event.key.keysym.mod = static_cast<Uint16>(fields[6]);
+                        break;
+                    default:
+                        return false;
+                }
+                event.common.timestamp = SDL_GetTicks();
+                return true;
+            }
+
+        private:
+            /** Read several varints in a row
+             * \param payload The payload
+             * \param size The size of the payload in bytes
+             * \param position Where to start reading (moved past the varints)
+             * \param fields Where to put the values
+             * \param count The amount of varints to read
+             * \returns Whether every varint was read or not
+             */
+            static bool read_fields(const char *payload, const std::size_t &size, std::size_t &position, unsigned long long *fields, const std::size_t &count) {
+                for (std::size_t i = 0; i < count; i++) {
+                    if (!bengine::input_encoding::read_varint(payload, size, position, fields[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+    };
+}
+
+#endif // BENGINE_EVENT_RECORDING_hpp
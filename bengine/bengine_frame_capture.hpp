@@ -0,0 +1,277 @@
+#ifndef BENGINE_FRAME_CAPTURE_hpp
+#define BENGINE_FRAME_CAPTURE_hpp
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define BENGINE_POPEN _popen
+#define BENGINE_PCLOSE _pclose
+#define BENGINE_PIPE_MODE "wb"
+#else
+#define BENGINE_POPEN popen
+#define BENGINE_PCLOSE pclose
+#define BENGINE_PIPE_MODE "w"
+#endif
+
+namespace bengine {
+    /** Reads frames back from a renderer and writes them out on a worker thread
+     * Frames are read into a fixed pool of buffers; if the worker falls behind and every buffer is in use, frames get dropped (and counted) instead of stalling the rendering thread on file I/O
+     */
+    class frame_capture {
+        public:
+            // \brief What to do with each captured frame
+            enum class output_format : unsigned char {
+                // \brief One numbered PNG per frame ("[destination]_000000.png", "[destination]_000001.png", ...)
+                PNG = 0,
+                // \brief Every frame's RGBA pixels one after another in a single file (the same layout as ffmpeg's "-f rawvideo -pix_fmt rgba")
+                RAW = 1,
+                // \brief Every frame's RGBA pixels written into the standard input of a command (like "ffmpeg -f rawvideo -pix_fmt rgba -s 1280x720 -r 60 -i - out.mp4")
+                PIPE = 2
+            };
+
+            // \brief Counts of what has happened since capturing started
+            struct statistics {
+                // \brief Frames read back from the renderer
+                unsigned long captured = 0;
+                // \brief Frames that were skipped because every buffer was in use (or the frame was a different size)
+                unsigned long dropped = 0;
+                // \brief Frames that have been written out
+                unsigned long written = 0;
+                // \brief Frames that couldn't be written out
+                unsigned long failed = 0;
+            };
+
+        private:
+            // \brief A frame waiting to be written
+            struct frame {
+                std::size_t buffer = 0;
+                int width = 0;
+                int height = 0;
+                unsigned long number = 0;
+            };
+
+            bengine::frame_capture::output_format format = bengine::frame_capture::output_format::PNG;
+            std::string destination;
+            // \brief The file or pipe that RAW and PIPE frames go into
+            std::FILE *stream = NULL;
+            // \brief The size that every RAW and PIPE frame has to be (set by the first frame)
+            int stream_width = 0;
+            int stream_height = 0;
+
+            std::vector<std::vector<unsigned char>> buffers;
+            // \brief Buffers that aren't holding a frame (guarded by the mutex)
+            std::vector<std::size_t> free_buffers;
+            // \brief Frames waiting for the worker (guarded by the mutex)
+            std::deque<bengine::frame_capture::frame> queue;
+
+            std::thread worker;
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool capturing = false;
+            bool stopping = false;
+
+            // \brief written and failed are guarded by the mutex, everything else is only touched on the rendering thread
+            bengine::frame_capture::statistics counts;
+            unsigned long frame_number = 0;
+
+            void work() {
+                while (true) {
+                    bengine::frame_capture::frame current;
+                    {
+                        std::unique_lock<std::mutex> lock(this->mutex);
+                        this->wake.wait(lock, [this]() {return this->stopping || !this->queue.empty();});
+                        // stopping still writes out everything that was captured
+                        if (this->queue.empty()) {
+                            return;
+                        }
+                        current = this->queue.front();
+                        this->queue.pop_front();
+                    }
+
+                    const bool success = this->write(current);
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->free_buffers.push_back(current.buffer);
+                    (success ? this->counts.written : this->counts.failed)++;
+                }
+            }
+            /** Write a single frame out (only called on the worker thread)
+             * \param current The frame to write
+             * \returns Whether the frame was written or not
+             */
+            bool write(const bengine::frame_capture::frame &current) {
+                std::vector<unsigned char> &pixels = this->buffers[current.buffer];
+                if (this->format != bengine::frame_capture::output_format::PNG) {
+                    return std::fwrite(pixels.data(), 1, static_cast<std::size_t>(current.width) * current.height * 4, this->stream) == static_cast<std::size_t>(current.width) * current.height * 4;
+                }
+
+                char number[16];
+                std::snprintf(number, sizeof(number), "_%06lu.png", current.number);
+                SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(pixels.data(), current.width, current.height, 32, current.width * 4, SDL_PIXELFORMAT_RGBA32);
+                const bool output = surface != NULL && IMG_SavePNG(surface, (this->destination + number).c_str()) == 0;
+                SDL_FreeSurface(surface);
+                return output;
+            }
+
+        public:
+            /** bengine::frame_capture constructor
+             * \param pool_size The amount of frames that can be waiting to be written at once (more survives longer hiccups but uses more memory)
+             */
+            frame_capture(const std::size_t &pool_size = 4) {
+                this->buffers.resize(pool_size > 0 ? pool_size : 1);
+            }
+            // \brief bengine::frame_capture deconstructor; writes out anything still waiting
+            ~frame_capture() {
+                this->stop();
+            }
+            frame_capture(const bengine::frame_capture&) = delete;
+            bengine::frame_capture& operator=(const bengine::frame_capture&) = delete;
+
+            /** Start capturing (stopping any capture that is already going)
+             * \param destination The path prefix for PNG frames, the file for RAW frames, or the command to pipe PIPE frames into
+             * \param format What to do with each captured frame
+             * \returns 0 on success or -1 if the file/pipe couldn't be opened
+             */
+            int start(const std::string &destination, const bengine::frame_capture::output_format &format = bengine::frame_capture::output_format::PNG) {
+                this->stop();
+                if (format == bengine::frame_capture::output_format::RAW) {
+                    this->stream = std::fopen(destination.c_str(), "wb");
+                } else if (format == bengine::frame_capture::output_format::PIPE) {
+                    this->stream = BENGINE_POPEN(destination.c_str(), BENGINE_PIPE_MODE);
+                }
+                if (format != bengine::frame_capture::output_format::PNG && this->stream == NULL) {
+                    std::cout << "Frame capture failed to open \"" << destination << "\" [bengine::frame_capture::start]\n";
+                    return -1;
+                }
+
+                this->format = format;
+                this->destination = destination;
+                this->stream_width = 0;
+                this->stream_height = 0;
+                this->counts = bengine::frame_capture::statistics();
+                this->frame_number = 0;
+                this->free_buffers.clear();
+                for (std::size_t i = 0; i < this->buffers.size(); i++) {
+                    this->free_buffers.push_back(i);
+                }
+                this->capturing = true;
+                this->worker = std::thread(&bengine::frame_capture::work, this);
+                return 0;
+            }
+            // \brief Stop capturing; blocks until every frame that was already captured has been written out
+            void stop() {
+                if (!this->capturing) {
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->stopping = true;
+                }
+                this->wake.notify_all();
+                this->worker.join();
+                this->stopping = false;
+                this->capturing = false;
+
+                if (this->format == bengine::frame_capture::output_format::RAW) {
+                    std::fclose(this->stream);
+                } else if (this->format == bengine::frame_capture::output_format::PIPE) {
+                    BENGINE_PCLOSE(this->stream);
+                }
+                this->stream = NULL;
+            }
+            /** Get whether frames are being captured or not
+             * \returns Whether frames are being captured or not
+             */
+            bool is_capturing() const {
+                return this->capturing;
+            }
+
+            /** Read the renderer's current target back and queue it to be written; never waits on the worker (call before presenting, since the back buffer is undefined afterwards)
+             * \param renderer The renderer to read from
+             * \returns 0 on success, 1 if the frame was dropped, or -1 if the pixels couldn't be read
+             */
+            int capture(SDL_Renderer *renderer) {
+                if (!this->capturing) {
+                    return 1;
+                }
+                const unsigned long number = this->frame_number++;
+                int width, height;
+                if (SDL_GetRendererOutputSize(renderer, &width, &height) != 0) {
+                    return -1;
+                }
+                // a raw stream can't change sizes partway through
+                if (this->format != bengine::frame_capture::output_format::PNG) {
+                    if (this->stream_width == 0) {
+                        this->stream_width = width;
+                        this->stream_height = height;
+                    } else if (width != this->stream_width || height != this->stream_height) {
+                        this->counts.dropped++;
+                        return 1;
+                    }
+                }
+
+                std::size_t buffer;
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    if (this->free_buffers.empty()) {
+                        this->counts.dropped++;
+                        return 1;
+                    }
+                    buffer = this->free_buffers.back();
+                    this->free_buffers.pop_back();
+                }
+
+                // buffers only ever grow, so after the first few frames this never allocates
+                this->buffers[buffer].resize(static_cast<std::size_t>(width) * height * 4);
+                // reading with a NULL rectangle only reads the viewport (which logical sizes letterbox), so the viewport covers the whole output while reading
+                int logical_width, logical_height;
+                SDL_Rect viewport;
+                SDL_RenderGetLogicalSize(renderer, &logical_width, &logical_height);
+                SDL_RenderGetViewport(renderer, &viewport);
+                SDL_RenderSetViewport(renderer, NULL);
+                const int read = SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGBA32, this->buffers[buffer].data(), width * 4);
+                // setting the logical size again recalculates the letterboxed viewport exactly
+                if (logical_width > 0 && logical_height > 0) {
+                    SDL_RenderSetLogicalSize(renderer, logical_width, logical_height);
+                } else {
+                    SDL_RenderSetViewport(renderer, &viewport);
+                }
+                if (read != 0) {
+                    std::cout << "Frame capture failed to read pixels [bengine::frame_capture::capture]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->free_buffers.push_back(buffer);
+                    return -1;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->queue.push_back({buffer, width, height, number});
+                    this->counts.captured++;
+                }
+                this->wake.notify_one();
+                return 0;
+            }
+
+            /** Get what has happened since capturing started
+             * \returns Counts of captured, dropped, written, and failed frames
+             */
+            bengine::frame_capture::statistics get_statistics() {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return this->counts;
+            }
+    };
+}
+
+#undef BENGINE_POPEN
+#undef BENGINE_PCLOSE
+#undef BENGINE_PIPE_MODE
+
+#endif // BENGINE_FRAME_CAPTURE_hpp
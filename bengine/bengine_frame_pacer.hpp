@@ -0,0 +1,179 @@
+#ifndef BENGINE_FRAME_PACER_hpp
+#define BENGINE_FRAME_PACER_hpp
+
+#include <SDL2/SDL.h>
+#include <cmath>
+
+namespace bengine {
+    /** Keeps frames evenly spaced using SDL's high-resolution performance counter
+     * Waiting is done by sleeping for most of the remaining time and then spinning for the rest, since the OS can wake a sleeping thread up late by a millisecond or more; how late it has been waking up is measured so that the sleeps get shortened to match
+     * When the renderer presents with vsync the pacer can leave the waiting to SDL_RenderPresent instead (it still measures every frame)
+     */
+    class frame_pacer {
+        private:
+            // \brief Performance counter ticks per second
+            Uint64 frequency = 1;
+            // \brief How long each frame should take (performance counter ticks)
+            Uint64 period = 1;
+            // \brief When the current frame should end (performance counter ticks)
+            Uint64 deadline = 0;
+            // \brief When the last frame ended (performance counter ticks)
+            Uint64 last_frame = 0;
+
+            // \brief The part of every wait that is spun instead of slept through (seconds)
+            double spin_time = 0.002;
+            // \brief How late SDL_Delay tends to wake up (seconds), smoothed over time
+            double oversleep = 0.001;
+            // \brief Whether SDL_RenderPresent waits for vsync (so presented frames don't need to be waited on)
+            bool defer_to_vsync = false;
+
+            // \brief How much of each new measurement goes into the smoothed values (0-1)
+            double smoothing = 0.1;
+            double frame_time = 0;
+            double smoothed_frame_time = 0;
+            double frame_time_variance = 0;
+
+        public:
+            /** bengine::frame_pacer constructor
+             * \param target_rate How many frames per second to aim for
+             */
+            frame_pacer(const double &target_rate = 60) {
+                this->frequency = SDL_GetPerformanceFrequency();
+                this->set_target_rate(target_rate);
+                this->reset();
+            }
+            // \brief bengine::frame_pacer deconstructor
+            ~frame_pacer() {}
+
+            /** Get the current time according to the performance counter
+             * \returns The current time (seconds) (only meaningful relative to other calls)
+             */
+            double now() const {
+                return static_cast<double>(SDL_GetPerformanceCounter()) / this->frequency;
+            }
+
+            // \brief Start pacing from the current time (after a pause or a long load, so that the missed frames aren't rushed through)
+            void reset() {
+                this->last_frame = SDL_GetPerformanceCounter();
+                this->deadline = this->last_frame + this->period;
+            }
+
+            /** Get how many frames per second the pacer aims for
+             * \returns How many frames per second the pacer aims for
+             */
+            double get_target_rate() const {
+                return static_cast<double>(this->frequency) / this->period;
+            }
+            /** Set how many frames per second the pacer aims for
+             * \param target_rate How many frames per second to aim for
+             */
+            void set_target_rate(const double &target_rate) {
+                this->period = target_rate > 0 ? static_cast<Uint64>(this->frequency / target_rate) : 1;
+                this->period = this->period > 0 ? this->period : 1;
+            }
+            /** Get how long each frame should take
+             * \returns How long each frame should take (seconds)
+             */
+            double get_target_frame_time() const {
+                return static_cast<double>(this->period) / this->frequency;
+            }
+
+            /** Get how much of every wait is spun instead of slept through
+             * \returns How much of every wait is spun (seconds)
+             */
+            double get_spin_time() const {
+                return this->spin_time;
+            }
+            /** Set how much of every wait is spun instead of slept through (more is steadier but keeps a core busy for longer)
+             * \param spin_time How much of every wait to spin (seconds)
+             */
+            void set_spin_time(const double &spin_time) {
+                this->spin_time = spin_time > 0 ? spin_time : 0;
+            }
+
+            /** Get whether presented frames are left for vsync to pace or not
+             * \returns Whether presented frames are left for vsync to pace or not
+             */
+            bool is_deferring_to_vsync() const {
+                return this->defer_to_vsync;
+            }
+            /** Set whether presented frames are left for vsync to pace (only turn this on if vsync was actually enabled, see bengine::render_window::set_vsync())
+             * \param defer Whether presented frames are left for vsync to pace or not
+             */
+            void set_deferring_to_vsync(const bool &defer) {
+                this->defer_to_vsync = defer;
+            }
+
+            /** Set how much of each new measurement goes into the smoothed frame time (lower is smoother but slower to react)
+             * \param smoothing The weight of each new measurement (0-1)
+             */
+            void set_smoothing(const double &smoothing) {
+                this->smoothing = smoothing < 0 ? 0 : (smoothing > 1 ? 1 : smoothing);
+            }
+
+            /** Wait until the current frame should end, then start the next one
+             * \param presented Whether the frame was presented (with vsync, presented frames have already been waited on)
+             * \returns How long the frame took (seconds)
+             */
+            double wait(const bool &presented = true) {
+                if (!(this->defer_to_vsync && presented)) {
+                    Uint64 current = SDL_GetPerformanceCounter();
+                    // sleep through whatever won't be spun, minus how late sleeping tends to wake up
+                    const double sleep_time = static_cast<double>(this->deadline > current ? this->deadline - current : 0) / this->frequency - this->spin_time - this->oversleep;
+                    if (sleep_time >= 0.001) {
+                        const Uint32 milliseconds = static_cast<Uint32>(sleep_time * 1000);
+                        SDL_Delay(milliseconds);
+                        const Uint64 woke = SDL_GetPerformanceCounter();
+                        const double late = static_cast<double>(woke - current) / this->frequency - milliseconds / 1000.0;
+                        this->oversleep += (late - this->oversleep) * 0.1;
+                        this->oversleep = this->oversleep > 0 ? this->oversleep : 0;
+                    }
+                    while ((current = SDL_GetPerformanceCounter()) < this->deadline) {}
+                }
+
+                const Uint64 current = SDL_GetPerformanceCounter();
+                this->frame_time = static_cast<double>(current - this->last_frame) / this->frequency;
+                this->last_frame = current;
+                // deadlines advance by exactly one period so that the rate doesn't drift, unless a frame ran so long that catching up would mean rushing
+                this->deadline += this->period;
+                if (this->deadline + this->period < current || (this->defer_to_vsync && presented)) {
+                    this->deadline = current + this->period;
+                }
+
+                if (this->smoothed_frame_time == 0) {
+                    this->smoothed_frame_time = this->frame_time;
+                }
+                const double difference = this->frame_time - this->smoothed_frame_time;
+                this->smoothed_frame_time += difference * this->smoothing;
+                this->frame_time_variance += (difference * difference - this->frame_time_variance) * this->smoothing;
+                return this->frame_time;
+            }
+
+            /** Get how long the last frame took
+             * \returns How long the last frame took (seconds)
+             */
+            double get_frame_time() const {
+                return this->frame_time;
+            }
+            /** Get how long frames have been taking, smoothed over recent frames
+             * \returns The smoothed frame time (seconds)
+             */
+            double get_smoothed_frame_time() const {
+                return this->smoothed_frame_time;
+            }
+            /** Get how much frame times have been varying, smoothed over recent frames
+             * \returns The standard deviation of recent frame times (seconds)
+             */
+            double get_frame_time_deviation() const {
+                return std::sqrt(this->frame_time_variance);
+            }
+            /** Get how late sleeping has been waking up, which is taken out of every sleep
+             * \returns How late sleeping has been waking up (seconds)
+             */
+            double get_oversleep() const {
+                return this->oversleep;
+            }
+    };
+}
+
+#endif // BENGINE_FRAME_PACER_hpp
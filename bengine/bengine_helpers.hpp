@@ -346,6 +346,235 @@ namespace bengine {
             }
     };
 
+    // \brief A spatial index of rectangles over a bounded zone, bucketed into a uniform grid of cells so that point queries only look at the rectangles that touch a single cell
+    class uniform_grid_index {
+        private:
+            // \brief A rectangle within the index
+            struct entry {
+                int x = 0;
+                int y = 0;
+                int width = 0;
+                int height = 0;
+                // \brief When the entry was last inserted/moved; later entries sit on top of earlier ones
+                unsigned long long order = 0;
+                bool active = false;
+            };
+
+            // \brief Width of the zone covered by the index
+            int width = 0;
+            // \brief Height of the zone covered by the index
+            int height = 0;
+            // \brief The width and height of each bucket
+            int cell_size = 8;
+            // \brief The amount of bucket columns
+            int cols = 0;
+            // \brief The amount of bucket rows
+            int rows = 0;
+
+            std::vector<bengine::uniform_grid_index::entry> entries;
+            // \brief Indices of entries that have been removed and can be reused
+            std::vector<int> free_entries;
+            // \brief The entries touching each bucket, row by row
+            std::vector<std::vector<int>> buckets;
+            // \brief The order that will be given to the next inserted/moved entry
+            unsigned long long next_order = 0;
+
+            // find the range of buckets that a rectangle touches, returning false if it doesn't touch any
+            bool find_bucket_range(const bengine::uniform_grid_index::entry &entry, int &col_1, int &row_1, int &col_2, int &row_2) const {
+                if (entry.width <= 0 || entry.height <= 0 || entry.x >= this->width || entry.y >= this->height || entry.x + entry.width <= 0 || entry.y + entry.height <= 0) {
+                    return false;
+                }
+                col_1 = (entry.x < 0 ? 0 : entry.x) / this->cell_size;
+                row_1 = (entry.y < 0 ? 0 : entry.y) / this->cell_size;
+                col_2 = (entry.x + entry.width > this->width ? this->width - 1 : entry.x + entry.width - 1) / this->cell_size;
+                row_2 = (entry.y + entry.height > this->height ? this->height - 1 : entry.y + entry.height - 1) / this->cell_size;
+                return true;
+            }
+            void add_to_buckets(const int &id) {
+                int col_1, row_1, col_2, row_2;
+                if (!this->find_bucket_range(this->entries[id], col_1, row_1, col_2, row_2)) {
+                    return;
+                }
+                for (int row = row_1; row <= row_2; row++) {
+                    for (int col = col_1; col <= col_2; col++) {
+                        this->buckets[row * this->cols + col].emplace_back(id);
+                    }
+                }
+            }
+            void remove_from_buckets(const int &id) {
+                int col_1, row_1, col_2, row_2;
+                if (!this->find_bucket_range(this->entries[id], col_1, row_1, col_2, row_2)) {
+                    return;
+                }
+                for (int row = row_1; row <= row_2; row++) {
+                    for (int col = col_1; col <= col_2; col++) {
+                        std::vector<int> &bucket = this->buckets[row * this->cols + col];
+                        for (std::size_t i = 0; i < bucket.size(); i++) {
+                            if (bucket[i] == id) {
+                                bucket[i] = bucket.back();
+                                bucket.pop_back();
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+        public:
+            // \brief bengine::uniform_grid_index constructor (covers nothing until resized)
+            uniform_grid_index() {}
+            /** bengine::uniform_grid_index constructor
+             * \param width Width of the zone covered by the index
+             * \param height Height of the zone covered by the index
+             * \param cell_size The width and height of each bucket; smaller buckets make queries quicker but make inserting/moving large rectangles slower
+             */
+            uniform_grid_index(const int &width, const int &height, const int &cell_size = 8) {
+                this->cell_size = cell_size < 1 ? 1 : cell_size;
+                this->resize(width, height);
+            }
+            // \brief bengine::uniform_grid_index deconstructor
+            ~uniform_grid_index() {}
+
+            /** Get the width of the zone covered by the index
+             * \returns The width of the zone covered by the index
+             */
+            int get_width() const {
+                return this->width;
+            }
+            /** Get the height of the zone covered by the index
+             * \returns The height of the zone covered by the index
+             */
+            int get_height() const {
+                return this->height;
+            }
+            /** Get the width and height of each grid cell
+             * \returns The width and height of each grid cell
+             */
+            int get_cell_size() const {
+                return this->cell_size;
+            }
+            /** Change the zone covered by the index, keeping every entry (entries outside of the zone can't be found by queries until the zone covers them)
+             * \param width The new width
+             * \param height The new height
+             */
+            void resize(const int &width, const int &height) {
+                this->width = width < 0 ? 0 : width;
+                this->height = height < 0 ? 0 : height;
+                this->cols = (this->width + this->cell_size - 1) / this->cell_size;
+                this->rows = (this->height + this->cell_size - 1) / this->cell_size;
+                this->buckets.assign(this->cols * this->rows, std::vector<int>());
+                for (std::size_t i = 0; i < this->entries.size(); i++) {
+                    if (this->entries[i].active) {
+                        this->add_to_buckets(i);
+                    }
+                }
+            }
+            // \brief Remove every entry
+            void clear() {
+                this->entries.clear();
+                this->free_entries.clear();
+                this->buckets.assign(this->cols * this->rows, std::vector<int>());
+                this->next_order = 0;
+            }
+
+            /** Add a rectangle to the index
+             * \param x x-position of the rectangle's top-left corner
+             * \param y y-position of the rectangle's top-left corner
+             * \param width Width of the rectangle
+             * \param height Height of the rectangle
+             * \returns The id of the rectangle (ids of removed rectangles get reused)
+             */
+            int insert(const int &x, const int &y, const int &width, const int &height) {
+                int id = this->entries.size();
+                if (!this->free_entries.empty()) {
+                    id = this->free_entries.back();
+                    this->free_entries.pop_back();
+                } else {
+                    this->entries.emplace_back();
+                }
+                this->entries[id] = {x, y, width, height, this->next_order++, true};
+                this->add_to_buckets(id);
+                return id;
+            }
+            /** Move/resize a rectangle within the index, putting it on top of every other rectangle
+             * \param id The id of the rectangle
+             * \param x The new x-position of the rectangle's top-left corner
+             * \param y The new y-position of the rectangle's top-left corner
+             * \param width The new width of the rectangle
+             * \param height The new height of the rectangle
+             * \returns 0 on success or -1 if there is no rectangle with the given id
+             */
+            int move(const int &id, const int &x, const int &y, const int &width, const int &height) {
+                if (!this->contains(id)) {
+                    return -1;
+                }
+                this->remove_from_buckets(id);
+                this->entries[id] = {x, y, width, height, this->next_order++, true};
+                this->add_to_buckets(id);
+                return 0;
+            }
+            /** Remove a rectangle from the index
+             * \param id The id of the rectangle
+             * \returns 0 on success or -1 if there is no rectangle with the given id
+             */
+            int remove(const int &id) {
+                if (!this->contains(id)) {
+                    return -1;
+                }
+                this->remove_from_buckets(id);
+                this->entries[id].active = false;
+                this->free_entries.emplace_back(id);
+                return 0;
+            }
+            /** Check whether there is a rectangle with the given id or not
+             * \param id The id to check
+             * \returns Whether there is a rectangle with the given id or not
+             */
+            bool contains(const int &id) const {
+                return id >= 0 && id < static_cast<int>(this->entries.size()) && this->entries[id].active;
+            }
+
+            /** Find the top-most rectangle covering a point
+             * \param x x-position of the point
+             * \param y y-position of the point
+             * \returns The id of the top-most rectangle covering the point, or -1 if there isn't one
+             */
+            int query_point(const int &x, const int &y) const {
+                if (x < 0 || y < 0 || x >= this->width || y >= this->height) {
+                    return -1;
+                }
+                int output = -1;
+                const std::vector<int> &bucket = this->buckets[(y / this->cell_size) * this->cols + x / this->cell_size];
+                for (std::size_t i = 0; i < bucket.size(); i++) {
+                    const bengine::uniform_grid_index::entry &entry = this->entries[bucket[i]];
+                    if (x >= entry.x && x < entry.x + entry.width && y >= entry.y && y < entry.y + entry.height && (output == -1 || entry.order > this->entries[output].order)) {
+                        output = bucket[i];
+                    }
+                }
+                return output;
+            }
+            /** Find every rectangle covering a point
+             * \param x x-position of the point
+             * \param y y-position of the point
+             * \param hits Where to put the ids of the rectangles (cleared first, in no particular order)
+             * \returns The amount of rectangles covering the point
+             */
+            std::size_t query_point(const int &x, const int &y, std::vector<int> &hits) const {
+                hits.clear();
+                if (x < 0 || y < 0 || x >= this->width || y >= this->height) {
+                    return 0;
+                }
+                const std::vector<int> &bucket = this->buckets[(y / this->cell_size) * this->cols + x / this->cell_size];
+                for (std::size_t i = 0; i < bucket.size(); i++) {
+                    const bengine::uniform_grid_index::entry &entry = this->entries[bucket[i]];
+                    if (x >= entry.x && x < entry.x + entry.width && y >= entry.y && y < entry.y + entry.height) {
+                        hits.emplace_back(bucket[i]);
+                    }
+                }
+                return hits.size();
+            }
+    };
+
     // \brief A class containing useful functions designed for 4/8-bit autotiling
     class autotiler {
         private:
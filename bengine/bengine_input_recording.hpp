@@ -0,0 +1,303 @@
+#ifndef BENGINE_INPUT_RECORDING_hpp
+#define BENGINE_INPUT_RECORDING_hpp
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bengine {
+    /* Layout of a recording:
+     * - the magic bytes "BENGINPT" followed by a single version byte
+     * - any amount of records, each being:
+     *     - the amount of compute ticks since the previous record (varint)
+     *     - the size of the payload in bytes (varint)
+     *     - the payload itself (what it means is up to whoever recorded it)
+     * - records with an empty payload only mark time passing; one is always written when a recording is closed so that the length of the session is kept
+     */
+
+    // \brief Helpers for the varint/zigzag encoding used by bengine::input_recorder and bengine::input_replayer
+    class input_encoding {
+        public:
+            static constexpr char magic[8] = {'B', 'E', 'N', 'G', 'I', 'N', 'P', 'T'};
+            static constexpr unsigned char version = 1;
+
+            /** Append an unsigned integer to a buffer as a varint (7 bits per byte, least significant first)
+             * \param buffer Where to append the bytes
+             * \param value The value to append
+             */
+            static void write_varint(std::string &buffer, unsigned long long value) {
+                while (value >= 0x80) {
+                    buffer += static_cast<char>((value & 0x7F) | 0x80);
+                    value >>= 7;
+                }
+                buffer += static_cast<char>(value);
+            }
+            /** Read a varint out of a buffer
+             * \param data The buffer to read from
+             * \param size The size of the buffer
+             * \param position Where to start reading (moved past the varint)
+             * \param value Where to put the value
+             * \returns Whether a complete varint was read or not
+             */
+            static bool read_varint(const char *data, const std::size_t &size, std::size_t &position, unsigned long long &value) {
+                value = 0;
+                for (unsigned char shift = 0; position < size && shift < 64; shift += 7) {
+                    const unsigned char byte = static_cast<unsigned char>(data[position++]);
+                    value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /** Map a signed integer to an unsigned one so that small negative values stay small when written as a varint
+             * \param value The value to map
+             * \returns The zigzag-encoded value
+             */
+            static unsigned long long zigzag_encode(const long long &value) {
+                return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+            }
+            /** Undo bengine::input_encoding::zigzag_encode()
+             * \param value The zigzag-encoded value
+             * \returns The original signed value
+             */
+            static long long zigzag_decode(const unsigned long long &value) {
+                return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+            }
+    };
+
+    // \brief Writes timestamped input payloads to a compact binary file (see the layout above)
+    class input_recorder {
+        private:
+            std::ofstream file;
+            // \brief Records waiting to be written to the file
+            std::string buffer;
+            // \brief The compute tick of the most recent record
+            unsigned long long last_tick = 0;
+            // \brief The amount of records written (excluding ones that only mark time)
+            unsigned long long record_count = 0;
+
+            // \brief How large the buffer can get before being written to the file (bytes)
+            static constexpr std::size_t flush_size = 4096;
+
+        public:
+            // \brief bengine::input_recorder constructor
+            input_recorder() {}
+            // \brief bengine::input_recorder deconstructor, closes the recording if it is still open
+            ~input_recorder() {
+                this->close(this->last_tick);
+            }
+
+            /** Start a new recording, closing any recording that was already open
+             * \param path The path of the file to record to
+             * \returns 0 on success or -1 if the file couldn't be opened
+             */
+            int open(const std::string &path) {
+                this->close(this->last_tick);
+                this->file.open(path, std::ios::binary | std::ios::trunc);
+                if (!this->file.is_open()) {
+                    std::cout << "Input recorder failed to open \"" << path << "\" [bengine::input_recorder::open]\n";
+                    return -1;
+                }
+                this->buffer.assign(bengine::input_encoding::magic, sizeof(bengine::input_encoding::magic));
+                this->buffer += static_cast<char>(bengine::input_encoding::version);
+                this->last_tick = 0;
+                this->record_count = 0;
+                return 0;
+            }
+            /** Finish the recording, marking how many ticks the session lasted
+             * \param final_tick The compute tick that the session ended on
+             */
+            void close(const unsigned long long &final_tick) {
+                if (!this->file.is_open()) {
+                    return;
+                }
+                this->write_record(final_tick, nullptr, 0);
+                this->flush();
+                this->file.close();
+            }
+            /** Get whether a recording is open or not
+             * \returns Whether a recording is open or not
+             */
+            bool is_open() const {
+                return this->file.is_open();
+            }
+            /** Get the amount of records written to the current/last recording (excluding ones that only mark time)
+             * \returns The amount of records written
+             */
+            unsigned long long get_record_count() const {
+                return this->record_count;
+            }
+
+            /** Record a payload
+             * \param tick The compute tick that the payload happened on (never less than the previous record's)
+             * \param data The payload
+             * \param size The size of the payload in bytes
+             */
+            void record(const unsigned long long &tick, const void *data, const std::size_t &size) {
+                if (!this->file.is_open() || size == 0) {
+                    return;
+                }
+                this->write_record(tick, data, size);
+                this->record_count++;
+                if (this->buffer.size() >= bengine::input_recorder::flush_size) {
+                    this->flush();
+                }
+            }
+            /** Record a payload
+             * \param tick The compute tick that the payload happened on (never less than the previous record's)
+             * \param payload The payload
+             */
+            void record(const unsigned long long &tick, const std::string &payload) {
+                this->record(tick, payload.data(), payload.size());
+            }
+
+            // \brief Write every buffered record to the file
+            void flush() {
+                if (!this->file.is_open() || this->buffer.empty()) {
+                    return;
+                }
+                this->file.write(this->buffer.data(), this->buffer.size());
+                this->file.flush();
+                this->buffer.clear();
+            }
+
+        private:
+            void write_record(const unsigned long long &tick, const void *data, const std::size_t &size) {
+                const unsigned long long current_tick = tick < this->last_tick ? this->last_tick : tick;
+                bengine::input_encoding::write_varint(this->buffer, current_tick - this->last_tick);
+                bengine::input_encoding::write_varint(this->buffer, size);
+                if (size > 0) {
+                    this->buffer.append(static_cast<const char*>(data), size);
+                }
+                this->last_tick = current_tick;
+            }
+    };
+
+    // \brief Reads back a recording made by bengine::input_recorder (the entire file is kept in memory so that reading never touches the disk)
+    class input_replayer {
+        private:
+            std::vector<char> data;
+            // \brief Where the next record starts within the data
+            std::size_t position = 0;
+            // \brief The compute tick of the next record
+            unsigned long long next_tick = 0;
+            // \brief Where the next record's payload starts within the data and its size
+            std::size_t payload_position = 0;
+            std::size_t payload_size = 0;
+            // \brief Whether there is a next record or not
+            bool has_next = false;
+            // \brief The compute tick that the recording ended on
+            unsigned long long final_tick = 0;
+
+            // \brief The size of the magic bytes and version
+            static constexpr std::size_t header_size = sizeof(bengine::input_encoding::magic) + 1;
+
+        public:
+            // \brief bengine::input_replayer constructor
+            input_replayer() {}
+            // \brief bengine::input_replayer deconstructor
+            ~input_replayer() {}
+
+            /** Load a recording, replacing any that was already loaded
+             * \param path The path of the recording
+             * \returns 0 on success, -1 if the file couldn't be opened, or -2 if the file isn't a valid recording
+             */
+            int open(const std::string &path) {
+                this->data.clear();
+                this->has_next = false;
+                this->final_tick = 0;
+
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                if (!file.is_open()) {
+                    std::cout << "Input replayer failed to open \"" << path << "\" [bengine::input_replayer::open]\n";
+                    return -1;
+                }
+                this->data.resize(static_cast<std::size_t>(file.tellg()));
+                file.seekg(0);
+                file.read(this->data.data(), this->data.size());
+
+                if (this->data.size() < bengine::input_replayer::header_size || std::memcmp(this->data.data(), bengine::input_encoding::magic, sizeof(bengine::input_encoding::magic)) != 0 || static_cast<unsigned char>(this->data[sizeof(bengine::input_encoding::magic)]) != bengine::input_encoding::version) {
+                    std::cout << "Input replayer failed to read \"" << path << "\" as a recording [bengine::input_replayer::open]\n";
+                    this->data.clear();
+                    return -2;
+                }
+
+                // walk every record once to find where the session ended
+                this->rewind();
+                while (this->has_next) {
+                    this->final_tick = this->next_tick;
+                    this->advance();
+                }
+                this->rewind();
+                return 0;
+            }
+            // \brief Go back to the first record
+            void rewind() {
+                this->position = this->data.empty() ? 0 : bengine::input_replayer::header_size;
+                this->next_tick = 0;
+                this->has_next = !this->data.empty();
+                this->advance();
+            }
+
+            /** Get whether there are payloads left to read or not
+             * \returns Whether there are payloads left to read or not
+             */
+            bool is_finished() const {
+                return !this->has_next;
+            }
+            /** Get the compute tick of the next payload
+             * \returns The compute tick of the next payload (the final tick if there are none left)
+             */
+            unsigned long long get_next_tick() const {
+                return this->has_next ? this->next_tick : this->final_tick;
+            }
+            /** Get the compute tick that the recorded session ended on
+             * \returns The compute tick that the recorded session ended on
+             */
+            unsigned long long get_final_tick() const {
+                return this->final_tick;
+            }
+
+            /** Read the next payload if it happened on or before a compute tick
+             * \param tick The current compute tick
+             * \param payload Where to point to the payload (valid until the next call to open())
+             * \param size Where to put the size of the payload
+             * \returns Whether a payload was read or not
+             */
+            bool read(const unsigned long long &tick, const char *&payload, std::size_t &size) {
+                if (!this->has_next || this->next_tick > tick) {
+                    return false;
+                }
+                payload = this->data.data() + this->payload_position;
+                size = this->payload_size;
+                this->advance();
+                return true;
+            }
+
+        private:
+            // move onto the next record that has a payload, skipping any that only mark time
+            void advance() {
+                unsigned long long delta = 0, size = 0;
+                while (this->position < this->data.size()) {
+                    if (!bengine::input_encoding::read_varint(this->data.data(), this->data.size(), this->position, delta) || !bengine::input_encoding::read_varint(this->data.data(), this->data.size(), this->position, size) || this->position + size > this->data.size()) {
+                        break;
+                    }
+                    this->next_tick += delta;
+                    this->payload_position = this->position;
+                    this->payload_size = size;
+                    this->position += size;
+                    if (size > 0) {
+                        return;
+                    }
+                    this->final_tick = this->next_tick > this->final_tick ? this->next_tick : this->final_tick;
+                }
+                this->has_next = false;
+            }
+    };
+}
+
+#endif // BENGINE_INPUT_RECORDING_hpp
@@ -0,0 +1,409 @@
+#ifndef BENGINE_JOB_SYSTEM_hpp
+#define BENGINE_JOB_SYSTEM_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bengine {
+    /** Tasks and the order that they have to happen in, run all at once by bengine::job_system::run()
+     * A graph can be built once and run again every compute tick (like collisions -> AI -> cellular automata, with independent systems running side by side)
+     */
+    class task_graph {
+        friend class job_system;
+
+        private:
+            struct node {
+                std::function<void()> function;
+                // \brief The tasks that can't start until this one finishes
+                std::vector<std::size_t> dependents;
+                // \brief The amount of tasks that have to finish before this one can start
+                std::size_t dependency_count = 0;
+            };
+            std::vector<bengine::task_graph::node> nodes;
+            // \brief How many prerequisites each task is still waiting on while the graph runs
+            std::unique_ptr<std::atomic<std::size_t>[]> waiting;
+            std::size_t waiting_size = 0;
+            // \brief Whether the graph has been checked for cycles since it last changed
+            bool validated = false;
+
+            /** Check that every task can eventually run (that the dependencies don't loop back on themselves)
+             * \returns Whether every task can eventually run or not
+             */
+            bool validate() {
+                if (this->validated) {
+                    return true;
+                }
+                std::vector<std::size_t> remaining(this->nodes.size()), ready;
+                for (std::size_t i = 0; i < this->nodes.size(); i++) {
+                    remaining[i] = this->nodes[i].dependency_count;
+                    if (remaining[i] == 0) {
+                        ready.push_back(i);
+                    }
+                }
+                std::size_t visited = 0;
+                while (!ready.empty()) {
+                    const std::size_t task = ready.back();
+                    ready.pop_back();
+                    visited++;
+                    for (std::size_t i = 0; i < this->nodes[task].dependents.size(); i++) {
+                        if (--remaining[this->nodes[task].dependents[i]] == 0) {
+                            ready.push_back(this->nodes[task].dependents[i]);
+                        }
+                    }
+                }
+                this->validated = visited == this->nodes.size();
+                return this->validated;
+            }
+
+        public:
+            // \brief bengine::task_graph constructor
+            task_graph() {}
+            // \brief bengine::task_graph deconstructor
+            ~task_graph() {}
+
+            /** Add a task
+             * \param function What the task does
+             * \returns The task's ID (for bengine::task_graph::depend())
+             */
+            std::size_t add(const std::function<void()> &function) {
+                this->nodes.emplace_back();
+                this->nodes.back().function = function;
+                this->validated = false;
+                return this->nodes.size() - 1;
+            }
+            /** Make a task wait for another task to finish before it starts
+             * \param task The ID of the task that has to wait
+             * \param prerequisite The ID of the task that has to finish first
+             * \returns 0 on success or -1 if either ID is invalid (or they are the same)
+             */
+            int depend(const std::size_t &task, const std::size_t &prerequisite) {
+                if (task >= this->nodes.size() || prerequisite >= this->nodes.size() || task == prerequisite) {
+                    return -1;
+                }
+                this->nodes[prerequisite].dependents.push_back(task);
+                this->nodes[task].dependency_count++;
+                this->validated = false;
+                return 0;
+            }
+            /** Get the amount of tasks in the graph
+             * \returns The amount of tasks in the graph
+             */
+            std::size_t get_task_count() const {
+                return this->nodes.size();
+            }
+            // \brief Remove every task
+            void clear() {
+                this->nodes.clear();
+                this->validated = false;
+            }
+    };
+
+    /** A work-stealing thread pool for splitting compute work across every core
+     * Each thread (the workers and whichever thread is waiting on the work) has its own queue of jobs: it takes the newest jobs from its own queue and steals the oldest jobs from the others when it runs out, so threads rarely fight over the same queue
+     * The thread that calls parallel_for() or run() works on jobs too until everything it is waiting on is finished, so jobs can start more parallel work of their own without deadlocking
+     * Jobs shouldn't throw (there is nowhere for the exception to go)
+     */
+    class job_system {
+        private:
+            // \brief A piece of work in a queue (no allocations per job; the context outlives the job because whoever queued it waits for it)
+            struct job {
+                void (*run)(void *context, const std::size_t &begin, const std::size_t &end) = nullptr;
+                void *context = nullptr;
+                std::size_t begin = 0;
+                std::size_t end = 0;
+            };
+            struct queue {
+                std::mutex mutex;
+                std::deque<bengine::job_system::job> jobs;
+            };
+
+            // \brief What the jobs of a single parallel_for() share
+            template <class function_type> struct range_context {
+                const function_type *function;
+                std::atomic<std::size_t> remaining;
+            };
+            // \brief What the jobs of a single run() share
+            struct graph_context {
+                bengine::job_system *system;
+                bengine::task_graph *graph;
+                std::atomic<std::size_t> remaining;
+            };
+
+            std::vector<std::thread> workers;
+            // \brief The amount of worker threads to start once the first job comes in
+            unsigned int worker_count;
+            // \brief One queue for outside threads (index 0) and one for each worker
+            std::vector<std::unique_ptr<bengine::job_system::queue>> queues;
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool stopping = false;
+            // \brief The amount of jobs waiting in every queue (only goes up while holding the mutex, so sleeping workers can't miss new jobs)
+            std::atomic<std::size_t> queued = 0;
+
+            // \brief Whether the time spent in jobs is being measured or not
+            std::atomic<bool> timing = false;
+            // \brief The time spent in jobs (across every thread) since it was last taken (ns)
+            std::atomic<unsigned long long> busy_time = 0;
+
+            /** Get which system and queue the current thread works for
+             * \returns The current thread's system and queue index (NULL and 0 for outside threads)
+             */
+            static std::pair<const bengine::job_system*, std::size_t>& get_thread_slot() {
+                static thread_local std::pair<const bengine::job_system*, std::size_t> slot = {nullptr, 0};
+                return slot;
+            }
+            /** Get the queue that the current thread pushes jobs to and takes jobs from first
+             * \returns The index of the queue
+             */
+            std::size_t get_thread_queue() const {
+                const std::pair<const bengine::job_system*, std::size_t> &slot = bengine::job_system::get_thread_slot();
+                return slot.first == this ? slot.second : 0;
+            }
+
+            // \brief Start the workers if they haven't been started yet
+            void start() {
+                if (!this->workers.empty() || this->worker_count == 0) {
+                    return;
+                }
+                this->stopping = false;
+                for (unsigned int i = 0; i < this->worker_count; i++) {
+                    this->workers.emplace_back(&bengine::job_system::work, this, i + 1);
+                }
+            }
+            /** Keep running jobs until the system stops
+             * \param index The worker's queue
+             */
+            void work(const std::size_t index) {
+                bengine::job_system::get_thread_slot() = {this, index};
+                while (true) {
+                    if (this->run_one(index)) {
+                        continue;
+                    }
+                    std::unique_lock<std::mutex> lock(this->mutex);
+                    this->wake.wait(lock, [this]() {return this->stopping || this->queued.load(std::memory_order_acquire) > 0;});
+                    if (this->stopping) {
+                        return;
+                    }
+                }
+            }
+
+            /** Queue jobs onto a thread's queue and wake up the workers
+             * \param index The queue to add the jobs to
+             * \param jobs The jobs
+             * \param count The amount of jobs
+             */
+            void push(const std::size_t &index, const bengine::job_system::job *jobs, const std::size_t &count) {
+                {
+                    std::lock_guard<std::mutex> lock(this->queues[index]->mutex);
+                    this->queues[index]->jobs.insert(this->queues[index]->jobs.end(), jobs, jobs + count);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->queued.fetch_add(count, std::memory_order_release);
+                }
+                if (count == 1) {
+                    this->wake.notify_one();
+                } else {
+                    this->wake.notify_all();
+                }
+            }
+            /** Take a job (the newest from the thread's own queue, otherwise the oldest from another queue) and run it
+             * \param index The thread's queue
+             * \returns Whether a job was run or not
+             */
+            bool run_one(const std::size_t &index) {
+                bengine::job_system::job current;
+                bool found = false;
+                for (std::size_t i = 0; i < this->queues.size() && !found; i++) {
+                    bengine::job_system::queue &queue = *this->queues[(index + i) % this->queues.size()];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (queue.jobs.empty()) {
+                        continue;
+                    }
+                    if (i == 0) {
+                        current = queue.jobs.back();
+                        queue.jobs.pop_back();
+                    } else {
+                        current = queue.jobs.front();
+                        queue.jobs.pop_front();
+                    }
+                    found = true;
+                }
+                if (!found) {
+                    return false;
+                }
+                this->queued.fetch_sub(1, std::memory_order_relaxed);
+
+                if (this->timing.load(std::memory_order_relaxed)) {
+                    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    current.run(current.context, current.begin, current.end);
+                    this->busy_time.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+                } else {
+                    current.run(current.context, current.begin, current.end);
+                }
+                return true;
+            }
+            /** Run jobs until a counter reaches 0
+             * \param remaining The counter
+             */
+            void wait_for(const std::atomic<std::size_t> &remaining) {
+                const std::size_t index = this->get_thread_queue();
+                while (remaining.load(std::memory_order_acquire) > 0) {
+                    if (!this->run_one(index)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            template <class function_type> static void run_range(void *context, const std::size_t &begin, const std::size_t &end) {
+                bengine::job_system::range_context<function_type> *range = static_cast<bengine::job_system::range_context<function_type>*>(context);
+                (*range->function)(begin, end);
+                // nothing can touch the context after this, since the waiting thread can return as soon as it hits 0
+                range->remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            static void run_task(void *context, const std::size_t &task, const std::size_t&) {
+                bengine::job_system::graph_context *run = static_cast<bengine::job_system::graph_context*>(context);
+                bengine::task_graph::node &node = run->graph->nodes[task];
+                node.function();
+                for (std::size_t i = 0; i < node.dependents.size(); i++) {
+                    if (run->graph->waiting[node.dependents[i]].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        const bengine::job_system::job ready = {&bengine::job_system::run_task, context, node.dependents[i], 0};
+                        run->system->push(run->system->get_thread_queue(), &ready, 1);
+                    }
+                }
+                run->remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+
+        public:
+            /** bengine::job_system constructor (no threads are started until the first job comes in)
+             * \param worker_count The amount of worker threads to use alongside the thread that waits on the work (0 uses one less than the amount of cores)
+             */
+            job_system(const unsigned int &worker_count = 0) {
+                if (worker_count > 0) {
+                    this->worker_count = worker_count;
+                } else {
+                    const unsigned int cores = std::thread::hardware_concurrency();
+                    this->worker_count = cores > 1 ? cores - 1 : 0;
+                }
+                for (unsigned int i = 0; i <= this->worker_count; i++) {
+                    this->queues.emplace_back(new bengine::job_system::queue());
+                }
+            }
+            // \brief bengine::job_system deconstructor
+            ~job_system() {
+                this->shutdown();
+            }
+            job_system(const bengine::job_system&) = delete;
+            bengine::job_system& operator=(const bengine::job_system&) = delete;
+
+            // \brief Stop and join the workers (they start again if more work comes in)
+            void shutdown() {
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex);
+                    this->stopping = true;
+                }
+                this->wake.notify_all();
+                for (std::size_t i = 0; i < this->workers.size(); i++) {
+                    this->workers[i].join();
+                }
+                this->workers.clear();
+            }
+
+            /** Get the amount of threads that work on jobs (the workers plus the thread waiting on the work)
+             * \returns The amount of threads that work on jobs
+             */
+            unsigned int get_thread_count() const {
+                return this->worker_count + 1;
+            }
+
+            /** Call a function over a range of indices split into chunks across every thread, returning once every chunk is done
+             * \param begin The first index
+             * \param end One past the last index
+             * \param function Called as function(chunk_begin, chunk_end) for each chunk (from any thread, so chunks shouldn't write to anything that other chunks use)
+             * \param grain The most indices in a chunk (0 splits the range into 4 chunks per thread)
+             */
+            template <class function_type> void parallel_for(const std::size_t &begin, const std::size_t &end, const function_type &function, const std::size_t &grain = 0) {
+                if (end <= begin) {
+                    return;
+                }
+                const std::size_t count = end - begin;
+                std::size_t chunk_size = grain > 0 ? grain : (count + this->get_thread_count() * 4 - 1) / (this->get_thread_count() * 4);
+                const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+                if (chunk_count <= 1 || this->worker_count == 0) {
+                    function(begin, end);
+                    return;
+                }
+                this->start();
+
+                bengine::job_system::range_context<function_type> range;
+                range.function = &function;
+                range.remaining.store(chunk_count, std::memory_order_relaxed);
+                std::vector<bengine::job_system::job> chunks(chunk_count);
+                for (std::size_t i = 0; i < chunk_count; i++) {
+                    chunks[i] = {&bengine::job_system::run_range<function_type>, &range, begin + i * chunk_size, std::min(begin + (i + 1) * chunk_size, end)};
+                }
+                this->push(this->get_thread_queue(), chunks.data(), chunk_count);
+                this->wait_for(range.remaining);
+            }
+
+            /** Run every task in a graph (tasks start as soon as their prerequisites finish), returning once every task is done
+             * \param graph The tasks to run
+             * \returns 0 on success or -1 if the dependencies loop back on themselves (nothing is run)
+             */
+            int run(bengine::task_graph &graph) {
+                if (!graph.validate()) {
+                    std::cout << "Task graph has a dependency cycle [bengine::job_system::run]\n";
+                    return -1;
+                }
+                const std::size_t count = graph.nodes.size();
+                if (count == 0) {
+                    return 0;
+                }
+                if (graph.waiting_size != count) {
+                    graph.waiting.reset(new std::atomic<std::size_t>[count]);
+                    graph.waiting_size = count;
+                }
+                std::vector<bengine::job_system::job> roots;
+                bengine::job_system::graph_context context;
+                context.system = this;
+                context.graph = &graph;
+                context.remaining.store(count, std::memory_order_relaxed);
+                for (std::size_t i = 0; i < count; i++) {
+                    graph.waiting[i].store(graph.nodes[i].dependency_count, std::memory_order_relaxed);
+                    if (graph.nodes[i].dependency_count == 0) {
+                        roots.push_back({&bengine::job_system::run_task, &context, i, 0});
+                    }
+                }
+                this->start();
+                this->push(this->get_thread_queue(), roots.data(), roots.size());
+                this->wait_for(context.remaining);
+                return 0;
+            }
+
+            /** Set whether the time spent in jobs is measured or not (see bengine::job_system::take_busy_time())
+             * \param timing Whether the time spent in jobs is measured or not
+             */
+            void set_timing(const bool &timing) {
+                this->timing.store(timing, std::memory_order_relaxed);
+            }
+            /** Get the time spent in jobs (summed across every thread, so it can be more than the time that passed) since this was last called; a job that waits on jobs of its own also counts the time it spends helping with them
+             * \returns The time spent in jobs (ms)
+             */
+            double take_busy_time() {
+                return this->busy_time.exchange(0, std::memory_order_relaxed) / 1e6;
+            }
+    };
+}
+
+#endif // BENGINE_JOB_SYSTEM_hpp
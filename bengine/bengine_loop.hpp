@@ -1,16 +1,36 @@
 #ifndef BENGINE_LOOP_hpp
 #define BENGINE_LOOP_hpp
 
+#include "bengine_async_loader.hpp"
+#include "bengine_dirty_regions.hpp"
+#include "bengine_event_dispatcher.hpp"
+#include "bengine_event_recording.hpp"
+#include "bengine_frame_pacer.hpp"
 #include "bengine_render_window.hpp"
+#include "bengine_job_system.hpp"
+#include "bengine_profiler.hpp"
 
 namespace bengine {
     // \brief A virtual class used to contain the basic looping mechanism required to seperate rendering/computing while maintaining consistent computational behavior
     class loop {
+        public:
+            // \brief How a replay went (see bengine::loop::replay())
+            struct replay_statistics {
+                // \brief The amount of compute ticks that were run
+                unsigned long long ticks = 0;
+                // \brief The amount of events that were replayed
+                unsigned long long events = 0;
+                // \brief How long the replay took (s)
+                double seconds = 0;
+            };
+
         protected:
             // \brief How long the loop has been active (seconds)
             long double time = 0.0;
             // \brief How long each computation frame should take (in seconds)
             double delta_time = 0.01;
+            // \brief The amount of compute ticks that have happened since the loop started running (or replaying)
+            unsigned long long tick = 0;
 
             // \brief Whether the loop is running or not
             bool loop_running = true;
@@ -19,18 +39,226 @@ namespace bengine {
 
             // \brief The window that is interacted with and displays everything
             bengine::render_window window = bengine::render_window("window", 1280, 720, SDL_WINDOW_SHOWN);
-            // \brief The SDL_Event structure used to process events
+            // \brief The SDL_Event structure used to process events (holds the current event during handle_event())
             SDL_Event event;
+            // \brief Sends each frame's events to the handlers registered for their types (quitting and window events are already registered)
+            bengine::event_dispatcher events;
+            // \brief Whether handle_event() also gets called for every event (turn this off once everything is handled through the dispatcher to skip the virtual call per event)
+            bool forward_events = true;
+            // \brief Where every event is recorded to (along with the compute tick it was handled before) while recording
+            bengine::input_recorder recorder;
+            // \brief Scratch space reused for each recorded event
+            std::string recorded_payload;
+            // \brief How the last replay went
+            bengine::loop::replay_statistics replayed;
+
+            // \brief Write this frame's events to the recording, if there is one
+            void record_events() {
+                if (!this->recorder.is_open()) {
+                    return;
+                }
+                const std::vector<SDL_Event> &drained = this->events.get_events();
+                for (std::size_t i = 0; i < drained.size(); i++) {
+                    if (bengine::event_encoding::encode(drained[i], this->recorded_payload)) {
+                        this->recorder.record(this->tick, this->recorded_payload);
+                    }
+                }
+            }
+            // \brief Send the events in the dispatcher's buffer to their handlers (and to handle_event() while forwarding events)
+            void process_events() {
+                this->profiler.begin_phase(bengine::frame_profiler::phases::HANDLE_EVENT);
+                this->events.dispatch();
+                if (this->forward_events) {
+                    const std::vector<SDL_Event> &drained = this->events.get_events();
+                    for (std::size_t i = 0; i < drained.size(); i++) {
+                        this->event = drained[i];
+                        this->handle_event();
+                    }
+                }
+                this->profiler.end_phase(bengine::frame_profiler::phases::HANDLE_EVENT);
+            }
+            /** Render and present a frame if anything needs to be redrawn
+             * \returns Whether a frame was presented or not
+             */
+            bool render_frame() {
+                if (this->loader.get_pending_count() > 0 && this->loader.update(this->window.get_renderer(), this->uploads_per_frame) > 0) {
+                    this->visuals_changed = true;
+                }
+
+                if (this->use_dirty_rectangles) {
+                    // the regions are relative to the base dimensions, which are the window's dimensions when nothing is being stretched
+                    const bool stretched = this->window.is_stretching_graphics() && this->window.get_base_width() > 0 && this->window.get_base_height() > 0;
+                    this->dirty.set_bounds(stretched ? this->window.get_base_width() : this->window.get_width(), stretched ? this->window.get_base_height() : this->window.get_height());
+                    if (this->visuals_changed) {
+                        this->dirty.invalidate_all();
+                    }
+                }
+
+                if (!this->visuals_changed && !this->show_profiler_hud && !(this->use_dirty_rectangles && !this->dirty.is_empty())) {
+                    return false;
+                }
+                this->visuals_changed = false;
+                this->profiler.begin_phase(bengine::frame_profiler::phases::RENDER);
+                if (this->use_dirty_rectangles) {
+                    this->render_dirty_regions();
+                } else {
+                    this->window.clear_renderer(this->clear_color);
+                    this->render();
+                }
+                this->profiler.end_phase(bengine::frame_profiler::phases::RENDER);
+                if (this->show_profiler_hud) {
+                    this->render_profiler_hud();
+                }
+                this->profiler.begin_phase(bengine::frame_profiler::phases::PRESENT);
+                this->window.present_renderer();
+                this->profiler.end_phase(bengine::frame_profiler::phases::PRESENT);
+                return true;
+            }
+
             // \brief The state of the keyboard; good for instantaneous feedback on which keys are pressed and which aren't
             const Uint8 *keystate = SDL_GetKeyboardState(NULL);
 
-            // \brief A virtual function that will be called whenever there is an event that needs to be addressed
-            virtual void handle_event() = 0;
+            // \brief Spaces rendering frames out evenly and measures how long they take
+            bengine::frame_pacer pacer;
+            // \brief How many rendering frames to aim for each second (0 uses the refresh rate of the window's monitor)
+            double frame_rate = 0;
+
+            /** Turn vsync on or off; while it is on, presented frames are paced by the display instead of by the pacer
+             * \param vsync Whether to turn vsync on or off
+             * \returns 0 on success or a negative error code on failure (the pacer keeps pacing on its own)
+             */
+            int set_vsync(const bool &vsync) {
+                const int output = this->window.set_vsync(vsync);
+                this->pacer.set_deferring_to_vsync(vsync && output == 0);
+                return output;
+            }
+
+            // \brief Decodes images in the background; whatever it has decoded gets uploaded at the start of each rendering frame
+            bengine::async_loader loader;
+            // \brief The most images that the loader will upload each frame
+            unsigned int uploads_per_frame = 4;
+
+            // \brief Whether to only redraw the invalidated parts of a persistent backing texture (the window's dummy texture) instead of redrawing everything whenever visuals change
+            bool use_dirty_rectangles = false;
+            // \brief The parts of the backing texture that need to be redrawn (relative to the window's base dimensions, like everything drawn in render())
+            bengine::dirty_regions dirty;
+            // \brief The color that each redrawn region gets cleared to before render() is called for it
+            SDL_Color clear_color = {0, 0, 0, 255};
+
+            /** Mark a part of the window as needing to be redrawn (only matters while using dirty rectangles; otherwise the same as setting visuals_changed)
+             * \param x x-position of the region relative to the base dimensions (px) (assuming positive width and height)
+             * \param y y-position of the region relative to the base dimensions (px) (assuming positive width and height)
+             * \param w Width of the region (px) (can be negative)
+             * \param h Height of the region (px) (can be negative)
+             */
+            void invalidate(const int &x, const int &y, const int &w, const int &h) {
+                if (this->use_dirty_rectangles) {
+                    this->dirty.invalidate(x, y, w, h);
+                } else {
+                    this->visuals_changed = true;
+                }
+            }
+            /** Get whether any part of a rectangle is being redrawn this rendering frame; render() can use this to skip things that haven't changed (everything is being redrawn when not using dirty rectangles)
+             * \param x x-position of the rectangle relative to the base dimensions (px)
+             * \param y y-position of the rectangle relative to the base dimensions (px)
+             * \param w Width of the rectangle (px)
+             * \param h Height of the rectangle (px)
+             * \returns Whether any part of the rectangle is being redrawn
+             */
+            bool is_region_dirty(const int &x, const int &y, const int &w, const int &h) const {
+                if (!this->use_dirty_rectangles) {
+                    return true;
+                }
+                if (this->redraw_region == NULL) {
+                    return this->dirty.intersects(x, y, w, h);
+                }
+                const SDL_Rect rect = {w < 0 ? x + w : x, h < 0 ? y + h : y, w < 0 ? -w : w, h < 0 ? -h : h};
+                return SDL_HasIntersection(&rect, this->redraw_region);
+            }
+
+            // \brief Per-phase timings of the loop (disabled by default, see bengine::frame_profiler::enable())
+            bengine::frame_profiler profiler;
+            // \brief Spreads work inside of compute() across every core with parallel_for() and task graphs (no threads are started until it is first used); the time spent in its jobs is profiled as the jobs phase
+            bengine::job_system jobs;
+            // \brief Finish the profiler's frame, adding the time spent in jobs during it
+            void end_profiler_frame() {
+                this->profiler.add_to_phase(bengine::frame_profiler::phases::JOBS, this->jobs.take_busy_time());
+                this->jobs.set_timing(this->profiler.is_enabled());
+                this->profiler.end_frame();
+            }
+            // \brief Whether to draw the profiler's statistics over the top-left corner of the window each frame or not (forces a full render every frame while shown)
+            bool show_profiler_hud = false;
+
+            // \brief A virtual function that will be called whenever there is an event that needs to be addressed (while forward_events is set; the event is in this->event)
+            virtual void handle_event() {}
             // \brief A virtual function that will be called each computation frame to handle any non-rendering-related tasks
             virtual void compute() = 0;
             // \brief A virtual function that will be called each rendering frame to handle all of the rendering-related tasks
             virtual void render() = 0;
 
+            // \brief The region currently being redrawn (NULL outside of a dirty rectangle pass)
+            const SDL_Rect *redraw_region = NULL;
+            // \brief The regions being redrawn this rendering frame (copied out of dirty first so that render() can invalidate regions for the next frame while they are being redrawn)
+            std::vector<SDL_Rect> redraw_regions;
+            // \brief The size of the backing texture, which gets recreated whenever the window changes size
+            int backing_width = 0;
+            int backing_height = 0;
+
+            // \brief Redraw whatever has been invalidated onto the backing texture and then copy it to the window
+            void render_dirty_regions() {
+                if (this->backing_width != this->window.get_width() || this->backing_height != this->window.get_height() || !this->window.has_dummy()) {
+                    if (this->window.initialize_dummy(this->window.get_width(), this->window.get_height()) != 0) {
+                        // without a backing texture the best that can be done is a full redraw
+                        this->window.clear_renderer(this->clear_color);
+                        this->render();
+                        return;
+                    }
+                    this->backing_width = this->window.get_width();
+                    this->backing_height = this->window.get_height();
+                    this->dirty.invalidate_all();
+                }
+
+                this->redraw_regions.assign(this->dirty.get_regions().begin(), this->dirty.get_regions().end());
+                this->dirty.clear();
+                this->window.target_renderer_at_dummy();
+                for (std::size_t i = 0; i < this->redraw_regions.size(); i++) {
+                    const SDL_Rect &region = this->redraw_regions[i];
+                    this->redraw_region = &region;
+                    this->window.set_clip_rectangle(region.x, region.y, region.w, region.h);
+                    this->window.clear_renderer(this->clear_color);
+                    this->render();
+                }
+                this->redraw_region = NULL;
+                this->window.target_renderer_at_window();
+                this->window.render_dummy();
+            }
+
+            /** Draw the profiler's statistics as a bar graph over the top-left corner of the window
+             * 
+             * Each phase gets a row where the bar's length is relative to the time available for one frame at the window's refresh rate; the teal, light gray, and dark gray segments represent p50, p95, and p99 and the red mark represents the maximum
+             */
+            void render_profiler_hud() {
+                const int bar_width = 200;
+                const int bar_height = 8;
+                const double frame_budget = 1000.0 / this->window.get_refresh_rate();
+
+                this->window.fill_rectangle(0, 0, bar_width + 8, (bar_height + 4) * bengine::frame_profiler::phase_count + 4, {0, 0, 0, 255});
+                for (unsigned char i = 0; i < bengine::frame_profiler::phase_count; i++) {
+                    const bengine::frame_profiler::phase_statistics stats = this->profiler.get_statistics(static_cast<bengine::frame_profiler::phases>(i));
+                    const int y = 4 + i * (bar_height + 4);
+                    const int p50 = std::min<double>(stats.p50 / frame_budget, 1.0) * bar_width;
+                    const int p95 = std::min<double>(stats.p95 / frame_budget, 1.0) * bar_width;
+                    const int p99 = std::min<double>(stats.p99 / frame_budget, 1.0) * bar_width;
+                    const int max = std::min<double>(stats.max / frame_budget, 1.0) * bar_width;
+
+                    this->window.fill_rectangle(4, y, bar_width, bar_height, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::DARK_GRAY));
+                    this->window.fill_rectangle(4, y, p99, bar_height, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::LIGHT_GRAY));
+                    this->window.fill_rectangle(4, y, p95, bar_height, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE));
+                    this->window.fill_rectangle(4, y, p50, bar_height, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::TEAL));
+                    this->window.fill_rectangle(4 + (max > 0 ? max - 1 : 0), y, 2, bar_height, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::RED));
+                }
+            }
+
         public:
             /** bengine::loop constructor; mainly creates the window that will be used
              * \param title The title of the window being created
@@ -59,9 +287,18 @@ namespace bengine {
                 this->window.set_base_height(height);
 
                 SDL_StopTextInput();
+
+                this->events.on(SDL_QUIT, [this](const SDL_Event&) {this->loop_running = false;});
+                this->events.on_window([this](const SDL_WindowEvent &event) {
+                    this->window.handle_event(event);
+                    this->visuals_changed = true;
+                });
             }
             // \brief bengine::loop deconstructor; pretty much just handles some SDL cleanup
             ~loop() {
+                this->stop_recording();
+                // the workers could still be using SDL_image
+                this->loader.shutdown();
                 TTF_Quit();
                 IMG_Quit();
                 SDL_Quit();
@@ -71,51 +308,163 @@ namespace bengine {
              * \returns 0 (anything additional hasn't been added yet)
              */
             int run() {
-                Uint32 start_ticks = 0;
-                Uint32 frame_ticks = 0;
-                long double current_time = SDL_GetTicks() * 0.01;
+                this->pacer.set_target_rate(this->frame_rate > 0 ? this->frame_rate : this->window.get_refresh_rate());
+                this->pacer.reset();
+                long double current_time = this->pacer.now();
                 long double new_time = 0.0;
                 double frame_time = 0.0;
                 double accumulator = 0.0;
+                bool presented = false;
+                this->tick = 0;
 
                 while (this->loop_running) {
-                    start_ticks = SDL_GetTicks();
-                    new_time = SDL_GetTicks() * 0.01;
+                    new_time = this->pacer.now();
                     frame_time = new_time - current_time;
                     current_time = new_time;
                     accumulator += frame_time;
+                    this->profiler.begin_frame();
+
+                    // every event gets drained and dispatched once per frame rather than once per computation frame
+                    if (this->events.drain() > 0) {
+                        this->record_events();
+                        this->process_events();
+                    }
 
                     while (accumulator >= this->delta_time) {
-                        while (SDL_PollEvent(&this->event)) {
-                            switch (this->event.type) {
-                                case SDL_QUIT:
-                                    this->loop_running = false;
-                                    break;
-                                case SDL_WINDOWEVENT:
-                                    this->window.handle_event(this->event.window);
-                                    this->visuals_changed = true;
-                                    break;
-                            }
-                            this->handle_event();
-                        }
+                        this->profiler.begin_phase(bengine::frame_profiler::phases::COMPUTE);
                         this->compute();
+                        this->profiler.end_phase(bengine::frame_profiler::phases::COMPUTE);
                         this->time += this->delta_time;
+                        this->tick++;
                         accumulator -= this->delta_time;
                     }
 
-                    if (this->visuals_changed) {
-                        this->visuals_changed = false;
-                        this->window.clear_renderer();
-                        this->render();
-                        this->window.present_renderer();
+                    presented = this->render_frame();
+                    this->end_profiler_frame();
+
+                    this->pacer.wait(presented);
+                }
+
+                this->stop_recording();
+                if (!this->profiler.get_csv_path().empty()) {
+                    this->profiler.dump_csv();
+                }
+                return 0;
+            }
+
+            /** Run a set amount of frames as fast as possible without any pacing; each frame handles the events that came in, computes once (advancing time by delta_time), and renders if anything needs to be redrawn
+             * \param frames The amount of frames to run
+             * \returns The amount of frames that were run (less than requested if loop_running was set to false)
+             */
+            unsigned long long run_frames(const unsigned long long &frames) {
+                unsigned long long frame = 0;
+                for (; frame < frames && this->loop_running; frame++) {
+                    this->profiler.begin_frame();
+
+                    if (this->events.drain() > 0) {
+                        this->record_events();
+                        this->process_events();
                     }
+                    this->profiler.begin_phase(bengine::frame_profiler::phases::COMPUTE);
+                    this->compute();
+                    this->profiler.end_phase(bengine::frame_profiler::phases::COMPUTE);
+                    this->time += this->delta_time;
+                    this->tick++;
 
-                    if ((frame_ticks = SDL_GetTicks() - start_ticks) < (Uint32)(1000 / this->window.get_refresh_rate())) {
-                        SDL_Delay(1000 / this->window.get_refresh_rate() - frame_ticks);
+                    this->render_frame();
+                    this->end_profiler_frame();
+                }
+                return frame;
+            }
+
+            /** Start recording every SDL_Event along with the compute tick it was handled before; the recording is finished when run() returns (or by stop_recording())
+             * \param path The path of the file to record to
+             * \returns 0 on success or -1 if the file couldn't be opened
+             */
+            int start_recording(const std::string &path) {
+                return this->recorder.open(path);
+            }
+            // \brief Finish the current recording, if there is one
+            void stop_recording() {
+                this->recorder.close(this->tick);
+            }
+            /** Get whether events are being recorded or not
+             * \returns Whether events are being recorded or not
+             */
+            bool is_recording() const {
+                return this->recorder.is_open();
+            }
+
+            /** Run a recorded session again as fast as possible: every recorded event is handled right before the same compute tick it was handled before originally, and compute() runs once per tick without waiting, for exactly as many ticks as the session lasted (or until loop_running is set to false, like by a replayed quit)
+             * 
+             * As long as compute() and the event handlers only depend on the events and the tick (not on wall-clock time, SDL_GetKeyboardState(), or randomness that isn't seeded), the replay ends up in the same state as the original session, which makes it good for benchmarking simulation throughput and bisecting performance regressions
+             * 
+             * \param path The path of the recording (made by start_recording())
+             * \param render Whether to render a frame after every tick that changes the visuals (false measures computing alone)
+             * \param push_events Whether to send events through SDL's queue with SDL_PushEvent (exercising the same path as live events, along with any real events that come in) instead of handing them straight to the dispatcher
+             * \returns 0 on success or -1 if the recording couldn't be read
+             */
+            int replay(const std::string &path, const bool &render = false, const bool &push_events = false) {
+                bengine::input_replayer replayer;
+                if (replayer.open(path) != 0) {
+                    return -1;
+                }
+                this->replayed = bengine::loop::replay_statistics();
+                this->loop_running = true;
+                this->time = 0.0;
+                this->tick = 0;
+                std::vector<SDL_Event> tick_events;
+                const char *payload;
+                std::size_t size;
+                SDL_Event current;
+
+                const double start = this->pacer.now();
+                while (this->loop_running) {
+                    this->profiler.begin_frame();
+                    tick_events.clear();
+                    while (replayer.read(this->tick, payload, size)) {
+                        if (bengine::event_encoding::decode(payload, size, current)) {
+                            tick_events.push_back(current);
+                        }
+                    }
+                    if (push_events) {
+                        for (std::size_t i = 0; i < tick_events.size(); i++) {
+                            SDL_PushEvent(&tick_events[i]);
+                        }
+                        this->events.drain();
+                    } else {
+                        this->events.load(tick_events.data(), tick_events.size());
+                    }
+                    if (!this->events.get_events().empty()) {
+                        this->replayed.events += tick_events.size();
+                        this->process_events();
                     }
+                    // events recorded when the session ended were handled without a compute tick after them
+                    if (this->tick >= replayer.get_final_tick()) {
+                        this->end_profiler_frame();
+                        break;
+                    }
+
+                    this->profiler.begin_phase(bengine::frame_profiler::phases::COMPUTE);
+                    this->compute();
+                    this->profiler.end_phase(bengine::frame_profiler::phases::COMPUTE);
+                    this->time += this->delta_time;
+                    this->tick++;
+                    if (render) {
+                        this->render_frame();
+                    }
+                    this->end_profiler_frame();
                 }
+                this->replayed.ticks = this->tick;
+                this->replayed.seconds = this->pacer.now() - start;
                 return 0;
             }
+            /** Get how the last replay went
+             * \returns The amount of ticks and events replayed and how long it took
+             */
+            bengine::loop::replay_statistics get_replay_statistics() const {
+                return this->replayed;
+            }
     };
 }
 
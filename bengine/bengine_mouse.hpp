@@ -4,6 +4,7 @@
 #include <SDL2/SDL.h>
 #include <iostream>
 #include <cmath>
+#include <vector>
 
 #include "bengine_helpers.hpp"
 #include "bengine_render_window.hpp"
@@ -690,6 +691,217 @@ namespace bengine {
                 return mstate.pressed(button) ? this->check_position(mstate) : __LONG_LONG_MAX__;
             }
     };
+
+    /** Keeps lots of click rectangles in a bengine::uniform_grid_index so that finding the one under the mouse only looks at the rectangles sharing its grid cell (instead of checking every rectangle on every mouse motion)
+     * Also keeps track of which rectangle is hovered, producing enter/leave events only when that changes (including when rectangles are added, moved, or removed under a still mouse)
+     * Rectangles are half-open here (a rectangle at x = 0 with a width of 10 covers x = 0 through 9), so that neighboring cells of a board never both claim the same pixel
+     */
+    class click_region_index {
+        public:
+            // \brief What happened to a region
+            enum class event_type : unsigned char {
+                // \brief The mouse moved onto the region
+                ENTER = 0,
+                // \brief The mouse moved off of the region (or it was moved/removed from under the mouse)
+                LEAVE = 1
+            };
+            // \brief A change in which region is hovered
+            struct event {
+                bengine::click_region_index::event_type type = bengine::click_region_index::event_type::ENTER;
+                int id = -1;
+            };
+
+        private:
+            bengine::uniform_grid_index index;
+            // \brief The region under the mouse (-1 if there isn't one)
+            int hovered = -1;
+            // \brief Whether the mouse is somewhere the index knows about (false before the first update and after the mouse leaves the window)
+            bool has_mouse = false;
+            int mouse_x = 0;
+            int mouse_y = 0;
+            // \brief Enter/leave events since the last update (reused between updates)
+            std::vector<bengine::click_region_index::event> events;
+
+            /** Change the hovered region, adding the events for it
+             * \param region The new hovered region (-1 for none)
+             * \returns Whether the hovered region changed or not
+             */
+            bool set_hovered(const int &region) {
+                if (region == this->hovered) {
+                    return false;
+                }
+                if (this->hovered != -1) {
+                    this->events.push_back({bengine::click_region_index::event_type::LEAVE, this->hovered});
+                }
+                if (region != -1) {
+                    this->events.push_back({bengine::click_region_index::event_type::ENTER, region});
+                }
+                this->hovered = region;
+                return true;
+            }
+            // \brief Find the hovered region again after the regions change (a region might have moved under or away from a still mouse)
+            void refresh() {
+                this->set_hovered(this->has_mouse ? this->index.query_point(this->mouse_x, this->mouse_y) : -1);
+            }
+
+        public:
+            /** bengine::click_region_index constructor
+             * \param width Width of the area that regions can be found in (usually the window's width)
+             * \param height Height of the area that regions can be found in (usually the window's height)
+             * \param cell_size The width and height of each grid cell; around the size of a typical region works best
+             */
+            click_region_index(const int &width = 0, const int &height = 0, const int &cell_size = 32) : index(width, height, cell_size) {}
+            // \brief bengine::click_region_index deconstructor
+            ~click_region_index() {}
+
+            /** Change the area that regions can be found in, keeping every region
+             * \param width The new width
+             * \param height The new height
+             */
+            void resize(const int &width, const int &height) {
+                this->index.resize(width, height);
+                this->refresh();
+            }
+            /** Get the width of the area that regions can be found in
+             * \returns The width of the area that regions can be found in
+             */
+            int get_width() const {
+                return this->index.get_width();
+            }
+            /** Get the height of the area that regions can be found in
+             * \returns The height of the area that regions can be found in
+             */
+            int get_height() const {
+                return this->index.get_height();
+            }
+
+            /** Add a region
+             * \param x x-position of the region's top-left corner
+             * \param y y-position of the region's top-left corner
+             * \param width Width of the region
+             * \param height Height of the region
+             * \returns The id of the region (ids of removed regions get reused); later regions sit on top of earlier ones
+             */
+            int insert(const int &x, const int &y, const int &width, const int &height) {
+                const int output = this->index.insert(x, y, width, height);
+                this->refresh();
+                return output;
+            }
+            /** Add a region
+             * \param rect The rectangle covered by the region
+             * \returns The id of the region (ids of removed regions get reused); later regions sit on top of earlier ones
+             */
+            int insert(const bengine::click_rectangle &rect) {
+                return this->insert(rect.get_x_pos(), rect.get_y_pos(), rect.get_width(), rect.get_height());
+            }
+            /** Move/resize a region, putting it on top of every other region
+             * \param id The id of the region
+             * \param x The new x-position of the region's top-left corner
+             * \param y The new y-position of the region's top-left corner
+             * \param width The new width of the region
+             * \param height The new height of the region
+             * \returns 0 on success or -1 if there is no region with the given id
+             */
+            int move(const int &id, const int &x, const int &y, const int &width, const int &height) {
+                const int output = this->index.move(id, x, y, width, height);
+                this->refresh();
+                return output;
+            }
+            /** Move/resize a region, putting it on top of every other region
+             * \param id The id of the region
+             * \param rect The new rectangle covered by the region
+             * \returns 0 on success or -1 if there is no region with the given id
+             */
+            int move(const int &id, const bengine::click_rectangle &rect) {
+                return this->move(id, rect.get_x_pos(), rect.get_y_pos(), rect.get_width(), rect.get_height());
+            }
+            /** Remove a region (a leave event is added if it was hovered)
+             * \param id The id of the region
+             * \returns 0 on success or -1 if there is no region with the given id
+             */
+            int remove(const int &id) {
+                const int output = this->index.remove(id);
+                this->refresh();
+                return output;
+            }
+            // \brief Remove every region
+            void clear() {
+                this->index.clear();
+                this->refresh();
+            }
+            /** Check whether there is a region with the given id or not
+             * \param id The id to check
+             * \returns Whether there is a region with the given id or not
+             */
+            bool contains(const int &id) const {
+                return this->index.contains(id);
+            }
+
+            /** Find the top-most region covering a point
+             * \param x x-position of the point
+             * \param y y-position of the point
+             * \returns The id of the region, or -1 if there isn't one
+             */
+            int find(const int &x, const int &y) const {
+                return this->index.query_point(x, y);
+            }
+
+            /** Move the mouse, finding the hovered region again
+             * \param x x-position of the mouse
+             * \param y y-position of the mouse
+             * \returns Whether the hovered region changed or not (see get_events())
+             */
+            bool update(const int &x, const int &y) {
+                this->events.clear();
+                this->has_mouse = true;
+                this->mouse_x = x;
+                this->mouse_y = y;
+                return this->set_hovered(this->index.query_point(x, y));
+            }
+            /** Move the mouse to a mouse state's position, finding the hovered region again
+             * \param mstate The mouse's state
+             * \returns Whether the hovered region changed or not (see get_events())
+             */
+            bool update(const bengine::generic_mouse_state &mstate) {
+                return this->update(mstate.get_x_pos(), mstate.get_y_pos());
+            }
+            /** Do a general update based on SDL_Events (mouse motion moves the mouse and leaving the window stops hovering anything)
+             * \param event The SDL_Event used to update the hovered region
+             * \returns Whether the hovered region changed or not (see get_events())
+             */
+            bool update_general(const SDL_Event &event) {
+                if (event.type == SDL_MOUSEMOTION) {
+                    return this->update(event.motion.x, event.motion.y);
+                }
+                if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_LEAVE) {
+                    this->events.clear();
+                    this->has_mouse = false;
+                    return this->set_hovered(-1);
+                }
+                return false;
+            }
+
+            /** Get the region under the mouse
+             * \returns The id of the hovered region, or -1 if there isn't one
+             */
+            int get_hovered() const {
+                return this->hovered;
+            }
+            /** Get the enter/leave events since the last update (along with any caused by changing regions after it)
+             * \returns The events in the order they happened
+             */
+            const std::vector<bengine::click_region_index::event>& get_events() const {
+                return this->events;
+            }
+            /** Find the hovered region if the mouse has the correct buttons pressed
+             * \param mstate The mouse's state
+             * \param buttons Which buttons to check for (OR'd together from bengine::base_mouse_state::button_names)
+             * \returns The id of the hovered region if the buttons are pressed, or -1 otherwise
+             */
+            int check_button(const bengine::generic_mouse_state &mstate, const bengine::generic_mouse_state::button_names &buttons) const {
+                return mstate.pressed(buttons) ? this->hovered : -1;
+            }
+    };
 }
 
 #endif // BENGINE_MOUSE_hpp
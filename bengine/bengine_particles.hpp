@@ -0,0 +1,387 @@
+#ifndef BENGINE_PARTICLES_hpp
+#define BENGINE_PARTICLES_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) && !defined(BENGINE_PARTICLES_SCALAR)
+#include <immintrin.h>
+#elif defined(__SSE2__) && !defined(BENGINE_PARTICLES_SCALAR)
+#include <emmintrin.h>
+#endif
+
+namespace bengine {
+    /** A pool of point particles kept as structure-of-arrays float buffers (one buffer per field instead of one bengine::physics_object_2d per particle) so that whole effects get stepped 8 (AVX2) or 4 (SSE2) particles at a time
+     * Particles are only referred to by index, and indices change whenever particles die (the last particle gets moved into each dead particle's place)
+     * Every path does the same float math in the same order whether it runs through AVX2, SSE2, or plain C++ (define BENGINE_PARTICLES_SCALAR to force the latter), so effects play out the same on every machine as long as the compiler isn't fusing multiplies and adds (-ffp-contract=off when building with -mfma)
+     * Rendered through bengine::render_window::render_particles() or bengine::curses_window::write_particles()
+     */
+    class particle_system {
+        public:
+            // \brief Everything that a particle starts out with
+            struct particle {
+                float x_pos = 0;
+                float y_pos = 0;
+                float x_vel = 0;
+                float y_vel = 0;
+                // \brief Constant acceleration of this particle alone (on top of the system's gravity)
+                float x_acl = 0;
+                float y_acl = 0;
+                // \brief How much forces move the particle (0 makes it ignore forces)
+                float mass = 1;
+                // \brief How long the particle lives (s)
+                float lifetime = 1;
+                // \brief The color of the particle as 0xAARRGGBB
+                std::uint32_t color = 0xFFFFFFFF;
+            };
+
+        private:
+            std::vector<float> x_pos;
+            std::vector<float> y_pos;
+            std::vector<float> x_vel;
+            std::vector<float> y_vel;
+            std::vector<float> x_acl;
+            std::vector<float> y_acl;
+            // \brief Forces applied since the last integration (cleared by every integration)
+            std::vector<float> x_frc;
+            std::vector<float> y_frc;
+            // \brief 1 / mass, so that integrating doesn't divide
+            std::vector<float> inverse_mass;
+            // \brief How long each particle has been alive (s)
+            std::vector<float> age;
+            std::vector<float> lifetime;
+            std::vector<std::uint32_t> colors;
+
+            // \brief The amount of live particles (the buffers can be bigger)
+            std::size_t count = 0;
+            // \brief The most particles that can be alive at once
+            std::size_t max_particles = 131072;
+
+            // \brief Acceleration applied to every particle (px/s^2)
+            float x_gravity = 0;
+            float y_gravity = 0;
+            // \brief The fraction of velocity lost each second
+            float drag = 0;
+
+            /** Resize every buffer
+             * \param size The new size of the buffers
+             */
+            void resize_buffers(const std::size_t &size) {
+                this->x_pos.resize(size);
+                this->y_pos.resize(size);
+                this->x_vel.resize(size);
+                this->y_vel.resize(size);
+                this->x_acl.resize(size);
+                this->y_acl.resize(size);
+                this->x_frc.resize(size);
+                this->y_frc.resize(size);
+                this->inverse_mass.resize(size);
+                this->age.resize(size);
+                this->lifetime.resize(size);
+                this->colors.resize(size);
+            }
+            /** Copy one particle over another
+             * \param from The index of the particle to copy
+             * \param to The index of the particle to overwrite
+             */
+            void move_particle(const std::size_t &from, const std::size_t &to) {
+                this->x_pos[to] = this->x_pos[from];
+                this->y_pos[to] = this->y_pos[from];
+                this->x_vel[to] = this->x_vel[from];
+                this->y_vel[to] = this->y_vel[from];
+                this->x_acl[to] = this->x_acl[from];
+                this->y_acl[to] = this->y_acl[from];
+                this->x_frc[to] = this->x_frc[from];
+                this->y_frc[to] = this->y_frc[from];
+                this->inverse_mass[to] = this->inverse_mass[from];
+                this->age[to] = this->age[from];
+                this->lifetime[to] = this->lifetime[from];
+                this->colors[to] = this->colors[from];
+            }
+
+        public:
+            // \brief bengine::particle_system constructor
+            particle_system() {}
+            // \brief bengine::particle_system deconstructor
+            ~particle_system() {}
+
+            /** Make room for a number of particles ahead of time (so that emitting doesn't have to grow the buffers)
+             * \param count The amount of particles to make room for
+             */
+            void reserve(const std::size_t &count) {
+                if (count > this->x_pos.size()) {
+                    this->resize_buffers(count);
+                }
+            }
+            // \brief Kill every particle (the buffers are kept)
+            void clear() {
+                this->count = 0;
+            }
+
+            /** Get the amount of live particles
+             * \returns The amount of live particles
+             */
+            std::size_t get_count() const {
+                return this->count;
+            }
+            /** Get the most particles that can be alive at once
+             * \returns The most particles that can be alive at once
+             */
+            std::size_t get_max_particles() const {
+                return this->max_particles;
+            }
+            /** Set the most particles that can be alive at once (the newest particles are killed if there are more than that already)
+             * \param max_particles The most particles that can be alive at once
+             */
+            void set_max_particles(const std::size_t &max_particles) {
+                this->max_particles = max_particles;
+                if (this->count > max_particles) {
+                    this->count = max_particles;
+                }
+            }
+
+            /** Get the acceleration applied to every particle
+             * \returns The acceleration applied to every particle as {x, y} (px/s^2)
+             */
+            std::pair<float, float> get_gravity() const {
+                return {this->x_gravity, this->y_gravity};
+            }
+            /** Set the acceleration applied to every particle
+             * \param x_gravity Horizontal acceleration (px/s^2)
+             * \param y_gravity Vertical acceleration (px/s^2) (positive is down)
+             */
+            void set_gravity(const float &x_gravity, const float &y_gravity) {
+                this->x_gravity = x_gravity;
+                this->y_gravity = y_gravity;
+            }
+            /** Get the fraction of velocity that particles lose each second
+             * \returns The fraction of velocity that particles lose each second
+             */
+            float get_drag() const {
+                return this->drag;
+            }
+            /** Set the fraction of velocity that particles lose each second
+             * \param drag The fraction of velocity that particles lose each second (0 for none)
+             */
+            void set_drag(const float &drag) {
+                this->drag = drag;
+            }
+
+            /** Add a particle
+             * \param particle What the particle starts out with
+             * \returns Whether the particle was added or not (it isn't when there are already max_particles)
+             */
+            bool emit(const bengine::particle_system::particle &particle) {
+                if (this->count >= this->max_particles) {
+                    return false;
+                }
+                if (this->count == this->x_pos.size()) {
+                    this->resize_buffers(this->count < 512 ? 1024 : (this->count * 2 < this->max_particles ? this->count * 2 : this->max_particles));
+                }
+                const std::size_t i = this->count++;
+                this->x_pos[i] = particle.x_pos;
+                this->y_pos[i] = particle.y_pos;
+                this->x_vel[i] = particle.x_vel;
+                this->y_vel[i] = particle.y_vel;
+                this->x_acl[i] = particle.x_acl;
+                this->y_acl[i] = particle.y_acl;
+                this->x_frc[i] = 0;
+                this->y_frc[i] = 0;
+                this->inverse_mass[i] = particle.mass > 0 ? 1 / particle.mass : 0;
+                this->age[i] = 0;
+                this->lifetime[i] = particle.lifetime;
+                this->colors[i] = particle.color;
+                return true;
+            }
+            /** Get a live particle
+             * \param index The index of the particle
+             * \returns What the particle is like right now (its lifetime is what remains of it)
+             */
+            bengine::particle_system::particle get_particle(const std::size_t &index) const {
+                bengine::particle_system::particle output;
+                if (index >= this->count) {
+                    return output;
+                }
+                output.x_pos = this->x_pos[index];
+                output.y_pos = this->y_pos[index];
+                output.x_vel = this->x_vel[index];
+                output.y_vel = this->y_vel[index];
+                output.x_acl = this->x_acl[index];
+                output.y_acl = this->y_acl[index];
+                output.mass = this->inverse_mass[index] > 0 ? 1 / this->inverse_mass[index] : 0;
+                output.lifetime = this->lifetime[index] - this->age[index];
+                output.color = this->colors[index];
+                return output;
+            }
+
+            /** Apply a force to every particle until the next integration
+             * \param x_frc Horizontal force
+             * \param y_frc Vertical force
+             */
+            void apply_force(const float &x_frc, const float &y_frc) {
+                for (std::size_t i = 0; i < this->count; i++) {
+                    this->x_frc[i] += x_frc;
+                    this->y_frc[i] += y_frc;
+                }
+            }
+            /** Apply a force to a single particle until the next integration
+             * \param index The index of the particle
+             * \param x_frc Horizontal force
+             * \param y_frc Vertical force
+             */
+            void apply_force(const std::size_t &index, const float &x_frc, const float &y_frc) {
+                if (index < this->count) {
+                    this->x_frc[index] += x_frc;
+                    this->y_frc[index] += y_frc;
+                }
+            }
+
+            /** Move every particle forward in time (semi-implicit Euler: velocity first, then position with the new velocity) and clear their forces
+             * \param dt How much time passes (s)
+             */
+            void integrate(const float &dt) {
+                const float damping = this->drag * dt < 1 ? 1 - this->drag * dt : 0;
+                float *x_pos = this->x_pos.data(), *y_pos = this->y_pos.data(), *x_vel = this->x_vel.data(), *y_vel = this->y_vel.data();
+                float *x_frc = this->x_frc.data(), *y_frc = this->y_frc.data();
+                const float *x_acl = this->x_acl.data(), *y_acl = this->y_acl.data(), *inverse_mass = this->inverse_mass.data();
+                std::size_t i = 0;
+#if defined(__AVX2__) && !defined(BENGINE_PARTICLES_SCALAR)
+                const __m256 t = _mm256_set1_ps(dt), d = _mm256_set1_ps(damping), gx = _mm256_set1_ps(this->x_gravity), gy = _mm256_set1_ps(this->y_gravity), zero = _mm256_setzero_ps();
+                for (; i + 8 <= this->count; i += 8) {
+                    const __m256 m = _mm256_loadu_ps(inverse_mass + i);
+                    const __m256 vx = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(x_vel + i), _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_loadu_ps(x_acl + i), _mm256_mul_ps(_mm256_loadu_ps(x_frc + i), m)), gx), t)), d);
+                    const __m256 vy = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(y_vel + i), _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_loadu_ps(y_acl + i), _mm256_mul_ps(_mm256_loadu_ps(y_frc + i), m)), gy), t)), d);
+                    _mm256_storeu_ps(x_vel + i, vx);
+                    _mm256_storeu_ps(y_vel + i, vy);
+                    _mm256_storeu_ps(x_pos + i, _mm256_add_ps(_mm256_loadu_ps(x_pos + i), _mm256_mul_ps(vx, t)));
+                    _mm256_storeu_ps(y_pos + i, _mm256_add_ps(_mm256_loadu_ps(y_pos + i), _mm256_mul_ps(vy, t)));
+                    _mm256_storeu_ps(x_frc + i, zero);
+                    _mm256_storeu_ps(y_frc + i, zero);
+                }
+#elif defined(__SSE2__) && !defined(BENGINE_PARTICLES_SCALAR)
+                const __m128 t = _mm_set1_ps(dt), d = _mm_set1_ps(damping), gx = _mm_set1_ps(this->x_gravity), gy = _mm_set1_ps(this->y_gravity), zero = _mm_setzero_ps();
+                for (; i + 4 <= this->count; i += 4) {
+                    const __m128 m = _mm_loadu_ps(inverse_mass + i);
+                    const __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(x_vel + i), _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_loadu_ps(x_acl + i), _mm_mul_ps(_mm_loadu_ps(x_frc + i), m)), gx), t)), d);
+                    const __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(y_vel + i), _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_loadu_ps(y_acl + i), _mm_mul_ps(_mm_loadu_ps(y_frc + i), m)), gy), t)), d);
+                    _mm_storeu_ps(x_vel + i, vx);
+                    _mm_storeu_ps(y_vel + i, vy);
+                    _mm_storeu_ps(x_pos + i, _mm_add_ps(_mm_loadu_ps(x_pos + i), _mm_mul_ps(vx, t)));
+                    _mm_storeu_ps(y_pos + i, _mm_add_ps(_mm_loadu_ps(y_pos + i), _mm_mul_ps(vy, t)));
+                    _mm_storeu_ps(x_frc + i, zero);
+                    _mm_storeu_ps(y_frc + i, zero);
+                }
+#endif
+                for (; i < this->count; i++) {
+                    x_vel[i] = (x_vel[i] + ((x_acl[i] + x_frc[i] * inverse_mass[i]) + this->x_gravity) * dt) * damping;
+                    y_vel[i] = (y_vel[i] + ((y_acl[i] + y_frc[i] * inverse_mass[i]) + this->y_gravity) * dt) * damping;
+                    x_pos[i] = x_pos[i] + x_vel[i] * dt;
+                    y_pos[i] = y_pos[i] + y_vel[i] * dt;
+                    x_frc[i] = 0;
+                    y_frc[i] = 0;
+                }
+            }
+            /** Make every particle older
+             * \param dt How much time passes (s)
+             */
+            void age_particles(const float &dt) {
+                float *age = this->age.data();
+                std::size_t i = 0;
+#if defined(__AVX2__) && !defined(BENGINE_PARTICLES_SCALAR)
+                const __m256 t = _mm256_set1_ps(dt);
+                for (; i + 8 <= this->count; i += 8) {
+                    _mm256_storeu_ps(age + i, _mm256_add_ps(_mm256_loadu_ps(age + i), t));
+                }
+#elif defined(__SSE2__) && !defined(BENGINE_PARTICLES_SCALAR)
+                const __m128 t = _mm_set1_ps(dt);
+                for (; i + 4 <= this->count; i += 4) {
+                    _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), t));
+                }
+#endif
+                for (; i < this->count; i++) {
+                    age[i] += dt;
+                }
+            }
+            /** Remove every particle that has outlived its lifetime by moving the last particle into its place (so the buffers stay packed without shifting anything)
+             * \returns The amount of particles that were removed
+             */
+            std::size_t kill_particles() {
+                const std::size_t previous_count = this->count;
+                std::size_t i = 0;
+                while (i < this->count) {
+                    // skip over whole vectors of live particles, which is most of them on any given tick
+#if defined(__AVX2__) && !defined(BENGINE_PARTICLES_SCALAR)
+                    for (; i + 8 <= this->count && _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(this->age.data() + i), _mm256_loadu_ps(this->lifetime.data() + i), _CMP_GE_OQ)) == 0; i += 8);
+#elif defined(__SSE2__) && !defined(BENGINE_PARTICLES_SCALAR)
+                    for (; i + 4 <= this->count && _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(this->age.data() + i), _mm_loadu_ps(this->lifetime.data() + i))) == 0; i += 4);
+#endif
+                    if (i >= this->count) {
+                        break;
+                    }
+                    if (this->age[i] >= this->lifetime[i]) {
+                        // the particle moved in could be dead too, so i gets checked again
+                        this->move_particle(--this->count, i);
+                    } else {
+                        i++;
+                    }
+                }
+                return previous_count - this->count;
+            }
+            /** Integrate, age, and kill every particle
+             * \param dt How much time passes (s)
+             * \returns The amount of particles that died
+             */
+            std::size_t update(const float &dt) {
+                this->integrate(dt);
+                this->age_particles(dt);
+                return this->kill_particles();
+            }
+
+            /** Get the x-positions of the live particles (px)
+             * \returns The x-positions of the live particles (px) (get_count() of them; emitting can move the buffer)
+             */
+            const float* get_x_positions() const {
+                return this->x_pos.data();
+            }
+            /** Get the y-positions of the live particles (px)
+             * \returns The y-positions of the live particles (px) (get_count() of them; emitting can move the buffer)
+             */
+            const float* get_y_positions() const {
+                return this->y_pos.data();
+            }
+            /** Get the horizontal velocities of the live particles (px/s)
+             * \returns The horizontal velocities of the live particles (px/s) (get_count() of them; emitting can move the buffer)
+             */
+            const float* get_x_velocities() const {
+                return this->x_vel.data();
+            }
+            /** Get the vertical velocities of the live particles (px/s)
+             * \returns The vertical velocities of the live particles (px/s) (get_count() of them; emitting can move the buffer)
+             */
+            const float* get_y_velocities() const {
+                return this->y_vel.data();
+            }
+            /** Get how long each live particle has been alive (s)
+             * \returns How long each live particle has been alive (s) (get_count() of them; emitting can move the buffer)
+             */
+            const float* get_ages() const {
+                return this->age.data();
+            }
+            /** Get how long each live particle lives (s)
+             * \returns How long each live particle lives (s) (get_count() of them; emitting can move the buffer)
+             */
+            const float* get_lifetimes() const {
+                return this->lifetime.data();
+            }
+            /** Get the colors of the live particles as 0xAARRGGBB
+             * \returns The colors of the live particles as 0xAARRGGBB (get_count() of them; emitting can move the buffer)
+             */
+            const std::uint32_t* get_colors() const {
+                return this->colors.data();
+            }
+    };
+}
+
+#endif // BENGINE_PARTICLES_hpp
@@ -0,0 +1,259 @@
+#ifndef BENGINE_PROFILER_hpp
+#define BENGINE_PROFILER_hpp
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace bengine {
+    // \brief A per-phase frame profiler that keeps the most recent frames of each phase in a fixed-size ring (used by bengine::loop and bengine::curses_loop)
+    class frame_profiler {
+        public:
+            // \brief The phases of a frame that get timed; phases that run more than once in a frame (like compute) are summed for that frame
+            enum class phases : unsigned char {
+                HANDLE_EVENT = 0,    // time spent inside of handle_event()
+                COMPUTE = 1,         // time spent inside of compute()
+                RENDER = 2,          // time spent inside of render()
+                PRESENT = 3,         // time spent flushing the frame to the terminal/renderer
+                FRAME = 4,           // time spent on the whole frame, excluding any time spent sleeping
+                JOBS = 5             // time spent inside of jobs on every thread (see bengine::job_system), which can add up to more than the frame
+            };
+            // \brief The amount of phases that are tracked
+            static constexpr unsigned char phase_count = 6;
+            // \brief The amount of frames that each phase's ring holds
+            static constexpr unsigned short ring_size = 512;
+
+            // \brief A summary of a phase's recent timings (ms)
+            struct phase_statistics {
+                double p50 = 0;
+                double p95 = 0;
+                double p99 = 0;
+                double max = 0;
+                // \brief The amount of frames that the statistics were generated from
+                unsigned short samples = 0;
+            };
+
+            /** Get the name of a phase
+             * \param phase The phase to get the name of
+             * \returns The name of the phase as a C-style string
+             */
+            static const char* get_phase_name(const bengine::frame_profiler::phases &phase) {
+                switch (phase) {
+                    case bengine::frame_profiler::phases::HANDLE_EVENT:
+                        return "handle_event";
+                    case bengine::frame_profiler::phases::COMPUTE:
+                        return "compute";
+                    case bengine::frame_profiler::phases::RENDER:
+                        return "render";
+                    case bengine::frame_profiler::phases::PRESENT:
+                        return "present";
+                    case bengine::frame_profiler::phases::JOBS:
+                        return "jobs";
+                    default:
+                    case bengine::frame_profiler::phases::FRAME:
+                        return "frame";
+                }
+            }
+
+        private:
+            // \brief Whether timings are being recorded or not (a disabled profiler costs a single branch per call)
+            bool enabled = false;
+            // \brief The path to write a CSV dump to when the owning loop exits (empty for no dump)
+            std::string csv_path = "";
+
+            // \brief The recorded timings (ms) of each phase, one entry per frame
+            std::array<std::array<double, bengine::frame_profiler::ring_size>, bengine::frame_profiler::phase_count> rings = {};
+            // \brief The index within each ring that the next frame will be written to
+            unsigned short ring_head = 0;
+            // \brief The amount of frames that have been recorded in total
+            unsigned long long frame_count = 0;
+
+            // \brief The timings (ms) of each phase accumulated over the current frame
+            std::array<double, bengine::frame_profiler::phase_count> current = {};
+            // \brief The points in time that each phase last started at
+            std::array<std::chrono::steady_clock::time_point, bengine::frame_profiler::phase_count> phase_starts = {};
+
+            // \brief Scratch space reused whenever percentiles are calculated
+            mutable std::vector<double> scratch;
+
+        public:
+            // \brief bengine::frame_profiler constructor
+            frame_profiler() {}
+            // \brief bengine::frame_profiler deconstructor
+            ~frame_profiler() {}
+
+            /** Get whether the profiler is recording or not
+             * \returns Whether the profiler is recording or not
+             */
+            bool is_enabled() const {
+                return this->enabled;
+            }
+            // \brief Make the profiler start recording
+            void enable() {
+                this->enabled = true;
+            }
+            // \brief Make the profiler stop recording (recorded frames are kept)
+            void disable() {
+                this->enabled = false;
+            }
+
+            /** Get the path that a CSV dump will be written to when the owning loop exits
+             * \returns The path that a CSV dump will be written to (empty for no dump)
+             */
+            std::string get_csv_path() const {
+                return this->csv_path;
+            }
+            /** Set the path that a CSV dump will be written to when the owning loop exits
+             * \param path The path to write to (empty for no dump)
+             */
+            void set_csv_path(const std::string &path) {
+                this->csv_path = path;
+            }
+
+            // \brief Clear every recorded frame
+            void reset() {
+                this->rings = {};
+                this->current = {};
+                this->ring_head = 0;
+                this->frame_count = 0;
+            }
+
+            /** Mark the start of a phase
+             * \param phase The phase that is starting
+             */
+            void begin_phase(const bengine::frame_profiler::phases &phase) {
+                if (!this->enabled) {
+                    return;
+                }
+                this->phase_starts[static_cast<unsigned char>(phase)] = std::chrono::steady_clock::now();
+            }
+            /** Mark the end of a phase, adding the elapsed time to the current frame
+             * \param phase The phase that is ending
+             */
+            void end_phase(const bengine::frame_profiler::phases &phase) {
+                if (!this->enabled) {
+                    return;
+                }
+                const unsigned char index = static_cast<unsigned char>(phase);
+                this->current[index] += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->phase_starts[index]).count();
+            }
+            /** Add time to a phase of the current frame that was measured elsewhere (useful for work done off of the loop's thread)
+             * \param phase The phase to add time to
+             * \param milliseconds The amount of time to add (ms)
+             */
+            void add_to_phase(const bengine::frame_profiler::phases &phase, const double &milliseconds) {
+                if (!this->enabled) {
+                    return;
+                }
+                this->current[static_cast<unsigned char>(phase)] += milliseconds;
+            }
+
+            // \brief Mark the start of a frame
+            void begin_frame() {
+                this->begin_phase(bengine::frame_profiler::phases::FRAME);
+            }
+            // \brief Mark the end of a frame, pushing the accumulated phase timings into the rings
+            void end_frame() {
+                if (!this->enabled) {
+                    return;
+                }
+                this->end_phase(bengine::frame_profiler::phases::FRAME);
+                for (unsigned char i = 0; i < bengine::frame_profiler::phase_count; i++) {
+                    this->rings[i][this->ring_head] = this->current[i];
+                    this->current[i] = 0;
+                }
+                this->ring_head = (this->ring_head + 1) % bengine::frame_profiler::ring_size;
+                this->frame_count++;
+            }
+
+            /** Get the amount of frames that have been recorded in total
+             * \returns The amount of frames that have been recorded in total
+             */
+            unsigned long long get_frame_count() const {
+                return this->frame_count;
+            }
+            /** Get the amount of frames currently held within the rings
+             * \returns The amount of frames currently held within the rings
+             */
+            unsigned short get_sample_count() const {
+                return this->frame_count < bengine::frame_profiler::ring_size ? this->frame_count : bengine::frame_profiler::ring_size;
+            }
+            /** Get the timing of a phase from a recent frame
+             * \param phase The phase to get the timing of
+             * \param frames_ago How many frames back to look (0 = the most recently finished frame)
+             * \returns The timing of the phase (ms), or 0 if that frame is no longer held
+             */
+            double get_sample(const bengine::frame_profiler::phases &phase, const unsigned short &frames_ago = 0) const {
+                if (frames_ago >= this->get_sample_count()) {
+                    return 0;
+                }
+                return this->rings[static_cast<unsigned char>(phase)][(this->ring_head + bengine::frame_profiler::ring_size - 1 - frames_ago) % bengine::frame_profiler::ring_size];
+            }
+
+            /** Summarize the recent timings of a phase
+             * \param phase The phase to summarize
+             * \returns The p50/p95/p99/max timings of the phase over the frames held within its ring (ms)
+             */
+            bengine::frame_profiler::phase_statistics get_statistics(const bengine::frame_profiler::phases &phase) const {
+                bengine::frame_profiler::phase_statistics output;
+                output.samples = this->get_sample_count();
+                if (output.samples == 0) {
+                    return output;
+                }
+
+                const std::array<double, bengine::frame_profiler::ring_size> &ring = this->rings[static_cast<unsigned char>(phase)];
+                this->scratch.assign(ring.begin(), ring.begin() + output.samples);
+                output.p50 = this->select_percentile(0.50);
+                output.p95 = this->select_percentile(0.95);
+                output.p99 = this->select_percentile(0.99);
+                output.max = *std::max_element(this->scratch.begin(), this->scratch.end());
+                return output;
+            }
+
+            /** Write every frame held within the rings to a CSV file (oldest frame first)
+             * \param path The path of the file to write to (uses the set CSV path if empty)
+             * \returns 0 on success or -1 if the file couldn't be opened
+             */
+            int dump_csv(const std::string &path = "") const {
+                const std::string &target = path.empty() ? this->csv_path : path;
+                std::ofstream file(target);
+                if (!file.is_open()) {
+                    std::cout << "Frame profiler failed to open \"" << target << "\" [bengine::frame_profiler::dump_csv]\n";
+                    return -1;
+                }
+
+                file << "frame";
+                for (unsigned char i = 0; i < bengine::frame_profiler::phase_count; i++) {
+                    file << ',' << bengine::frame_profiler::get_phase_name(static_cast<bengine::frame_profiler::phases>(i)) << "_ms";
+                }
+                file << '\n';
+
+                const unsigned short samples = this->get_sample_count();
+                for (unsigned short frames_ago = samples; frames_ago > 0; frames_ago--) {
+                    file << this->frame_count - frames_ago;
+                    for (unsigned char i = 0; i < bengine::frame_profiler::phase_count; i++) {
+                        file << ',' << this->get_sample(static_cast<bengine::frame_profiler::phases>(i), frames_ago - 1);
+                    }
+                    file << '\n';
+                }
+                return 0;
+            }
+
+        private:
+            /** Find a percentile within the scratch space (reorders the scratch space)
+             * \param percentile The percentile to find (0-1)
+             * \returns The value at the given percentile
+             */
+            double select_percentile(const double &percentile) const {
+                std::vector<double>::iterator nth = this->scratch.begin() + static_cast<std::size_t>(percentile * (this->scratch.size() - 1) + 0.5);
+                std::nth_element(this->scratch.begin(), nth, this->scratch.end());
+                return *nth;
+            }
+    };
+}
+
+#endif // BENGINE_PROFILER_hpp
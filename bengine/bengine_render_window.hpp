@@ -4,10 +4,22 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
+#include <cmath>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
+#include "bengine_circle_shapes.hpp"
+#include "bengine_draw_command_buffer.hpp"
+#include "bengine_frame_capture.hpp"
 #include "bengine_helpers.hpp"
+#include "bengine_particles.hpp"
+#include "bengine_sprite_batch.hpp"
+#include "bengine_text_cache.hpp"
+#include "bengine_tilemap.hpp"
 #include "bengine_texture.hpp"
+#include "bengine_texture_manager.hpp"
+#include "bengine_viewport_transform.hpp"
 
 namespace bengine {
     // \brief A wrapper class that combines SDL_Window and SDL_Renderer while also replacing many other SDL2 functions
@@ -84,13 +96,13 @@ namespace bengine {
             // \brief Whether to stretch graphics to fill the entire window whenever the baseWidth and baseHeight of the window do not match the current width and height of the window
             bool stretch_graphics = true;
             // \brief The base width of the window that will be used to determine the amount of horizontal stretching that will happen
-            int base_width;
+            int base_width = 0;
             // \brief The base height of the window that will be used to determine the amount of vertical stretching that will happen
-            int base_height;
-            // \brief The factor used to stretch an x-input when bengine::render_window::stretch_graphics is true
-            double x_stretch_factor;
-            // \brief The factor used to stretch a y-input when bengine::render_window::stretch_graphics is true
-            double y_stretch_factor;
+            int base_height = 0;
+            // \brief Maps positions relative to the base dimensions onto the renderer's output; every draw goes through this, so it's only recalculated when the dimensions or stretching settings change
+            bengine::viewport_transform viewport;
+            // \brief Whether stretching is left to SDL_RenderSetLogicalSize (the viewport stays the identity) or done by the viewport
+            bool use_logical_size = false;
 
             // \brief The SDL_Texture that is used whenever the window's dummy texture is initialized and drawn to
             SDL_Texture *dummy_texture = NULL;
@@ -98,6 +110,10 @@ namespace bengine {
             SDL_PixelFormat dummy_pixel_format;
             // \brief Whether the renderer is targeting the window (false) or the dummy texture
             bool render_target = false;
+            // \brief Whether drawing is limited to the clip rectangle or not
+            bool clipping = false;
+            // \brief The part of the current target that drawing is limited to (px, relative to the renderer's output rather than the base dimensions)
+            SDL_Rect clip_rectangle = {0, 0, 0, 0};
 
             /** Pretty much does the same thing as SDL_SetRenderDrawColor, but will also print an error if something goes wrong
              * \param color The SDL_Color to change the renderer's color to
@@ -116,19 +132,154 @@ namespace bengine {
                 std::cout << "\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
             }
  
-            /** Scale an x-value (that is assumed to be) relative to the window's base width to one relative to the window's current width
-             * \param x An x-value relative to the window's base width (px)
-             * \returns The inputted x-value scaled to the window's current width (px)
+            // \brief Recalculate the viewport after the dimensions or stretching settings change
+            void update_viewport() {
+                if (this->use_logical_size) {
+                    SDL_RenderSetLogicalSize(this->renderer, this->stretch_graphics ? this->base_width : 0, this->stretch_graphics ? this->base_height : 0);
+                    this->viewport = bengine::viewport_transform();
+                    return;
+                }
+                if (!this->stretch_graphics || this->base_width <= 0 || this->base_height <= 0) {
+                    this->viewport = bengine::viewport_transform();
+                    return;
+                }
+                this->viewport = bengine::viewport_transform::scale_offset(static_cast<float>(this->width) / this->base_width, static_cast<float>(this->height) / this->base_height);
+            }
+
+            // \brief Circle shapes that have already been generated
+            bengine::circle_shape_cache circle_cache;
+            // \brief Rectangles (relative to the base dimensions) waiting to be submitted in a single call (reused between calls)
+            std::vector<SDL_Rect> rect_buffer;
+
+            void clear_primitive_buffers() {
+                this->rect_buffer.clear();
+            }
+            /** Add a single pixel to the primitive buffers
+             * \param x x-position of the pixel relative to the window (px)
+             * \param y y-position of the pixel relative to the window (px)
              */
-            int stretch_x(const int &x) const {
-                return x * this->x_stretch_factor;
+            void append_pixel(const int &x, const int &y) {
+                this->rect_buffer.push_back({x, y, 1, 1});
+            }
+            /** Add a horizontal span to the primitive buffers
+             * \param x1 x-position of the leftmost pixel of the span relative to the window (px)
+             * \param x2 x-position of the rightmost pixel of the span relative to the window (px)
+             * \param y y-position of the span relative to the window (px)
+             */
+            void append_span(const int &x1, const int &x2, const int &y) {
+                this->rect_buffer.push_back({x1, y, x2 - x1 + 1, 1});
+            }
+            void append_circle_outline(const int &x, const int &y, const int &r) {
+                if (r < 0) {
+                    return;
+                }
+                // a circle without a radius is just its center
+                if (r == 0) {
+                    this->append_pixel(x, y);
+                    return;
+                }
+                const std::vector<SDL_Point> &outline = this->circle_cache.get(r).outline;
+                for (std::size_t i = 0; i < outline.size(); i++) {
+                    this->append_pixel(x + outline[i].x, y + outline[i].y);
+                }
+            }
+            void append_circle_fill(const int &x, const int &y, const int &r) {
+                if (r < 0) {
+                    return;
+                }
+                if (r == 0) {
+                    this->append_pixel(x, y);
+                    return;
+                }
+                const std::vector<int> &half_widths = this->circle_cache.get(r).half_widths;
+                for (int row = 0; row <= r * 2; row++) {
+                    if (half_widths[row] >= 0) {
+                        this->append_span(x - half_widths[row], x + half_widths[row], y + row - r);
+                    }
+                }
+            }
+            /** Submit everything in the primitive buffers using a single call
+             * \param color The color to draw with
+             * \param action What was being drawn (for error messages)
+             * \param method The public method that submitted the buffers (for error messages)
+             */
+            void submit_primitive_buffers(const SDL_Color &color, const char *action, const char *method) {
+                this->submit_rects(this->rect_buffer.data(), this->rect_buffer.size(), color, action, method);
+            }
+
+            // \brief Whether draw calls are recorded and submitted in sorted batches when presenting (true) or submitted as soon as they are made (false)
+            bool deferred_rendering = false;
+            // \brief The amount of calls that the window has submitted to the renderer (clears, fills, lines, copies, and geometry, but not tilemap chunk re-renders) since it was last reset
+            unsigned long long draw_call_count = 0;
+            // \brief Draw calls recorded while rendering is deferred
+            bengine::draw_command_buffer draw_commands;
+            // \brief The layer that deferred draw calls are recorded on (lower layers are drawn first)
+            unsigned char draw_layer = 0;
+            // \brief The blend mode that shapes are drawn with
+            SDL_BlendMode draw_blend_mode = SDL_BLENDMODE_NONE;
+            // \brief Rectangles waiting to be recorded as a single deferred draw call (reused between calls)
+            std::vector<SDL_FRect> frect_buffer;
+
+            // \brief Glyphs and whole-string textures used for drawing text
+            bengine::text_cache text;
+            // \brief Textures loaded by path, shared between everything that uses them
+            bengine::texture_manager textures;
+            // \brief The visible chunks of the tilemap being rendered (reused between calls)
+            std::vector<bengine::tilemap::chunk_view> chunk_views;
+            // \brief The quads of the particles being rendered and the index pattern shared by every quad (reused between calls)
+            std::vector<SDL_Vertex> particle_vertices;
+            std::vector<int> particle_indices;
+            // \brief Reads presented frames back and writes them out on a worker thread while capturing
+            bengine::frame_capture capture;
+
+            /** Fill rectangles relative to the base dimensions in a single call (or record them as a single deferred draw call)
+             * \param rects The rectangles to fill (px)
+             * \param count The amount of rectangles
+             * \param color The color to fill the rectangles with
+             * \param action What was being drawn (for error messages)
+             * \param method The public method that submitted the rectangles (for error messages)
+             */
+            void submit_rects(const SDL_Rect *rects, const std::size_t &count, const SDL_Color &color, const char *action, const char *method) {
+                if (count == 0) {
+                    return;
+                }
+                this->frect_buffer.resize(count);
+                this->viewport.apply(rects, count, this->frect_buffer.data());
+                if (this->deferred_rendering) {
+                    this->draw_commands.add_rects(this->draw_layer, this->draw_blend_mode, this->frect_buffer.data(), count, color);
+                    return;
+                }
+                this->change_draw_color(color);
+                this->draw_call_count++;
+                if (SDL_RenderFillRectsF(this->renderer, this->frect_buffer.data(), count) != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to " << action << " [bengine::render_window::" << method << "]";
+                    this->print_error();
+                }
             }
-            /** Scale a y-value (that is assumed to be) relative to the window's base height to one relative to the window's current height
-             * \param y A y-value relative to the window's base height (px)
-             * \returns The inputted y-value scaled to the window's current height (px)
+            /** Copy a texture onto a rectangle relative to the base dimensions (or record it as a deferred draw call)
+             * \param texture The SDL_Texture to copy from
+             * \param src The portion of the texture to copy (px)
+             * \param dst Where to copy the texture to (px)
+             * \param angle How far to rotate the texture counter-clockwise (degrees)
+             * \param center The point to rotate around relative to the top-left corner of the destination (px), or NULL for the center of the destination
+             * \param flip How to flip the texture
+             * \param action What was being drawn (for error messages)
+             * \param method The public method that copied the texture (for error messages)
              */
-            int stretch_y(const int &y) const {
-                return y * this->y_stretch_factor;
+            void copy_texture(SDL_Texture *texture, const SDL_Rect &src, const SDL_Rect &dst, const double &angle, const SDL_Point *center, const SDL_RendererFlip &flip, const char *action, const char *method) {
+                const SDL_FRect destination = this->viewport.apply(dst);
+                SDL_FPoint pivot;
+                if (center != NULL) {
+                    pivot = this->viewport.apply_to_offset(center->x, center->y);
+                }
+                if (!this->deferred_rendering) {
+                    this->draw_call_count++;
+                }
+                const int output = this->deferred_rendering ? this->draw_commands.add_texture(this->draw_layer, texture, &src, destination, -angle, center == NULL ? NULL : &pivot, flip) : SDL_RenderCopyExF(this->renderer, texture, &src, &destination, -angle, center == NULL ? NULL : &pivot, flip);
+                if (output != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to " << action << " [bengine::render_window::" << method << "]";
+                    this->print_error();
+                }
             }
 
         public:
@@ -143,7 +294,8 @@ namespace bengine {
                     std::cout << "Window \"" << title << "\" failed to initialize [bengine::render_window::render_window]";
                     this->print_error();
                 }
-                if ((this->renderer = SDL_CreateRenderer(this->window, -1, SDL_RENDERER_ACCELERATED)) == NULL) {
+                // machines without a GPU (or running under SDL_VIDEODRIVER=dummy) only have the software renderer
+                if ((this->renderer = SDL_CreateRenderer(this->window, -1, SDL_RENDERER_ACCELERATED)) == NULL && (this->renderer = SDL_CreateRenderer(this->window, -1, SDL_RENDERER_SOFTWARE)) == NULL) {
                     std::cout << "Window \"" << title << "\" failed to initialize its renderer [bengine::render_window::render_window]";
                     this->print_error();
                 }
@@ -154,17 +306,24 @@ namespace bengine {
 
                 this->base_width = this->width;
                 this->base_height = this->height;
-                this->x_stretch_factor = this->width / this->base_width;
-                this->y_stretch_factor = this->height / this->base_height;
+                this->update_viewport();
 
                 const int gcd = bengine::math_helper::greatest_common_divisor<int>(this->width, this->height);
                 this->ratio_lock_width = this->width / gcd;
                 this->ratio_lock_height = this->height / gcd;
 
                 this->generate_dummy_pixel_format();
+                this->text.set_renderer(this->renderer);
+                this->textures.set_renderer(this->renderer);
             }
             // \brief bengine::render_window deconstructor
             ~render_window() {
+                // cached text and managed textures belong to the renderer, so they have to go first (and the capture can't outlive it either)
+                this->capture.stop();
+                this->text.clear();
+                this->text.end_frame();
+                this->textures.clear();
+                SDL_DestroyTexture(this->dummy_texture);
                 SDL_DestroyRenderer(this->renderer);
                 SDL_DestroyWindow(this->window);
                 this->renderer = nullptr;
@@ -368,6 +527,7 @@ namespace bengine {
              */
             void set_base_width(const int &width) {
                 this->base_width = width;
+                this->update_viewport();
             }
 
             /** Get the base height of the window (px) that will be used to determine the amount of vertical stretching that will happen
@@ -381,6 +541,7 @@ namespace bengine {
              */
             void set_base_height(const int &height) {
                 this->base_height = height;
+                this->update_viewport();
             }
 
             /** Get whether the window will stretch graphics based off of a base width/height or not
@@ -392,14 +553,143 @@ namespace bengine {
             // \brief Make the window start stretching graphics based off of a base width/height
             void start_graphical_stretching() {
                 this->stretch_graphics = true;
+                this->update_viewport();
             }
             // \brief Make the window stop stretching graphics based off of a base width/height
             void halt_graphical_stretching() {
                 this->stretch_graphics = false;
+                this->update_viewport();
             }
             // \brief Toggle whether the window will stretch graphics based off of a base width/height or not
             void toggle_graphical_stretching() {
                 this->stretch_graphics = !this->stretch_graphics;
+                this->update_viewport();
+            }
+            /** Get whether stretching is left to SDL's logical size (true) or done by the window's own viewport (false)
+             * \returns Whether stretching is left to SDL's logical size or not
+             */
+            bool is_using_logical_size() const {
+                return this->use_logical_size;
+            }
+            // \brief Leave stretching to SDL_RenderSetLogicalSize, which scales everything on the GPU (and letterboxes to keep the base aspect ratio) instead of scaling each draw
+            void start_using_logical_size() {
+                this->flush_draw_commands();
+                this->use_logical_size = true;
+                this->update_viewport();
+            }
+            // \brief Go back to stretching with the window's own viewport, which fills the whole window
+            void halt_using_logical_size() {
+                this->flush_draw_commands();
+                SDL_RenderSetLogicalSize(this->renderer, 0, 0);
+                this->use_logical_size = false;
+                this->update_viewport();
+            }
+            /** Get the transform that maps positions relative to the base dimensions onto the renderer's output
+             * \returns The window's viewport transform
+             */
+            bengine::viewport_transform get_viewport() const {
+                return this->viewport;
+            }
+            /** Map a position on the window (like the mouse's) back to one relative to the base dimensions
+             * \param x x-position relative to the window (px)
+             * \param y y-position relative to the window (px)
+             * \returns The position relative to the base dimensions (px)
+             */
+            SDL_FPoint map_to_base(const float &x, const float &y) const {
+                if (this->use_logical_size && this->stretch_graphics) {
+                    // SDL already maps mouse events into the logical size
+                    return {x, y};
+                }
+                return this->viewport.inverse().apply(x, y);
+            }
+
+            /** Get whether draw calls are being deferred until the renderer is presented or not
+             * \returns Whether draw calls are being deferred until the renderer is presented or not
+             */
+            bool is_deferring_rendering() const {
+                return this->deferred_rendering;
+            }
+            // \brief Make the window start recording draw calls and submitting them in sorted batches when the renderer is presented (draws are only kept in order across layers, see bengine::render_window::set_draw_layer())
+            void start_deferred_rendering() {
+                this->deferred_rendering = true;
+            }
+            // \brief Make the window submit any recorded draw calls and go back to submitting draw calls as soon as they are made
+            void halt_deferred_rendering() {
+                this->flush_draw_commands();
+                this->deferred_rendering = false;
+            }
+            // \brief Toggle whether draw calls are deferred until the renderer is presented or not
+            void toggle_deferred_rendering() {
+                if (this->deferred_rendering) {
+                    this->halt_deferred_rendering();
+                } else {
+                    this->start_deferred_rendering();
+                }
+            }
+            /** Get the layer that deferred draw calls are recorded on
+             * \returns The layer that deferred draw calls are recorded on
+             */
+            unsigned char get_draw_layer() const {
+                return this->draw_layer;
+            }
+            /** Set the layer that deferred draw calls are recorded on; lower layers are always drawn before higher ones, but draws within a layer are sorted by texture/blend mode/color, so anything that overlaps something else with a different state should go on its own layer
+             * \param layer The layer that deferred draw calls will be recorded on
+             */
+            void set_draw_layer(const unsigned char &layer) {
+                this->draw_layer = layer;
+            }
+            /** Get the blend mode that shapes are drawn with
+             * \returns The blend mode that shapes are drawn with
+             */
+            SDL_BlendMode get_draw_blend_mode() const {
+                return this->draw_blend_mode;
+            }
+            /** Set the blend mode that shapes are drawn with (textures use their own blend modes)
+             * \param blend_mode The blend mode that shapes will be drawn with
+             */
+            void set_draw_blend_mode(const SDL_BlendMode &blend_mode) {
+                this->draw_blend_mode = blend_mode;
+                if (!this->deferred_rendering && SDL_SetRenderDrawBlendMode(this->renderer, blend_mode) != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to change its renderer's blend mode [bengine::render_window::set_draw_blend_mode]";
+                    this->print_error();
+                }
+            }
+            /** Get how many draw calls were recorded and how many were actually submitted during the last presented frame (only counted while rendering is deferred)
+             * \returns The draw call counts of the last presented frame
+             */
+            bengine::draw_command_buffer::statistics get_draw_statistics() const {
+                return this->draw_commands.get_last_statistics();
+            }
+            /** Get how many calls have been submitted to the renderer since the count was last reset (deferred draw calls count once they are flushed, as however many batches they were submitted in)
+             * \returns The amount of calls submitted to the renderer
+             */
+            unsigned long long get_draw_call_count() const {
+                return this->draw_call_count;
+            }
+            // \brief Start counting submitted draw calls over from 0
+            void reset_draw_call_count() {
+                this->draw_call_count = 0;
+            }
+            /** Submit every recorded draw call in sorted batches (happens automatically when presenting and when switching render targets)
+             * \returns 0 on success or -1 if a batch failed to submit
+             */
+            int flush_draw_commands() {
+                if (this->draw_commands.is_empty()) {
+                    return 0;
+                }
+                const unsigned long submitted_calls = this->draw_commands.get_current_statistics().submitted_calls;
+                const int output = this->draw_commands.flush(this->renderer);
+                this->draw_call_count += this->draw_commands.get_current_statistics().submitted_calls - submitted_calls;
+                // batches change the renderer's blend mode, so it gets put back for any immediate draws
+                SDL_SetRenderDrawBlendMode(this->renderer, this->draw_blend_mode);
+                return output;
+            }
+
+            /** Get the SDL_Renderer that the window draws with (for things like bengine::texture_atlas that need to make their own textures)
+             * \returns The window's SDL_Renderer
+             */
+            SDL_Renderer* get_renderer() const {
+                return this->renderer;
             }
 
             /** Get the window's title as a C-style string
@@ -415,19 +705,126 @@ namespace bengine {
                 SDL_SetWindowTitle(this->window, title);
             }
 
-            /** Clear the renderer
+            /** Clear the renderer (only the clip rectangle while clipping)
              * \param color The color to make the newly blank screen as an SDL_Color
              */
             void clear_renderer(const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::BLACK)) {
                 this->change_draw_color(color);
+                if (this->clipping) {
+                    // SDL_RenderClear ignores the clip rectangle, so only the clipped area gets overwritten (anything recorded outside of it still has to be drawn)
+                    this->flush_draw_commands();
+                    SDL_SetRenderDrawBlendMode(this->renderer, SDL_BLENDMODE_NONE);
+                    this->draw_call_count++;
+                    if (SDL_RenderFillRect(this->renderer, NULL) != 0) {
+                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to clear the clip rectangle [bengine::render_window::clear_renderer]";
+                        this->print_error();
+                    }
+                    SDL_SetRenderDrawBlendMode(this->renderer, this->draw_blend_mode);
+                    return;
+                }
+                // anything recorded before clearing would be drawn over by the clear anyways
+                this->draw_commands.discard();
+                this->draw_call_count++;
                 if (SDL_RenderClear(this->renderer) != 0) {
                     std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to clear renderer [bengine::render_window::clear_renderer]";
                     this->print_error();
                 }
             }
+            /** Get whether drawing is limited to a clip rectangle or not
+             * \returns Whether drawing is limited to a clip rectangle or not
+             */
+            bool is_clipping() const {
+                return this->clipping;
+            }
+            /** Get the part of the current target that drawing is limited to
+             * \returns The clip rectangle (px, relative to the renderer's output rather than the base dimensions)
+             */
+            SDL_Rect get_clip_rectangle() const {
+                return this->clip_rectangle;
+            }
+            /** Limit drawing to a part of the current target (switching targets removes the clip rectangle)
+             * \param x x-position of the top-left corner relative to the base dimensions (px) (assuming positive width and height)
+             * \param y y-position of the top-left corner relative to the base dimensions (px) (assuming positive width and height)
+             * \param w Width of the clip rectangle relative to the base dimensions (px) (can be negative)
+             * \param h Height of the clip rectangle relative to the base dimensions (px) (can be negative)
+             * \returns 0 on success or a negative error code on failure
+             */
+            int set_clip_rectangle(const int &x, const int &y, const int &w, const int &h) {
+                this->flush_draw_commands();
+                // rounded outwards so that stretched edges never get cut off
+                const SDL_FRect area = this->viewport.apply(SDL_Rect{x, y, w, h});
+                const int left = static_cast<int>(std::floor(area.x)), top = static_cast<int>(std::floor(area.y));
+                const SDL_Rect clip = {left, top, static_cast<int>(std::ceil(area.x + area.w)) - left, static_cast<int>(std::ceil(area.y + area.h)) - top};
+
+                const int output = SDL_RenderSetClipRect(this->renderer, &clip);
+                if (output != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to set its clip rectangle [bengine::render_window::set_clip_rectangle]";
+                    this->print_error();
+                } else {
+                    this->clipping = true;
+                    this->clip_rectangle = clip;
+                }
+                return output;
+            }
+            // \brief Let drawing reach the entire current target again
+            void reset_clip_rectangle() {
+                if (!this->clipping) {
+                    return;
+                }
+                this->flush_draw_commands();
+                SDL_RenderSetClipRect(this->renderer, NULL);
+                this->clipping = false;
+                this->clip_rectangle = {0, 0, 0, 0};
+            }
+
+            /** Start writing every presented frame out on a background thread (see bengine::frame_capture)
+             * \param destination The path prefix for PNG frames, the file for RAW frames, or the command to pipe PIPE frames into
+             * \param format What to do with each presented frame
+             * \returns 0 on success or -1 if the file/pipe couldn't be opened
+             */
+            int start_capture(const std::string &destination, const bengine::frame_capture::output_format &format = bengine::frame_capture::output_format::PNG) {
+                return this->capture.start(destination, format);
+            }
+            // \brief Stop capturing presented frames (blocks until every captured frame has been written out)
+            void stop_capture() {
+                this->capture.stop();
+            }
+            /** Get whether presented frames are being captured or not
+             * \returns Whether presented frames are being captured or not
+             */
+            bool is_capturing() const {
+                return this->capture.is_capturing();
+            }
+            /** Get how many frames have been captured, dropped, and written since capturing started
+             * \returns The capture's counts
+             */
+            bengine::frame_capture::statistics get_capture_statistics() {
+                return this->capture.get_statistics();
+            }
+
+            /** Make presenting wait for the display's vertical blank (vsync) or not
+             * \param vsync Whether to wait for vsync or not
+             * \returns 0 on success or a negative error code on failure (like if the renderer doesn't support changing it)
+             */
+            int set_vsync(const bool &vsync) {
+                const int output = SDL_RenderSetVSync(this->renderer, vsync ? 1 : 0);
+                if (output != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to " << (vsync ? "enable" : "disable") << " vsync [bengine::render_window::set_vsync]";
+                    this->print_error();
+                }
+                return output;
+            }
+
             // \brief Present the renderer's buffer to the window to see
             void present_renderer() {
+                this->flush_draw_commands();
+                this->draw_commands.end_frame();
+                // the back buffer is undefined after presenting, so it has to be read now
+                if (this->capture.is_capturing() && !this->render_target) {
+                    this->capture.capture(this->renderer);
+                }
                 SDL_RenderPresent(this->renderer);
+                this->text.end_frame();
             }
 
             // \brief Syncronize the class's dimensional members with the SDL_Window to clear any potential discrepancies
@@ -439,6 +836,7 @@ namespace bengine {
                 this->height = height;
                 this->width_2 = this->width / 2;
                 this->height_2 = this->height / 2;
+                this->update_viewport();
             }
             /** Handles the general behavior that windows should have when certain events trigger (for now, just window resizing)
              * \param event The SDL_WindowEvent to handle
@@ -479,19 +877,8 @@ namespace bengine {
              * \param color The color to change the pixel to as an SDL_Color
              */
             void draw_pixel(const int &x, const int &y, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                this->change_draw_color(color);
-
-                if (this->stretch_graphics) {
-                    if (SDL_RenderDrawPoint(this->renderer, this->stretch_x(x), this->stretch_y(y)) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a pixel [bengine::render_window::draw_pixel]";
-                        this->print_error();
-                    }
-                    return;
-                }
-                if (SDL_RenderDrawPoint(this->renderer, x, y) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a pixel [bengine::render_window::draw_pixel]";
-                    this->print_error();
-                }
+                const SDL_Rect pixel = {x, y, 1, 1};
+                this->submit_rects(&pixel, 1, color, "draw a pixel", "draw_pixel");
             }
             /** Draw a line; includes minor optimizations for totally horizontal/vertical lines and single points
              * \param x1 x-position of the starting point relative to the window (px)
@@ -501,39 +888,20 @@ namespace bengine {
              * \param color The color to draw the line with as an SDL_Color
              */
             void draw_line(const int &x1, const int &y1, const int &x2, const int &y2, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                if (x1 == x2 && y1 == y2) {
-                    this->draw_pixel(x1, y1, color);
+                if (x1 == x2 || y1 == y2) {
+                    const SDL_Rect span = {x1 < x2 ? x1 : x2, y1 < y2 ? y1 : y2, (x1 < x2 ? x2 - x1 : x1 - x2) + 1, (y1 < y2 ? y2 - y1 : y1 - y2) + 1};
+                    this->submit_rects(&span, 1, color, "draw a line", "draw_line");
                     return;
                 }
 
-                if (this->stretch_graphics) {
-                    if (x1 == x2) {
-                        this->draw_rectangle(this->stretch_x(x1), this->stretch_y(y1), 1, this->stretch_y(y2) - this->stretch_y(y1), color);
-                        return;
-                    }
-                    if (y1 == y2) {
-                        this->draw_rectangle(this->stretch_x(x1), this->stretch_y(y1), this->stretch_x(x2) - this->stretch_x(x1), 1, color);
-                        return;
-                    }
-
-                    this->change_draw_color(color);
-                    if (SDL_RenderDrawLine(this->renderer, this->stretch_x(x1), this->stretch_y(y1), this->stretch_x(x2), this->stretch_y(y2)) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a line [bengine::render_window::draw_line]";
-                        this->print_error();
-                    }
-                    return;
-                }
-                if (x1 == x2) {
-                    this->draw_rectangle(x1, y1, 1, y2 - y1, color);
-                    return;
-                }
-                if (y1 == y2) {
-                    this->draw_rectangle(x1, y1, x2 - x1, 1, color);
+                const SDL_FPoint start = this->viewport.apply(x1, y1), end = this->viewport.apply(x2, y2);
+                if (this->deferred_rendering) {
+                    this->draw_commands.add_line(this->draw_layer, this->draw_blend_mode, start.x, start.y, end.x, end.y, color);
                     return;
                 }
-
                 this->change_draw_color(color);
-                if (SDL_RenderDrawLine(this->renderer, x1, y1, x2, y2) != 0) {
+                this->draw_call_count++;
+                if (SDL_RenderDrawLineF(this->renderer, start.x, start.y, end.x, end.y) != 0) {
                     std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a line [bengine::render_window::draw_line]";
                     this->print_error();
                 }
@@ -547,21 +915,13 @@ namespace bengine {
              * \param color The color to draw the rectangle with as an SDL_Color
              */
             void draw_rectangle(const int &x, const int &y, const int &w, const int &h, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                this->change_draw_color(color);
-                
-                if (this->stretch_graphics) {
-                    const SDL_Rect dst = {x, y, w, h};
-                    if (SDL_RenderDrawRect(this->renderer, &dst) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a rectangle [bengine::render_window::draw_rectangle]";
-                        this->print_error();
-                    }
+                if (w == 0 || h == 0) {
                     return;
                 }
-                const SDL_Rect dst = {this->stretch_x(x), this->stretch_y(y), this->stretch_x(w), this->stretch_y(h)};
-                if (SDL_RenderDrawRect(this->renderer, &dst) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a rectangle [bengine::render_window::draw_rectangle]";
-                    this->print_error();
-                }
+                // the perimeter is drawn as up to four edges so that it stretches like every other shape
+                const int left = w < 0 ? x + w : x, top = h < 0 ? y + h : y, width = w < 0 ? -w : w, height = h < 0 ? -h : h;
+                const SDL_Rect edges[4] = {{left, top, width, 1}, {left, top + height - 1, width, 1}, {left, top + 1, 1, height - 2}, {left + width - 1, top + 1, 1, height - 2}};
+                this->submit_rects(edges, height > 2 ? 4 : (height > 1 ? 2 : 1), color, "draw a rectangle", "draw_rectangle");
             }
             /** Draw a rectangle with a specified edge thickness (not filled, will only draw the perimeter at the set thickness)
              * \param x x-position of the top-left corner relative to the window (px) (assuming positive width and height)
@@ -573,8 +933,6 @@ namespace bengine {
              * \param color The color to draw the rectangle with as an SDL_Color
              */
             void draw_thick_rectangle(const int &x, const int &y, const int &w, const int &h, const int &thickness, const bengine::render_window::thickness_mode &mode = bengine::render_window::thickness_mode::INNER, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                this->change_draw_color(color);
-
                 SDL_Rect rect[4];
                 switch (mode) {
                     default:
@@ -597,20 +955,7 @@ namespace bengine {
                         rect[3] = {x + w - thickness / 2, y + thickness / 2, thickness, h - thickness};
                         break;
                 }
-
-                if (this->stretch_graphics) {
-                    for (unsigned char i = 0; i < 4; i++) {
-                        rect[i].x = this->stretch_x(rect[i].x);
-                        rect[i].y = this->stretch_y(rect[i].y);
-                        rect[i].w = this->stretch_x(rect[i].w);
-                        rect[i].h = this->stretch_y(rect[i].h);
-                    }
-                }
-
-                if (SDL_RenderFillRect(this->renderer, &rect[0]) != 0 || SDL_RenderFillRect(this->renderer, &rect[1]) != 0 || SDL_RenderFillRect(this->renderer, &rect[2]) != 0 || SDL_RenderFillRect(this->renderer, &rect[3]) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to draw a thick rectangle [bengine::render_window::draw_thick_rectangle]";
-                    this->print_error();
-                }
+                this->submit_rects(rect, 4, color, "draw a thick rectangle", "draw_thick_rectangle");
             }
             /** Fill a rectangle
              * \param x x-position of the top-left corner relative to the window (px) (assuming positive width and height)
@@ -620,84 +965,82 @@ namespace bengine {
              * \param color The color to fill the rectangle with as an SDL_Color
              */
             void fill_rectangle(const int &x, const int &y, const int &w, const int &h, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                this->change_draw_color(color);
-
-                if (this->stretch_graphics) {
-                    const SDL_Rect dst = {x, y, w, h};
-                    if (SDL_RenderFillRect(this->renderer, &dst) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to fill a rectangle [bengine::render_window::fill_rectangle]";
-                        this->print_error();
-                    }
-                    return;
-                }
-                const SDL_Rect dst = {this->stretch_x(x), this->stretch_y(y), this->stretch_x(w), this->stretch_y(h)};
-                if (SDL_RenderFillRect(this->renderer, &dst) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to fill a rectangle [bengine::render_window::fill_rectangle]";
-                    this->print_error();
-                }
+                const SDL_Rect dst = {x, y, w, h};
+                this->submit_rects(&dst, 1, color, "fill a rectangle", "fill_rectangle");
             }
-            /** Draw a circle (not filled, will only draw the perimeter at the set thickness; DOES NOT GET STRETCHED)
+            /** Draw a circle (not filled, will only draw the perimeter)
              * \param x x-position of the center of the circle relative to the window (px)
              * \param y y-position of the center of the circle relative to the window (px)
              * \param r Radius of the circle (px)
              * \param color The color to draw the circle with as an SDL_Color
              */
             void draw_circle(const int &x, const int &y, const int &r, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                SDL_SetRenderDrawColor(this->renderer, color.r, color.g, color.b, color.a);
-                const int diameter = r * 2;
-                int ox = r - 1;
-                int oy = 0;
-                int tx = 1;
-                int ty = 1;
-                int error = tx - diameter;
-                while (ox >= oy) {
-                    SDL_RenderDrawPoint(this->renderer, x + ox, y - oy);
-                    SDL_RenderDrawPoint(this->renderer, x + ox, y + oy);
-                    SDL_RenderDrawPoint(this->renderer, x - ox, y - oy);
-                    SDL_RenderDrawPoint(this->renderer, x - ox, y + oy);
-                    SDL_RenderDrawPoint(this->renderer, x + oy, y - ox);
-                    SDL_RenderDrawPoint(this->renderer, x + oy, y + ox);
-                    SDL_RenderDrawPoint(this->renderer, x - oy, y - ox);
-                    SDL_RenderDrawPoint(this->renderer, x - oy, y + ox);
-                    if (error <= 0) {
-                        oy++;
-                        error += ty;
-                        ty += 2;
-                    } else if (error > 0) {
-                        ox--;
-                        tx += 2;
-                        error += tx - diameter;
-                    }
+                this->clear_primitive_buffers();
+                this->append_circle_outline(x, y, r);
+                this->submit_primitive_buffers(color, "draw a circle", "draw_circle");
+            }
+            /** Draw many circles of the same size and color at once (not filled, will only draw the perimeters)
+             * \param centers The centers of the circles relative to the window (px)
+             * \param r Radius of every circle (px)
+             * \param color The color to draw the circles with as an SDL_Color
+             */
+            void draw_circles(const std::vector<SDL_Point> &centers, const int &r, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                this->clear_primitive_buffers();
+                for (std::size_t i = 0; i < centers.size(); i++) {
+                    this->append_circle_outline(centers[i].x, centers[i].y, r);
+                }
+                this->submit_primitive_buffers(color, "draw circles", "draw_circles");
+            }
+            /** Draw many circles of the same color at once (not filled, will only draw the perimeters)
+             * \param centers The centers of the circles relative to the window (px)
+             * \param radii The radius of each circle (px) (one per center)
+             * \param color The color to draw the circles with as an SDL_Color
+             */
+            void draw_circles(const std::vector<SDL_Point> &centers, const std::vector<int> &radii, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                this->clear_primitive_buffers();
+                for (std::size_t i = 0; i < centers.size() && i < radii.size(); i++) {
+                    this->append_circle_outline(centers[i].x, centers[i].y, radii[i]);
                 }
+                this->submit_primitive_buffers(color, "draw circles", "draw_circles");
             }
-            /** Fill a circle (DOES NOT GET STRETCHED)
+            /** Fill a circle
              * \param x x-position of the center of the circle relative to the window (px)
              * \param y y-position of the center of the circle relative to the window (px)
              * \param r Radius of the circle (px)
              * \param color The color to fill the circle with as an SDL_Color
              */
             void fill_circle(const int &x, const int &y, const int &r, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                SDL_SetRenderDrawColor(this->renderer, color.r, color.g, color.b, color.a);
-                int ox = 0;
-                int oy = r;
-                int error = r - 1;
-                while (oy >= ox) {
-                    SDL_RenderDrawLine(this->renderer, x - oy, y + ox, x + oy, y + ox);
-                    SDL_RenderDrawLine(this->renderer, x - ox, y + oy, x + ox, y + oy);
-                    SDL_RenderDrawLine(this->renderer, x - ox, y - oy, x + ox, y - oy);
-                    SDL_RenderDrawLine(this->renderer, x - oy, y - ox, x + oy, y - ox);
-                    if (error >= ox * 2) {
-                        error -= ox * 2 + 1;
-                        ox++;
-                    } else if (error < 2 * (r - oy)) {
-                        error += oy * 2 - 1;
-                        oy--;
-                    } else {
-                        error += 2 * (oy - ox - 1);
-                        oy--;
-                        ox++;
-                    }
+                this->clear_primitive_buffers();
+                this->append_circle_fill(x, y, r);
+                this->submit_primitive_buffers(color, "fill a circle", "fill_circle");
+            }
+            /** Fill many circles of the same size and color at once
+             * \param centers The centers of the circles relative to the window (px)
+             * \param r Radius of every circle (px)
+             * \param color The color to fill the circles with as an SDL_Color
+             */
+            void fill_circles(const std::vector<SDL_Point> &centers, const int &r, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                this->clear_primitive_buffers();
+                for (std::size_t i = 0; i < centers.size(); i++) {
+                    this->append_circle_fill(centers[i].x, centers[i].y, r);
+                }
+                this->submit_primitive_buffers(color, "fill circles", "fill_circles");
+            }
+            /** Fill many circles of the same color at once
+             * \param centers The centers of the circles relative to the window (px)
+             * \param radii The radius of each circle (px) (one per center)
+             * \param color The color to fill the circles with as an SDL_Color
+             */
+            void fill_circles(const std::vector<SDL_Point> &centers, const std::vector<int> &radii, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                this->clear_primitive_buffers();
+                for (std::size_t i = 0; i < centers.size() && i < radii.size(); i++) {
+                    this->append_circle_fill(centers[i].x, centers[i].y, radii[i]);
                 }
+                this->submit_primitive_buffers(color, "fill circles", "fill_circles");
+            }
+            // \brief Forget every cached circle shape (the cache keeps one entry per radius that has been drawn)
+            void clear_circle_cache() {
+                this->circle_cache.clear();
             }
 
             /** Load an SDL_Texture using the window's renderer
@@ -736,9 +1079,18 @@ namespace bengine {
              * \param height The height of the dummy texture (px)
              */
             int initialize_dummy(const int &width, const int &height) {
+                this->flush_draw_commands();
                 if (this->dummy_pixel_format.format == SDL_PIXELFORMAT_UNKNOWN) {
                     this->generate_dummy_pixel_format();
                 }
+                if (this->dummy_texture != NULL) {
+                    // the renderer can't be left targeting a texture that is about to be destroyed
+                    if (this->render_target) {
+                        this->reset_clip_rectangle();
+                        SDL_SetRenderTarget(this->renderer, NULL);
+                    }
+                    SDL_DestroyTexture(this->dummy_texture);
+                }
                 this->dummy_texture = SDL_CreateTexture(this->renderer, this->dummy_pixel_format.format, SDL_TEXTUREACCESS_TARGET, width, height);
                 if (this->dummy_texture == NULL) {
                     std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to create dummy texture [bengine::render_window::initialize_dummy]";
@@ -757,6 +1109,8 @@ namespace bengine {
              * \returns 0 on success or a negative error code on failure
              */
             int target_renderer_at_dummy() {
+                this->reset_clip_rectangle();
+                this->flush_draw_commands();
                 const int output = SDL_SetRenderTarget(this->renderer, this->dummy_texture);
                 if (output != 0) {
                     std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to switch the rendering target to the dummy texture [bengine::render_window::target_renderer_at_dummy]";
@@ -770,6 +1124,8 @@ namespace bengine {
              * \returns 0 on success or a negative error code on failure
              */
             int target_renderer_at_window() {
+                this->reset_clip_rectangle();
+                this->flush_draw_commands();
                 const int output = SDL_SetRenderTarget(this->renderer, NULL);
                 if (output != 0) {
                     std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to switch the rendering target to the window [bengine::render_window::target_renderer_at_window]";
@@ -779,10 +1135,31 @@ namespace bengine {
                 }
                 return output;
             }
+            /** Get whether the dummy texture has been initialized or not
+             * \returns Whether the dummy texture has been initialized or not
+             */
+            bool has_dummy() const {
+                return this->dummy_texture != NULL;
+            }
+            /** Copy the entire dummy texture over the entire window (for showing something that was drawn to the dummy texture earlier); the renderer has to be targeting the window
+             * \returns 0 on success or a negative error code on failure
+             */
+            int render_dummy() {
+                this->flush_draw_commands();
+                this->draw_call_count++;
+                const int output = this->render_target ? -1 : SDL_RenderCopy(this->renderer, this->dummy_texture, NULL, NULL);
+                if (output != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render its dummy texture [bengine::render_window::render_dummy]";
+                    this->print_error();
+                }
+                return output;
+            }
             /** Copy the dummy texture onto another texture (has a few ramifications but should be fine overall)
              * \returns An SDL_Texture that reflects the dummy texture
              */
             SDL_Texture* duplicate_dummy() {
+                this->reset_clip_rectangle();
+                this->flush_draw_commands();
                 int width, height;
                 SDL_BlendMode blendmode;
 
@@ -812,18 +1189,7 @@ namespace bengine {
              * \param dst The portion of the window/dummy texture to copy to (px for all 4 metrics) (will stretch the texture to fill the given rectangle)
              */
             void render_SDLTexture(SDL_Texture *texture, const SDL_Rect &src, const SDL_Rect &dst) {
-                if (this->stretch_graphics) {
-                    const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
-                    if (SDL_RenderCopy(this->renderer, texture, &src, &destination) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render SDL_Texture [bengine::render_window::render_SDLTexture]";
-                        this->print_error();
-                    }
-                    return;
-                }
-                if (SDL_RenderCopy(this->renderer, texture, &src, &dst) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render SDL_Texture [bengine::render_window::render_SDLTexture]";
-                    this->print_error();
-                }
+                this->copy_texture(texture, src, dst, 0, NULL, SDL_FLIP_NONE, "render SDL_Texture", "render_SDLTexture");
             }
             /** Render an SDL_Texture while also applying rotations/reflections
              * \param texture The SDL_Texture to render
@@ -834,18 +1200,7 @@ namespace bengine {
              * \param flip How to flip the rectangle (SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL can be OR'd together)
              */
             void render_SDLTexture(SDL_Texture *texture, const SDL_Rect &src, const SDL_Rect &dst, const double &angle, const SDL_Point &center, const SDL_RendererFlip &flip) {
-                if (this->stretch_graphics) {
-                    const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
-                    if (SDL_RenderCopyEx(this->renderer, texture, &src, &destination, -angle, &center, flip) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render SDL_Texture [bengine::render_window::render_SDLTexture]";
-                        this->print_error();
-                    }
-                    return;
-                }
-                if (SDL_RenderCopyEx(this->renderer, texture, &src, &dst, -angle, &center, flip) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render SDL_Texture [bengine::render_window::render_SDLTexture]";
-                    this->print_error();
-                }
+                this->copy_texture(texture, src, dst, angle, &center, flip, "render SDL_Texture", "render_SDLTexture");
             }
 
             /** Render a bengine::basic_texture
@@ -853,19 +1208,7 @@ namespace bengine {
              * \param dst The portion of the window/dummy texture to copy to (px for all 4 metrics)  (will stretch the texture to fill the given rectangle)
              */
             void render_basic_texture(const bengine::basic_texture &texture, const SDL_Rect &dst) {
-                const SDL_Rect frame = texture.get_frame();
-                if (this->stretch_graphics) {
-                    const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
-                    if (SDL_RenderCopy(this->renderer, texture.get_texture(), &frame, &destination) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::basic_texture [bengine::render_window::render_basic_texture]";
-                        this->print_error();
-                    }
-                    return;
-                }
-                if (SDL_RenderCopy(this->renderer, texture.get_texture(), &frame, &dst) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::basic_texture [bengine::render_window::render_basic_texture]";
-                    this->print_error();
-                }
+                this->copy_texture(texture.get_texture(), texture.get_frame(), dst, 0, NULL, SDL_FLIP_NONE, "render bengine::basic_texture", "render_basic_texture");
             }
             /** Render a bengine::basic_texture while also applying rotations/reflections
              * \param texture The bengine::basic_texture to render
@@ -875,19 +1218,7 @@ namespace bengine {
              * \param flip How to flip the rectangle (SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL can be OR'd together)
              */
             void render_basic_texture(const bengine::basic_texture &texture, const SDL_Rect &dst, const double &angle, const SDL_Point &pivot, const SDL_RendererFlip &flip) {
-                const SDL_Rect frame = texture.get_frame();
-                if (this->stretch_graphics) {
-                    const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
-                    if (SDL_RenderCopyEx(this->renderer, texture.get_texture(), &frame, &destination, -angle, &pivot, flip) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::basic_texture [bengine::render_window::render_basic_texture]";
-                        this->print_error();
-                    }
-                    return;
-                }
-                if (SDL_RenderCopyEx(this->renderer, texture.get_texture(), &frame, &dst, -angle, &pivot, flip) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::basic_texture [bengine::render_window::render_basic_texture]";
-                    this->print_error();
-                }
+                this->copy_texture(texture.get_texture(), texture.get_frame(), dst, angle, &pivot, flip, "render bengine::basic_texture", "render_basic_texture");
             }
 
             /** Render a bengine::modded_texture
@@ -895,19 +1226,7 @@ namespace bengine {
              * \param dst The portion of the window/dummy texture to copy to (px for all 4 metrics) (will stretch the texture to fill the given rectangle)
              */
             void render_modded_texture(const bengine::modded_texture &texture, const SDL_Rect &dst) {
-                const SDL_Rect frame = texture.get_frame();
-                if (this->stretch_graphics) {
-                    const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
-                    if (SDL_RenderCopy(this->renderer, texture.get_texture(), &frame, &destination) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::modded_texture [bengine::render_window::render_modded_texture]";
-                        this->print_error();
-                    }
-                    return;
-                }
-                if (SDL_RenderCopy(this->renderer, texture.get_texture(), &frame, &dst) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::modded_texture [bengine::render_window::render_modded_texture]";
-                    this->print_error();
-                }
+                this->copy_texture(texture.get_texture(), texture.get_frame(), dst, 0, NULL, SDL_FLIP_NONE, "render bengine::modded_texture", "render_modded_texture");
             }
             /** Render a bengine::modded_texture while also applying rotations/reflections
              * \param texture The bengine::modded_texture to render
@@ -917,19 +1236,7 @@ namespace bengine {
              * \param flip How to flip the rectangle (SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL can be OR'd together)
              */
             void render_modded_texture(const bengine::modded_texture &texture, const SDL_Rect &dst, const double &angle, const SDL_Point &pivot, const SDL_RendererFlip &flip) {
-                const SDL_Rect frame = texture.get_frame();
-                if (this->stretch_graphics) {
-                    const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
-                    if (SDL_RenderCopyEx(this->renderer, texture.get_texture(), &frame, &destination, -angle, &pivot, flip) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::modded_texture [bengine::render_window::render_modded_texture]";
-                        this->print_error();
-                    }
-                    return;
-                }
-                if (SDL_RenderCopyEx(this->renderer, texture.get_texture(), &frame, &dst, -angle, &pivot, flip) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::modded_texture [bengine::render_window::render_modded_texture]";
-                    this->print_error();
-                }
+                this->copy_texture(texture.get_texture(), texture.get_frame(), dst, angle, &pivot, flip, "render bengine::modded_texture", "render_modded_texture");
             }
 
             /** Render a bengine::shifting_texture
@@ -937,23 +1244,132 @@ namespace bengine {
              * \param dst The portion of the window/dummy texture to copy to (px for all 4 metrics) (will stretch the texture to fill the given rectangle)
              */
             void render_shifting_texture(const bengine::shifting_texture &texture, const SDL_Rect &dst) {
-                const SDL_Rect frame = texture.get_frame();
                 const SDL_Point pivot = texture.get_pivot();
-                if (this->stretch_graphics) {
-                    const SDL_Rect destination = {this->stretch_x(dst.x), this->stretch_y(dst.y), this->stretch_x(dst.w), this->stretch_y(dst.h)};
-                    if (SDL_RenderCopyEx(this->renderer, texture.get_texture(), &frame, &destination, -texture.get_angle(), &pivot, texture.get_flip()) != 0) {
-                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::shifting_texture [bengine::render_window::render_shifting_texture]";
-                        this->print_error();
+                this->copy_texture(texture.get_texture(), texture.get_frame(), dst, texture.get_angle(), &pivot, texture.get_flip(), "render bengine::shifting_texture", "render_shifting_texture");
+            }
+
+            /** Render every sprite in a bengine::sprite_batch, using one SDL_RenderGeometry call per texture instead of one SDL_RenderCopyEx per sprite
+             * \param batch The sprites to render (they stay in the batch, so a batch that doesn't change can be rendered every frame)
+             */
+            void render_sprite_batch(bengine::sprite_batch &batch) {
+                const std::size_t group_count = batch.build(this->viewport);
+                if (this->deferred_rendering) {
+                    const std::vector<bengine::sprite_batch::group> &groups = batch.get_groups();
+                    for (std::size_t i = 0; i < group_count; i++) {
+                        this->draw_commands.add_quads(this->draw_layer, groups[i].texture, groups[i].blend_mode, groups[i].vertices.data(), groups[i].vertices.size() / 4);
                     }
                     return;
                 }
-                if (SDL_RenderCopyEx(this->renderer, texture.get_texture(), &frame, &dst, -texture.get_angle(), &pivot, texture.get_flip()) != 0) {
-                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render bengine::shifting_texture [bengine::render_window::render_shifting_texture]";
+                this->draw_call_count += group_count;
+                if (batch.submit(this->renderer) != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render a sprite batch [bengine::render_window::render_sprite_batch]";
                     this->print_error();
                 }
             }
 
-            /** Render text using a TTF_Font based off of a point (supports most unicode characters)
+            /** Render every live particle of a bengine::particle_system as a solid square, all in a single SDL_RenderGeometry call (or a single deferred draw call); particles that are off of the renderer's output aren't sent at all
+             * \param particles The particles to render
+             * \param size The width and height of each square relative to the base dimensions (px)
+             * \param fade Whether particles fade out as they age (their alpha goes down to 0 at the end of their lifetimes)
+             */
+            void render_particles(const bengine::particle_system &particles, const float &size = 2, const bool &fade = false) {
+                const std::size_t count = particles.get_count();
+                const float *x_pos = particles.get_x_positions(), *y_pos = particles.get_y_positions(), *ages = particles.get_ages(), *lifetimes = particles.get_lifetimes();
+                const std::uint32_t *colors = particles.get_colors();
+                const float half_width = size * this->viewport.get_x_scale() / 2, half_height = size * this->viewport.get_y_scale() / 2;
+                int output_width, output_height;
+                if (this->use_logical_size && this->stretch_graphics && this->base_width > 0 && this->base_height > 0) {
+                    // SDL scales logical coordinates to the output itself, so what can be seen is the base dimensions
+                    output_width = this->base_width;
+                    output_height = this->base_height;
+                } else if (SDL_GetRendererOutputSize(this->renderer, &output_width, &output_height) != 0) {
+                    output_width = this->width;
+                    output_height = this->height;
+                }
+
+                this->particle_vertices.resize(count * 4);
+                std::size_t quad_count = 0;
+                for (std::size_t i = 0; i < count; i++) {
+                    const SDL_FPoint center = this->viewport.apply(x_pos[i], y_pos[i]);
+                    if (center.x + half_width < 0 || center.y + half_height < 0 || center.x - half_width > output_width || center.y - half_height > output_height) {
+                        continue;
+                    }
+                    SDL_Color color = {static_cast<Uint8>(colors[i] >> 16), static_cast<Uint8>(colors[i] >> 8), static_cast<Uint8>(colors[i]), static_cast<Uint8>(colors[i] >> 24)};
+                    if (fade && lifetimes[i] > 0) {
+                        const float remaining = 1 - ages[i] / lifetimes[i];
+                        color.a = remaining > 0 ? static_cast<Uint8>(color.a * remaining) : 0;
+                    }
+                    SDL_Vertex *quad = &this->particle_vertices[quad_count++ * 4];
+                    quad[0] = {{center.x - half_width, center.y - half_height}, color, {0, 0}};
+                    quad[1] = {{center.x + half_width, center.y - half_height}, color, {0, 0}};
+                    quad[2] = {{center.x + half_width, center.y + half_height}, color, {0, 0}};
+                    quad[3] = {{center.x - half_width, center.y + half_height}, color, {0, 0}};
+                }
+                if (quad_count == 0) {
+                    return;
+                }
+                if (this->deferred_rendering) {
+                    this->draw_commands.add_quads(this->draw_layer, NULL, SDL_BLENDMODE_BLEND, this->particle_vertices.data(), quad_count);
+                    return;
+                }
+
+                // the index pattern is the same for every quad, so it only needs to grow
+                for (int quad = this->particle_indices.size() / 6; quad < static_cast<int>(quad_count); quad++) {
+                    this->particle_indices.insert(this->particle_indices.end(), {quad * 4, quad * 4 + 1, quad * 4 + 2, quad * 4, quad * 4 + 2, quad * 4 + 3});
+                }
+                // untextured geometry blends with the renderer's drawing blend mode
+                SDL_SetRenderDrawBlendMode(this->renderer, SDL_BLENDMODE_BLEND);
+                this->draw_call_count++;
+                if (SDL_RenderGeometry(this->renderer, NULL, this->particle_vertices.data(), quad_count * 4, this->particle_indices.data(), quad_count * 6) != 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render particles [bengine::render_window::render_particles]";
+                    this->print_error();
+                }
+                SDL_SetRenderDrawBlendMode(this->renderer, this->draw_blend_mode);
+            }
+
+            /** Render a bengine::tilemap, re-rendering only the visible chunks that changed and then copying each visible chunk once
+             * \param map The tilemap to render
+             * \param x x-position of the map's top-left corner relative to the base dimensions (px) (negative to scroll right)
+             * \param y y-position of the map's top-left corner relative to the base dimensions (px) (negative to scroll down)
+             */
+            void render_tilemap(bengine::tilemap &map, const int &x, const int &y) {
+                const int visible_width = this->stretch_graphics ? this->base_width : this->width;
+                const int visible_height = this->stretch_graphics ? this->base_height : this->height;
+                if (map.update(this->renderer, {-x, -y, visible_width, visible_height}, this->chunk_views) < 0) {
+                    std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to update a tilemap [bengine::render_window::render_tilemap]";
+                    this->print_error();
+                }
+                // re-rendering chunks switched targets, which drops the clip rectangle
+                if (this->clipping) {
+                    SDL_RenderSetClipRect(this->renderer, &this->clip_rectangle);
+                }
+                for (std::size_t i = 0; i < this->chunk_views.size(); i++) {
+                    const bengine::tilemap::chunk_view &view = this->chunk_views[i];
+                    this->copy_texture(view.texture, view.src, {view.dst.x + x, view.dst.y + y, view.dst.w, view.dst.h}, 0, NULL, SDL_FLIP_NONE, "render a tilemap chunk", "render_tilemap");
+                }
+            }
+
+            /** Get the manager that loads textures by path and shares them (for acquiring textures or changing its memory budget)
+             * \returns The window's texture manager
+             */
+            bengine::texture_manager& get_texture_manager() {
+                return this->textures;
+            }
+
+            /** Get the cache used for drawing text (for changing its capacity or forgetting a font before closing it)
+             * \returns The window's text cache
+             */
+            bengine::text_cache& get_text_cache() {
+                return this->text;
+            }
+            /** Get the text cache's hit counts and how long text took during the last presented frame
+             * \returns The text counts of the last presented frame
+             */
+            bengine::text_cache::statistics get_text_statistics() const {
+                return this->text.get_frame_statistics();
+            }
+
+            /** Render text using a TTF_Font based off of a point (supports most unicode characters); the rendered text is cached, so this suits text that doesn't change often
              * \param font The TTF_Font to use (represents both the font and size of the font)
              * \param text The text to display (literals are written as u"[text]", std::u16_string is useful too)
              * \param x x-position of the top-left corner of the text (px)
@@ -962,32 +1378,56 @@ namespace bengine {
              * \param color The color to fill the circle with as an SDL_Color
              */
             void render_text(TTF_Font *font, const char16_t *text, const int &x, const int &y, const Uint32 &wrapWidth = 0, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                SDL_Surface *surface = TTF_RenderUNICODE_Blended_Wrapped(font, (Uint16*)text, color, wrapWidth);
-
-                const SDL_Rect src = {0, 0, surface->w, surface->h};
-                const SDL_Rect dst = {x, y, surface->w, surface->h};
-                this->render_SDLTexture(SDL_CreateTextureFromSurface(this->renderer, surface), src, dst);
-                
-                SDL_FreeSurface(surface);
-                surface = nullptr;
+                this->text.start_timer();
+                int width, height;
+                SDL_Texture *texture = this->text.get_string(font, text, color, wrapWidth, width, height);
+                if (texture != NULL) {
+                    const SDL_Rect src = {0, 0, width, height};
+                    const SDL_Rect dst = {x, y, width, height};
+                    this->render_SDLTexture(texture, src, dst);
+                }
+                this->text.stop_timer();
             }
-            /** Render text using a TTF_Font based off of a point (supports most unicode characters)
+            /** Render text using a TTF_Font based off of a point (supports most unicode characters); the rendered text is cached, so this suits text that doesn't change often
              * \param font The TTF_Font to use (represents both the font and size of the font)
              * \param text The text to display (literals are written as u"[text]", std::u16_string is useful too)
              * \param dst The portion of the window/dummy texture to copy to (px for all 4 metrics) (will stretch the text to fill the given rectangle)
              * \param color The color to fill the circle with as an SDL_Color
              */
             void render_text(TTF_Font *font, const char16_t *text, const SDL_Rect &dst, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
-                SDL_Surface *surface = TTF_RenderUNICODE_Blended_Wrapped(font, (Uint16*)text, color, dst.w);
-                SDL_Texture *texture = SDL_CreateTextureFromSurface(this->renderer, surface);
-                
-                const SDL_Rect src = {0, 0, surface->w, surface->h};
-                this->render_SDLTexture(texture, src, dst);
-
-                SDL_FreeSurface(surface);
-                SDL_DestroyTexture(texture);
-                surface = nullptr;
-                texture = nullptr;
+                this->text.start_timer();
+                int width, height;
+                SDL_Texture *texture = this->text.get_string(font, text, color, dst.w, width, height);
+                if (texture != NULL) {
+                    const SDL_Rect src = {0, 0, width, height};
+                    this->render_SDLTexture(texture, src, dst);
+                }
+                this->text.stop_timer();
+            }
+            /** Render text one glyph at a time out of a glyph atlas, submitting every glyph in a single call; suits text that changes every frame (counters, timers, etc.)
+             * \param font The TTF_Font to use (represents both the font and size of the font)
+             * \param text The text to display (literals are written as u"[text]", '\n' starts a new line)
+             * \param x x-position of the top-left corner of the text (px)
+             * \param y y-position of the top-left corner of the text (px)
+             * \param wrapWidth The maximum width for the text before wrapping at a space (px) (a width of zero prevents any wrapping)
+             * \param color The color of the text as an SDL_Color
+             */
+            void render_glyph_text(TTF_Font *font, const char16_t *text, const int &x, const int &y, const Uint32 &wrapWidth = 0, const SDL_Color &color = bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE)) {
+                this->text.start_timer();
+                const SDL_FPoint position = this->viewport.apply(x, y);
+                const std::vector<bengine::text_cache::glyph_batch> &batches = this->text.layout_glyphs(font, text, position.x, position.y, wrapWidth, color, this->viewport.get_x_scale(), this->viewport.get_y_scale());
+                if (this->deferred_rendering) {
+                    for (std::size_t i = 0; i < batches.size(); i++) {
+                        this->draw_commands.add_quads(this->draw_layer, batches[i].texture, SDL_BLENDMODE_BLEND, batches[i].vertices.data(), batches[i].vertices.size() / 4);
+                    }
+                } else {
+                    this->draw_call_count += batches.size();
+                    if (this->text.submit_glyphs() != 0) {
+                        std::cout << "Window \"" << SDL_GetWindowTitle(this->window) << "\" failed to render glyphs [bengine::render_window::render_glyph_text]";
+                        this->print_error();
+                    }
+                }
+                this->text.stop_timer();
             }
     };
     const SDL_Color bengine::render_window::preset_colors[16] = {
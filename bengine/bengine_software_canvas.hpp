@@ -0,0 +1,479 @@
+#ifndef BENGINE_SOFTWARE_CANVAS_hpp
+#define BENGINE_SOFTWARE_CANVAS_hpp
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__AVX2__) && !defined(BENGINE_SOFTWARE_CANVAS_SCALAR)
+#include <immintrin.h>
+#elif defined(__SSE2__) && !defined(BENGINE_SOFTWARE_CANVAS_SCALAR)
+#include <emmintrin.h>
+#endif
+
+#include "bengine_circle_shapes.hpp"
+
+namespace bengine {
+    /** A pure-CPU drawing target made of ARGB8888 pixels with the same drawing methods as bengine::render_window (minus stretching)
+     * Every blending path does the exact same integer math whether it runs through AVX2, SSE2, or plain C++ (define BENGINE_SOFTWARE_CANVAS_SCALAR to force the latter), so output is pixel-exact on every machine; useful for headless simulations and golden-image checks
+     * Only SDL_BLENDMODE_NONE and SDL_BLENDMODE_BLEND are supported
+     */
+    class software_canvas {
+        private:
+            int width = 0;
+            int height = 0;
+            // \brief The pixels as 0xAARRGGBB, row after row
+            std::vector<Uint32> pixels;
+            // \brief The blend mode used for shapes
+            SDL_BlendMode blend_mode = SDL_BLENDMODE_BLEND;
+
+            bengine::circle_shape_cache circle_cache;
+            // \brief Scratch space for a single row of source pixels (reused between calls)
+            std::vector<Uint32> row_buffer;
+
+            static Uint32 pack(const SDL_Color &color) {
+                return static_cast<Uint32>(color.a) << 24 | static_cast<Uint32>(color.r) << 16 | static_cast<Uint32>(color.g) << 8 | color.b;
+            }
+            // \brief x / 255 rounded to the nearest integer, exact for every x up to 255 * 255 + 255 * 255 (and the same formula the SIMD paths use)
+            static Uint32 divide_255(const Uint32 &x) {
+                const Uint32 t = x + 128;
+                return (t + (t >> 8)) >> 8;
+            }
+
+            /** Color-mod a span of pixels and blend it onto a row of the canvas
+             * \param source The pixels to draw
+             * \param destination The pixels to draw onto
+             * \param count The amount of pixels
+             * \param mod The color mod as 0xAARRGGBB (0xFFFFFFFF changes nothing)
+             * \param blend Whether to alpha blend (true) or overwrite (false)
+             */
+            static void blend_span(const Uint32 *source, Uint32 *destination, const int &count, const Uint32 &mod, const bool &blend) {
+                int i = 0;
+#if defined(__AVX2__) && !defined(BENGINE_SOFTWARE_CANVAS_SCALAR)
+                const __m256i zero = _mm256_setzero_si256();
+                const __m256i rounding = _mm256_set1_epi16(128);
+                const __m256i mod16 = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(mod)), zero);
+                const __m256i max = _mm256_set1_epi16(255);
+                const __m256i alpha_lanes = _mm256_set1_epi64x(static_cast<long long>(0xFFFF000000000000ull));
+                for (; i + 8 <= count; i += 8) {
+                    const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+                    __m256i s_lo = _mm256_unpacklo_epi8(s, zero), s_hi = _mm256_unpackhi_epi8(s, zero);
+                    if (mod != 0xFFFFFFFF) {
+                        s_lo = _mm256_add_epi16(_mm256_mullo_epi16(s_lo, mod16), rounding);
+                        s_lo = _mm256_srli_epi16(_mm256_add_epi16(s_lo, _mm256_srli_epi16(s_lo, 8)), 8);
+                        s_hi = _mm256_add_epi16(_mm256_mullo_epi16(s_hi, mod16), rounding);
+                        s_hi = _mm256_srli_epi16(_mm256_add_epi16(s_hi, _mm256_srli_epi16(s_hi, 8)), 8);
+                    }
+                    if (blend) {
+                        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destination + i));
+                        const __m256i d_lo = _mm256_unpacklo_epi8(d, zero), d_hi = _mm256_unpackhi_epi8(d, zero);
+                        // each pixel's alpha spread over its color lanes, with 255 in its own alpha lane (so alpha comes out as src + dst * (1 - src))
+                        const __m256i a_lo = _mm256_or_si256(_mm256_andnot_si256(alpha_lanes, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_lo, 0xFF), 0xFF)), _mm256_and_si256(alpha_lanes, max));
+                        const __m256i a_hi = _mm256_or_si256(_mm256_andnot_si256(alpha_lanes, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_hi, 0xFF), 0xFF)), _mm256_and_si256(alpha_lanes, max));
+                        const __m256i inverse_lo = _mm256_sub_epi16(max, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_lo, 0xFF), 0xFF));
+                        const __m256i inverse_hi = _mm256_sub_epi16(max, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_hi, 0xFF), 0xFF));
+                        s_lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s_lo, a_lo), _mm256_mullo_epi16(d_lo, inverse_lo)), rounding);
+                        s_lo = _mm256_srli_epi16(_mm256_add_epi16(s_lo, _mm256_srli_epi16(s_lo, 8)), 8);
+                        s_hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s_hi, a_hi), _mm256_mullo_epi16(d_hi, inverse_hi)), rounding);
+                        s_hi = _mm256_srli_epi16(_mm256_add_epi16(s_hi, _mm256_srli_epi16(s_hi, 8)), 8);
+                    }
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_packus_epi16(s_lo, s_hi));
+                }
+#elif defined(__SSE2__) && !defined(BENGINE_SOFTWARE_CANVAS_SCALAR)
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i rounding = _mm_set1_epi16(128);
+                const __m128i mod16 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(mod)), zero);
+                const __m128i max = _mm_set1_epi16(255);
+                const __m128i alpha_lanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+                for (; i + 4 <= count; i += 4) {
+                    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+                    __m128i s_lo = _mm_unpacklo_epi8(s, zero), s_hi = _mm_unpackhi_epi8(s, zero);
+                    if (mod != 0xFFFFFFFF) {
+                        s_lo = _mm_add_epi16(_mm_mullo_epi16(s_lo, mod16), rounding);
+                        s_lo = _mm_srli_epi16(_mm_add_epi16(s_lo, _mm_srli_epi16(s_lo, 8)), 8);
+                        s_hi = _mm_add_epi16(_mm_mullo_epi16(s_hi, mod16), rounding);
+                        s_hi = _mm_srli_epi16(_mm_add_epi16(s_hi, _mm_srli_epi16(s_hi, 8)), 8);
+                    }
+                    if (blend) {
+                        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i));
+                        const __m128i d_lo = _mm_unpacklo_epi8(d, zero), d_hi = _mm_unpackhi_epi8(d, zero);
+                        // each pixel's alpha spread over its color lanes, with 255 in its own alpha lane (so alpha comes out as src + dst * (1 - src))
+                        const __m128i a_lo = _mm_or_si128(_mm_andnot_si128(alpha_lanes, _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0xFF), 0xFF)), _mm_and_si128(alpha_lanes, max));
+                        const __m128i a_hi = _mm_or_si128(_mm_andnot_si128(alpha_lanes, _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0xFF), 0xFF)), _mm_and_si128(alpha_lanes, max));
+                        const __m128i inverse_lo = _mm_sub_epi16(max, _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0xFF), 0xFF));
+                        const __m128i inverse_hi = _mm_sub_epi16(max, _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0xFF), 0xFF));
+                        s_lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s_lo, a_lo), _mm_mullo_epi16(d_lo, inverse_lo)), rounding);
+                        s_lo = _mm_srli_epi16(_mm_add_epi16(s_lo, _mm_srli_epi16(s_lo, 8)), 8);
+                        s_hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s_hi, a_hi), _mm_mullo_epi16(d_hi, inverse_hi)), rounding);
+                        s_hi = _mm_srli_epi16(_mm_add_epi16(s_hi, _mm_srli_epi16(s_hi, 8)), 8);
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(s_lo, s_hi));
+                }
+#endif
+                // whatever the vector paths didn't cover (or everything, without them)
+                const Uint32 mod_channels[4] = {mod & 0xFF, (mod >> 8) & 0xFF, (mod >> 16) & 0xFF, mod >> 24};
+                for (; i < count; i++) {
+                    Uint32 channels[4] = {source[i] & 0xFF, (source[i] >> 8) & 0xFF, (source[i] >> 16) & 0xFF, source[i] >> 24};
+                    if (mod != 0xFFFFFFFF) {
+                        for (unsigned char c = 0; c < 4; c++) {
+                            channels[c] = bengine::software_canvas::divide_255(channels[c] * mod_channels[c]);
+                        }
+                    }
+                    if (blend) {
+                        const Uint32 alpha = channels[3], inverse = 255 - alpha;
+                        for (unsigned char c = 0; c < 4; c++) {
+                            channels[c] = bengine::software_canvas::divide_255(channels[c] * (c == 3 ? 255 : alpha) + ((destination[i] >> (c * 8)) & 0xFF) * inverse);
+                        }
+                    }
+                    destination[i] = channels[3] << 24 | channels[2] << 16 | channels[1] << 8 | channels[0];
+                }
+            }
+
+            /** Fill a horizontal span with a color, clipped to the canvas
+             * \param x1 x-position of the leftmost pixel
+             * \param x2 x-position of the rightmost pixel
+             * \param y y-position of the span
+             * \param color The color packed as 0xAARRGGBB
+             */
+            void fill_span(int x1, int x2, const int &y, const Uint32 &color) {
+                if (y < 0 || y >= this->height) {
+                    return;
+                }
+                x1 = x1 < 0 ? 0 : x1;
+                x2 = x2 >= this->width ? this->width - 1 : x2;
+                if (x1 > x2) {
+                    return;
+                }
+                Uint32 *row = this->pixels.data() + static_cast<std::size_t>(y) * this->width;
+                if (this->blend_mode == SDL_BLENDMODE_NONE || (color >> 24) == 255) {
+                    std::fill(row + x1, row + x2 + 1, color);
+                    return;
+                }
+                this->row_buffer.assign(x2 - x1 + 1, color);
+                bengine::software_canvas::blend_span(this->row_buffer.data(), row + x1, x2 - x1 + 1, 0xFFFFFFFF, true);
+            }
+            void put_pixel(const int &x, const int &y, const Uint32 &color) {
+                this->fill_span(x, x, y, color);
+            }
+
+        public:
+            /** bengine::software_canvas constructor
+             * \param width The width of the canvas (px)
+             * \param height The height of the canvas (px)
+             * \param color The color to start out as
+             */
+            software_canvas(const int &width = 0, const int &height = 0, const SDL_Color &color = {0, 0, 0, 0}) {
+                this->resize(width, height, color);
+            }
+            // \brief bengine::software_canvas deconstructor
+            ~software_canvas() {}
+
+            /** Change the size of the canvas, clearing it
+             * \param width The new width of the canvas (px)
+             * \param height The new height of the canvas (px)
+             * \param color The color to clear to
+             */
+            void resize(const int &width, const int &height, const SDL_Color &color = {0, 0, 0, 0}) {
+                this->width = width > 0 ? width : 0;
+                this->height = height > 0 ? height : 0;
+                this->pixels.assign(static_cast<std::size_t>(this->width) * this->height, bengine::software_canvas::pack(color));
+            }
+            /** Get the width of the canvas
+             * \returns The width of the canvas (px)
+             */
+            int get_width() const {
+                return this->width;
+            }
+            /** Get the height of the canvas
+             * \returns The height of the canvas (px)
+             */
+            int get_height() const {
+                return this->height;
+            }
+            /** Get the canvas's pixels as 0xAARRGGBB (SDL_PIXELFORMAT_ARGB8888), row after row with a pitch of width * 4 bytes
+             * \returns The canvas's pixels
+             */
+            const Uint32* get_pixels() const {
+                return this->pixels.data();
+            }
+            /** Get a single pixel
+             * \param x x-position of the pixel
+             * \param y y-position of the pixel
+             * \returns The pixel's color (transparent black if the position is off of the canvas)
+             */
+            SDL_Color get_pixel(const int &x, const int &y) const {
+                if (x < 0 || y < 0 || x >= this->width || y >= this->height) {
+                    return {0, 0, 0, 0};
+                }
+                const Uint32 pixel = this->pixels[static_cast<std::size_t>(y) * this->width + x];
+                return {static_cast<Uint8>(pixel >> 16), static_cast<Uint8>(pixel >> 8), static_cast<Uint8>(pixel), static_cast<Uint8>(pixel >> 24)};
+            }
+
+            /** Get the blend mode used for shapes
+             * \returns The blend mode used for shapes
+             */
+            SDL_BlendMode get_draw_blend_mode() const {
+                return this->blend_mode;
+            }
+            /** Set the blend mode used for shapes (SDL_BLENDMODE_NONE or SDL_BLENDMODE_BLEND)
+             * \param blend_mode The blend mode to use for shapes
+             */
+            void set_draw_blend_mode(const SDL_BlendMode &blend_mode) {
+                this->blend_mode = blend_mode == SDL_BLENDMODE_NONE ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND;
+            }
+
+            /** Clear the whole canvas to a color (ignores the blend mode)
+             * \param color The color to clear to
+             */
+            void clear(const SDL_Color &color = {0, 0, 0, 255}) {
+                std::fill(this->pixels.begin(), this->pixels.end(), bengine::software_canvas::pack(color));
+            }
+            /** Draw a singular pixel
+             * \param x x-position of the pixel (px)
+             * \param y y-position of the pixel (px)
+             * \param color The color to draw with
+             */
+            void draw_pixel(const int &x, const int &y, const SDL_Color &color = {255, 255, 255, 255}) {
+                this->put_pixel(x, y, bengine::software_canvas::pack(color));
+            }
+            /** Draw a line (Bresenham's, with both end points included)
+             * \param x1 x-position of the starting point (px)
+             * \param y1 y-position of the starting point (px)
+             * \param x2 x-position of the ending point (px)
+             * \param y2 y-position of the ending point (px)
+             * \param color The color to draw with
+             */
+            void draw_line(int x1, int y1, const int &x2, const int &y2, const SDL_Color &color = {255, 255, 255, 255}) {
+                const Uint32 packed = bengine::software_canvas::pack(color);
+                if (y1 == y2) {
+                    this->fill_span(x1 < x2 ? x1 : x2, x1 < x2 ? x2 : x1, y1, packed);
+                    return;
+                }
+                const int dx = x2 > x1 ? x2 - x1 : x1 - x2, dy = y2 > y1 ? y1 - y2 : y2 - y1;
+                const int step_x = x1 < x2 ? 1 : -1, step_y = y1 < y2 ? 1 : -1;
+                int error = dx + dy;
+                while (true) {
+                    this->put_pixel(x1, y1, packed);
+                    if (x1 == x2 && y1 == y2) {
+                        break;
+                    }
+                    const int error_2 = error * 2;
+                    if (error_2 >= dy) {
+                        error += dy;
+                        x1 += step_x;
+                    }
+                    if (error_2 <= dx) {
+                        error += dx;
+                        y1 += step_y;
+                    }
+                }
+            }
+            /** Fill a rectangle
+             * \param x x-position of the top-left corner (px) (assuming positive width and height)
+             * \param y y-position of the top-left corner (px) (assuming positive width and height)
+             * \param w Width of the rectangle (px) (can be negative, thereby making the "x" parameter reference the right side of the rectangle)
+             * \param h Height of the rectangle (px) (can be negative, thereby making the "y" parameter reference the bottom side of the rectangle)
+             * \param color The color to fill with
+             */
+            void fill_rectangle(const int &x, const int &y, const int &w, const int &h, const SDL_Color &color = {255, 255, 255, 255}) {
+                const int left = w < 0 ? x + w : x, top = h < 0 ? y + h : y, width = w < 0 ? -w : w, height = h < 0 ? -h : h;
+                const Uint32 packed = bengine::software_canvas::pack(color);
+                for (int row = top < 0 ? 0 : top; row < top + height && row < this->height; row++) {
+                    this->fill_span(left, left + width - 1, row, packed);
+                }
+            }
+            /** Draw a rectangle (not filled, will only draw the perimeter)
+             * \param x x-position of the top-left corner (px) (assuming positive width and height)
+             * \param y y-position of the top-left corner (px) (assuming positive width and height)
+             * \param w Width of the rectangle (px) (can be negative)
+             * \param h Height of the rectangle (px) (can be negative)
+             * \param color The color to draw with
+             */
+            void draw_rectangle(const int &x, const int &y, const int &w, const int &h, const SDL_Color &color = {255, 255, 255, 255}) {
+                if (w == 0 || h == 0) {
+                    return;
+                }
+                const int left = w < 0 ? x + w : x, top = h < 0 ? y + h : y, width = w < 0 ? -w : w, height = h < 0 ? -h : h;
+                this->fill_rectangle(left, top, width, 1, color);
+                if (height > 1) {
+                    this->fill_rectangle(left, top + height - 1, width, 1, color);
+                }
+                if (height > 2) {
+                    this->fill_rectangle(left, top + 1, 1, height - 2, color);
+                    this->fill_rectangle(left + width - 1, top + 1, 1, height - 2, color);
+                }
+            }
+            /** Draw a circle (not filled, will only draw the perimeter); matches bengine::render_window::draw_circle() pixel for pixel
+             * \param x x-position of the center of the circle (px)
+             * \param y y-position of the center of the circle (px)
+             * \param r Radius of the circle (px)
+             * \param color The color to draw with
+             */
+            void draw_circle(const int &x, const int &y, const int &r, const SDL_Color &color = {255, 255, 255, 255}) {
+                if (r < 0) {
+                    return;
+                }
+                const Uint32 packed = bengine::software_canvas::pack(color);
+                // a circle without a radius is just its center
+                if (r == 0) {
+                    this->put_pixel(x, y, packed);
+                    return;
+                }
+                const std::vector<SDL_Point> &outline = this->circle_cache.get(r).outline;
+                for (std::size_t i = 0; i < outline.size(); i++) {
+                    this->put_pixel(x + outline[i].x, y + outline[i].y, packed);
+                }
+            }
+            /** Fill a circle; matches bengine::render_window::fill_circle() pixel for pixel
+             * \param x x-position of the center of the circle (px)
+             * \param y y-position of the center of the circle (px)
+             * \param r Radius of the circle (px)
+             * \param color The color to fill with
+             */
+            void fill_circle(const int &x, const int &y, const int &r, const SDL_Color &color = {255, 255, 255, 255}) {
+                if (r < 0) {
+                    return;
+                }
+                const Uint32 packed = bengine::software_canvas::pack(color);
+                if (r == 0) {
+                    this->put_pixel(x, y, packed);
+                    return;
+                }
+                const std::vector<int> &half_widths = this->circle_cache.get(r).half_widths;
+                for (int row = 0; row <= r * 2; row++) {
+                    if (half_widths[row] >= 0) {
+                        this->fill_span(x - half_widths[row], x + half_widths[row], y + row - r, packed);
+                    }
+                }
+            }
+
+            /** Copy (part of) another canvas onto this one, scaling with nearest-neighbour sampling
+             * \param source The canvas to copy from
+             * \param src The portion of the source to copy (px)
+             * \param dst Where to copy it to (px) (stretches to fill)
+             * \param color_mod The color mod to apply to the source (alpha included)
+             * \param blend_mode SDL_BLENDMODE_BLEND to alpha blend or SDL_BLENDMODE_NONE to overwrite
+             */
+            void render_canvas(const bengine::software_canvas &source, const SDL_Rect &src, const SDL_Rect &dst, const SDL_Color &color_mod = {255, 255, 255, 255}, const SDL_BlendMode &blend_mode = SDL_BLENDMODE_BLEND) {
+                if (src.w <= 0 || src.h <= 0 || dst.w <= 0 || dst.h <= 0 || src.x < 0 || src.y < 0 || src.x + src.w > source.width || src.y + src.h > source.height) {
+                    return;
+                }
+                const Uint32 mod = bengine::software_canvas::pack(color_mod);
+                const bool blend = blend_mode != SDL_BLENDMODE_NONE;
+                // 16.16 fixed-point steps through the source, sampling pixel centers
+                const std::int64_t step_x = (static_cast<std::int64_t>(src.w) << 16) / dst.w, step_y = (static_cast<std::int64_t>(src.h) << 16) / dst.h;
+                const int x1 = dst.x < 0 ? 0 : dst.x, x2 = dst.x + dst.w > this->width ? this->width : dst.x + dst.w;
+                const int y1 = dst.y < 0 ? 0 : dst.y, y2 = dst.y + dst.h > this->height ? this->height : dst.y + dst.h;
+                if (x1 >= x2 || y1 >= y2) {
+                    return;
+                }
+                this->row_buffer.resize(x2 - x1);
+
+                for (int y = y1; y < y2; y++) {
+                    const int source_y = src.y + static_cast<int>(((y - dst.y) * step_y + step_y / 2) >> 16);
+                    const Uint32 *source_row = source.pixels.data() + static_cast<std::size_t>(source_y) * source.width;
+                    const Uint32 *span = this->row_buffer.data();
+                    if (step_x == 1 << 16) {
+                        span = source_row + src.x + (x1 - dst.x);
+                    } else {
+                        for (int x = x1; x < x2; x++) {
+                            this->row_buffer[x - x1] = source_row[src.x + static_cast<int>(((x - dst.x) * step_x + step_x / 2) >> 16)];
+                        }
+                    }
+                    bengine::software_canvas::blend_span(span, this->pixels.data() + static_cast<std::size_t>(y) * this->width + x1, x2 - x1, mod, blend);
+                }
+            }
+
+            /** Replace the canvas with the contents of an SDL_Surface (converted to ARGB8888)
+             * \param surface The surface to copy
+             * \returns 0 on success or -1 if the surface couldn't be converted
+             */
+            int load_surface(SDL_Surface *surface) {
+                SDL_Surface *converted = surface == NULL ? NULL : SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+                if (converted == NULL) {
+                    std::cout << "Software canvas failed to convert a surface [bengine::software_canvas::load_surface]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                    return -1;
+                }
+                this->resize(converted->w, converted->h);
+                for (int y = 0; y < this->height; y++) {
+                    std::memcpy(this->pixels.data() + static_cast<std::size_t>(y) * this->width, static_cast<const char*>(converted->pixels) + y * converted->pitch, this->width * 4);
+                }
+                SDL_FreeSurface(converted);
+                return 0;
+            }
+            /** Replace the canvas with an image file
+             * \param filepath The path to the image file
+             * \returns 0 on success or -1 if the file couldn't be loaded
+             */
+            int load_image(const std::string &filepath) {
+                SDL_Surface *surface = IMG_Load(filepath.c_str());
+                if (surface == NULL) {
+                    std::cout << "Software canvas failed to load \"" << filepath << "\" [bengine::software_canvas::load_image]\nERROR [" << SDL_GetTicks() << "]: " << IMG_GetError() << "\n";
+                    return -1;
+                }
+                const int output = this->load_surface(surface);
+                SDL_FreeSurface(surface);
+                return output;
+            }
+            /** Save the canvas as a PNG
+             * \param filepath Where to save the image
+             * \returns 0 on success or -1 on failure
+             */
+            int save_png(const std::string &filepath) {
+                SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(this->pixels.data(), this->width, this->height, 32, this->width * 4, SDL_PIXELFORMAT_ARGB8888);
+                const int output = surface == NULL ? -1 : IMG_SavePNG(surface, filepath.c_str());
+                SDL_FreeSurface(surface);
+                if (output != 0) {
+                    std::cout << "Software canvas failed to save \"" << filepath << "\" [bengine::software_canvas::save_png]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                }
+                return output;
+            }
+            /** Copy the canvas into a texture (such as a streaming texture used to show it in a bengine::render_window)
+             * \param texture A texture of the same size as the canvas in SDL_PIXELFORMAT_ARGB8888
+             * \returns 0 on success or a negative error code on failure
+             */
+            int update_texture(SDL_Texture *texture) const {
+                return SDL_UpdateTexture(texture, NULL, this->pixels.data(), this->width * 4);
+            }
+
+            /** Get a hash of every pixel (FNV-1a), for quickly checking a frame against a known-good one
+             * \returns The hash of the canvas
+             */
+            std::uint64_t checksum() const {
+                std::uint64_t output = 14695981039346656037ull;
+                const unsigned char *bytes = reinterpret_cast<const unsigned char*>(this->pixels.data());
+                for (std::size_t i = 0; i < this->pixels.size() * 4; i++) {
+                    output = (output ^ bytes[i]) * 1099511628211ull;
+                }
+                return output;
+            }
+            /** Count how many pixels differ from another canvas
+             * \param other The canvas to compare against
+             * \param tolerance How far apart each channel can be while still counting as the same
+             * \returns The amount of pixels that differ (every pixel if the sizes don't match)
+             */
+            std::size_t count_mismatches(const bengine::software_canvas &other, const unsigned char &tolerance = 0) const {
+                if (this->width != other.width || this->height != other.height) {
+                    return this->pixels.size() > other.pixels.size() ? this->pixels.size() : other.pixels.size();
+                }
+                std::size_t output = 0;
+                for (std::size_t i = 0; i < this->pixels.size(); i++) {
+                    for (unsigned char c = 0; c < 4; c++) {
+                        const int a = (this->pixels[i] >> (c * 8)) & 0xFF, b = (other.pixels[i] >> (c * 8)) & 0xFF;
+                        if (a - b > tolerance || b - a > tolerance) {
+                            output++;
+                            break;
+                        }
+                    }
+                }
+                return output;
+            }
+    };
+}
+
+#endif // BENGINE_SOFTWARE_CANVAS_hpp
@@ -0,0 +1,317 @@
+#ifndef BENGINE_SPRITE_BATCH_hpp
+#define BENGINE_SPRITE_BATCH_hpp
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "bengine_texture.hpp"
+#include "bengine_viewport_transform.hpp"
+
+namespace bengine {
+    /** Collects lots of (rotated) sprites and turns them into one SDL_RenderGeometry call per texture
+     * Everything is stored as structure-of-arrays so that the rotations can be worked out for the whole batch at once (four sines/cosines at a time with SSE2) instead of SDL doing it one SDL_RenderCopyEx at a time; meant for things like thousands of projectiles
+     * Sprites are grouped by texture (keeping their order within each texture), so sprites of different textures that overlap each other should go in different batches
+     */
+    class sprite_batch {
+        public:
+            // \brief One copy of a texture
+            struct instance {
+                // \brief Where to draw the texture relative to the base dimensions (px)
+                SDL_Rect dst = {0, 0, 0, 0};
+                // \brief The angle to rotate the texture (degrees)
+                double angle = 0;
+                // \brief The point to rotate around relative to the top-left corner of the destination rectangle (px)
+                SDL_Point pivot = {0, 0};
+                // \brief How to flip the texture (SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL can be OR'd together)
+                SDL_RendererFlip flip = SDL_FLIP_NONE;
+                // \brief The color modification for the texture (alpha included)
+                SDL_Color color_mod = {255, 255, 255, 255};
+            };
+            // \brief The vertices of every sprite that shares a texture and blend mode (four per sprite, ready for SDL_RenderGeometry or bengine::draw_command_buffer::add_quads())
+            struct group {
+                SDL_Texture *texture = NULL;
+                SDL_BlendMode blend_mode = SDL_BLENDMODE_BLEND;
+                std::vector<SDL_Vertex> vertices;
+            };
+
+        private:
+            // \brief Per-sprite data, one element per sprite in each
+            std::vector<SDL_Texture*> textures;
+            std::vector<SDL_BlendMode> blend_modes;
+            std::vector<SDL_Rect> destinations;
+            std::vector<SDL_FPoint> pivots;
+            std::vector<float> angles;
+            // \brief Texture coordinates of each sprite's source frame (already flipped) as left, top, right, bottom
+            std::vector<SDL_FRect> uvs;
+            std::vector<SDL_Color> colors;
+
+            // \brief Scratch space for building the vertices (reused between calls)
+            std::vector<SDL_FRect> transformed;
+            std::vector<float> sines;
+            std::vector<float> cosines;
+            std::vector<unsigned int> order;
+            std::vector<bengine::sprite_batch::group> groups;
+            std::size_t group_count = 0;
+            std::vector<int> indices;
+
+            // \brief The last texture that was queried, since consecutive sprites usually share one
+            SDL_Texture *last_texture = NULL;
+            int last_width = 0;
+            int last_height = 0;
+
+            /** Work out where a frame of a texture is in texture coordinates
+             * \param texture The texture
+             * \param frame The frame of the texture (px)
+             * \param flip How the texture is flipped
+             * \param output Where to put the texture coordinates
+             * \returns 0 on success or -1 if the texture couldn't be queried
+             */
+            int get_uv(SDL_Texture *texture, const SDL_Rect &frame, const SDL_RendererFlip &flip, SDL_FRect &output) {
+                if (texture != this->last_texture) {
+                    if (SDL_QueryTexture(texture, NULL, NULL, &this->last_width, &this->last_height) != 0 || this->last_width == 0 || this->last_height == 0) {
+                        this->last_texture = NULL;
+                        return -1;
+                    }
+                    this->last_texture = texture;
+                }
+                // an empty frame means the entire texture (like with SDL_RenderCopy)
+                const SDL_Rect source = frame.w == 0 || frame.h == 0 ? SDL_Rect{0, 0, this->last_width, this->last_height} : frame;
+                float u1 = static_cast<float>(source.x) / this->last_width, u2 = static_cast<float>(source.x + source.w) / this->last_width;
+                float v1 = static_cast<float>(source.y) / this->last_height, v2 = static_cast<float>(source.y + source.h) / this->last_height;
+                if ((flip & SDL_FLIP_HORIZONTAL) == SDL_FLIP_HORIZONTAL) {
+                    std::swap(u1, u2);
+                }
+                if ((flip & SDL_FLIP_VERTICAL) == SDL_FLIP_VERTICAL) {
+                    std::swap(v1, v2);
+                }
+                output = {u1, v1, u2, v2};
+                return 0;
+            }
+
+            /** Work out the sines and cosines of many angles at once (accurate to within about 1e-7, which is plenty for positioning pixels)
+             * \param radians The angles (radians)
+             * \param sines Where to put the sines
+             * \param cosines Where to put the cosines
+             * \param count The amount of angles
+             */
+            static void compute_sines(const float *radians, float *sines, float *cosines, const std::size_t &count) {
+                // Cody-Waite reduction to [-pi/4, pi/4] around the nearest multiple of pi/2, then Taylor polynomials; the quadrant decides which result is which (and the signs)
+                const float two_over_pi = 0.636619772f, pi_2_high = 1.5703125f, pi_2_low = 4.83826794897e-4f;
+                std::size_t i = 0;
+#if defined(__SSE2__)
+                for (; i + 4 <= count; i += 4) {
+                    const __m128 x = _mm_loadu_ps(radians + i);
+                    const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(two_over_pi)));
+                    const __m128 q = _mm_cvtepi32_ps(quadrant);
+                    const __m128 r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(pi_2_high))), _mm_mul_ps(q, _mm_set1_ps(pi_2_low)));
+                    const __m128 r2 = _mm_mul_ps(r, r);
+
+                    __m128 s = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(-1.0f / 5040)), _mm_set1_ps(1.0f / 120));
+                    s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(-1.0f / 6));
+                    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, r2), r), r);
+                    __m128 c = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(1.0f / 40320)), _mm_set1_ps(-1.0f / 720));
+                    c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(1.0f / 24));
+                    c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(-0.5f));
+                    c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(1));
+
+                    const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+                    const __m128 sine = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+                    const __m128 cosine = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+                    // flipping the sign bit: sines are negative in quadrants 2 and 3, cosines in quadrants 1 and 2
+                    const __m128 sine_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+                    const __m128 cosine_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+                    _mm_storeu_ps(sines + i, _mm_xor_ps(sine, sine_sign));
+                    _mm_storeu_ps(cosines + i, _mm_xor_ps(cosine, cosine_sign));
+                }
+#endif
+                for (; i < count; i++) {
+                    const int quadrant = static_cast<int>(std::nearbyint(radians[i] * two_over_pi));
+                    const float r = radians[i] - quadrant * pi_2_high - quadrant * pi_2_low, r2 = r * r;
+                    const float s = ((-1.0f / 5040 * r2 + 1.0f / 120) * r2 - 1.0f / 6) * r2 * r + r;
+                    const float c = (((1.0f / 40320 * r2 - 1.0f / 720) * r2 + 1.0f / 24) * r2 - 0.5f) * r2 + 1;
+                    const float sine = (quadrant & 1) ? c : s, cosine = (quadrant & 1) ? s : c;
+                    sines[i] = (quadrant & 2) ? -sine : sine;
+                    cosines[i] = ((quadrant + 1) & 2) ? -cosine : cosine;
+                }
+            }
+
+        public:
+            // \brief bengine::sprite_batch constructor
+            sprite_batch() {}
+            // \brief bengine::sprite_batch deconstructor
+            ~sprite_batch() {}
+
+            /** Reserve room for sprites so that adding them doesn't reallocate
+             * \param count The amount of sprites to make room for
+             */
+            void reserve(const std::size_t &count) {
+                this->textures.reserve(count);
+                this->blend_modes.reserve(count);
+                this->destinations.reserve(count);
+                this->pivots.reserve(count);
+                this->angles.reserve(count);
+                this->uvs.reserve(count);
+                this->colors.reserve(count);
+            }
+            // \brief Forget every sprite (the memory is kept for the next frame)
+            void clear() {
+                this->textures.clear();
+                this->blend_modes.clear();
+                this->destinations.clear();
+                this->pivots.clear();
+                this->angles.clear();
+                this->uvs.clear();
+                this->colors.clear();
+                this->group_count = 0;
+                this->last_texture = NULL;
+            }
+            /** Get the amount of sprites in the batch
+             * \returns The amount of sprites in the batch
+             */
+            std::size_t get_sprite_count() const {
+                return this->textures.size();
+            }
+
+            /** Add many copies of one texture
+             * \param texture The texture to draw (its frame and blend mode are used; the angle, pivot, flip, and color mod come from each instance)
+             * \param instances The copies to draw
+             * \param count The amount of copies
+             * \returns 0 on success or -1 if the texture couldn't be queried
+             */
+            int add(const bengine::shifting_texture &texture, const bengine::sprite_batch::instance *instances, const std::size_t &count) {
+                SDL_FRect uv[4];
+                // the flips only change the texture coordinates, so each combination only needs working out once
+                for (unsigned char flip = 0; flip < 4; flip++) {
+                    if (this->get_uv(texture.get_texture(), texture.get_frame(), static_cast<SDL_RendererFlip>(flip), uv[flip]) != 0) {
+                        return -1;
+                    }
+                }
+                for (std::size_t i = 0; i < count; i++) {
+                    this->textures.push_back(texture.get_texture());
+                    this->blend_modes.push_back(texture.get_blend_mode());
+                    this->destinations.push_back(instances[i].dst);
+                    this->pivots.push_back({static_cast<float>(instances[i].pivot.x), static_cast<float>(instances[i].pivot.y)});
+                    this->angles.push_back(static_cast<float>(instances[i].angle));
+                    this->uvs.push_back(uv[instances[i].flip & 3]);
+                    this->colors.push_back(instances[i].color_mod);
+                }
+                return 0;
+            }
+            /** Add many copies of one texture
+             * \param texture The texture to draw (its frame and blend mode are used; the angle, pivot, flip, and color mod come from each instance)
+             * \param instances The copies to draw
+             * \returns 0 on success or -1 if the texture couldn't be queried
+             */
+            int add(const bengine::shifting_texture &texture, const std::vector<bengine::sprite_batch::instance> &instances) {
+                return this->add(texture, instances.data(), instances.size());
+            }
+            /** Add a single texture using its own angle, pivot, flip, and color mod (like bengine::render_window::render_shifting_texture())
+             * \param texture The texture to draw
+             * \param dst Where to draw the texture relative to the base dimensions (px)
+             * \returns 0 on success or -1 if the texture couldn't be queried
+             */
+            int add(const bengine::shifting_texture &texture, const SDL_Rect &dst) {
+                bengine::sprite_batch::instance sprite;
+                sprite.dst = dst;
+                sprite.angle = texture.get_angle();
+                sprite.pivot = texture.get_pivot();
+                sprite.flip = texture.get_flip();
+                sprite.color_mod = texture.get_color_mod();
+                return this->add(texture, &sprite, 1);
+            }
+
+            /** Turn every sprite into vertices grouped by texture and blend mode
+             * \param viewport The transform from the base dimensions to the renderer's output (like bengine::render_window::get_viewport())
+             * \returns The amount of groups (see bengine::sprite_batch::get_groups())
+             */
+            std::size_t build(const bengine::viewport_transform &viewport = bengine::viewport_transform()) {
+                const std::size_t count = this->textures.size();
+                this->transformed.resize(count);
+                this->sines.resize(count);
+                this->cosines.resize(count);
+                viewport.apply(this->destinations.data(), count, this->transformed.data());
+                // the angles go counter-clockwise, but y points down
+                for (std::size_t i = 0; i < count; i++) {
+                    this->sines[i] = this->angles[i] * static_cast<float>(-M_PI / 180);
+                }
+                bengine::sprite_batch::compute_sines(this->sines.data(), this->sines.data(), this->cosines.data(), count);
+
+                this->order.resize(count);
+                for (unsigned int i = 0; i < count; i++) {
+                    this->order[i] = i;
+                }
+                std::stable_sort(this->order.begin(), this->order.end(), [this](const unsigned int &a, const unsigned int &b) {
+                    return this->textures[a] != this->textures[b] ? this->textures[a] < this->textures[b] : this->blend_modes[a] < this->blend_modes[b];
+                });
+
+                this->group_count = 0;
+                for (std::size_t i = 0; i < count; i++) {
+                    const unsigned int sprite = this->order[i];
+                    if (i == 0 || this->textures[sprite] != this->textures[this->order[i - 1]] || this->blend_modes[sprite] != this->blend_modes[this->order[i - 1]]) {
+                        if (this->group_count == this->groups.size()) {
+                            this->groups.emplace_back();
+                        }
+                        bengine::sprite_batch::group &group = this->groups[this->group_count++];
+                        group.texture = this->textures[sprite];
+                        group.blend_mode = this->blend_modes[sprite];
+                        group.vertices.clear();
+                    }
+
+                    const SDL_FRect &dst = this->transformed[sprite];
+                    const SDL_FPoint offset = viewport.apply_to_offset(this->pivots[sprite].x, this->pivots[sprite].y);
+                    const float pivot_x = dst.x + offset.x, pivot_y = dst.y + offset.y, sine = this->sines[sprite], cosine = this->cosines[sprite];
+                    const float corners[4][2] = {{dst.x - pivot_x, dst.y - pivot_y}, {dst.x + dst.w - pivot_x, dst.y - pivot_y}, {dst.x + dst.w - pivot_x, dst.y + dst.h - pivot_y}, {dst.x - pivot_x, dst.y + dst.h - pivot_y}};
+                    const SDL_FRect &uv = this->uvs[sprite];
+                    const float u[4] = {uv.x, uv.w, uv.w, uv.x}, v[4] = {uv.y, uv.y, uv.h, uv.h};
+
+                    std::vector<SDL_Vertex> &vertices = this->groups[this->group_count - 1].vertices;
+                    for (unsigned char corner = 0; corner < 4; corner++) {
+                        vertices.push_back({{pivot_x + corners[corner][0] * cosine - corners[corner][1] * sine, pivot_y + corners[corner][0] * sine + corners[corner][1] * cosine}, this->colors[sprite], {u[corner], v[corner]}});
+                    }
+                }
+                return this->group_count;
+            }
+            /** Get the groups made by the last call to bengine::sprite_batch::build()
+             * \returns The groups (only the first bengine::sprite_batch::get_group_count() are valid)
+             */
+            const std::vector<bengine::sprite_batch::group>& get_groups() const {
+                return this->groups;
+            }
+            /** Get the amount of groups made by the last call to bengine::sprite_batch::build()
+             * \returns The amount of groups
+             */
+            std::size_t get_group_count() const {
+                return this->group_count;
+            }
+
+            /** Submit the groups made by the last call to bengine::sprite_batch::build() with one SDL_RenderGeometry call each
+             * \param renderer The renderer to submit to
+             * \returns 0 on success or -1 if a group failed to submit
+             */
+            int submit(SDL_Renderer *renderer) {
+                int output = 0;
+                for (std::size_t i = 0; i < this->group_count; i++) {
+                    const std::vector<SDL_Vertex> &vertices = this->groups[i].vertices;
+                    // the indices are the same pattern for every quad, so they only grow to fit the biggest group
+                    for (int quad = this->indices.size() / 6; quad < static_cast<int>(vertices.size() / 4); quad++) {
+                        this->indices.insert(this->indices.end(), {quad * 4, quad * 4 + 1, quad * 4 + 2, quad * 4, quad * 4 + 2, quad * 4 + 3});
+                    }
+                    SDL_SetTextureBlendMode(this->groups[i].texture, this->groups[i].blend_mode);
+                    if (SDL_RenderGeometry(renderer, this->groups[i].texture, vertices.data(), vertices.size(), this->indices.data(), vertices.size() / 4 * 6) != 0) {
+                        std::cout << "Sprite batch failed to submit a group [bengine::sprite_batch::submit]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                        output = -1;
+                    }
+                }
+                return output;
+            }
+    };
+}
+
+#endif // BENGINE_SPRITE_BATCH_hpp
@@ -0,0 +1,182 @@
+#ifndef BENGINE_TERMINAL_OUTPUT_hpp
+#define BENGINE_TERMINAL_OUTPUT_hpp
+
+#include <cstdio>
+#include <ncurses.h>
+
+namespace bengine {
+    // \brief The surface that bengine::curses_window and bengine::curses_loop draw to and read input from; ncurses is used unless another output has been made active
+    class terminal_output {
+        private:
+            // \brief The output that is currently being used (nullptr means ncurses)
+            static bengine::terminal_output *active;
+
+        public:
+            // \brief bengine::terminal_output deconstructor
+            virtual ~terminal_output() {}
+
+            // \brief A mouse event reported by the terminal
+            struct mouse_event {
+                // \brief x-position (col) of the mouse
+                int x = -1;
+                // \brief y-position (row) of the mouse
+                int y = -1;
+                // \brief Which buttons changed/what happened as an ncurses mouse mask (BUTTON1_PRESSED, REPORT_MOUSE_POSITION, etc)
+                unsigned long buttons = 0;
+            };
+
+            /** Get the output that is currently being used by curses windows and loops
+             * \returns The active output (ncurses unless another output has been made active)
+             */
+            static bengine::terminal_output& get_active();
+            /** Make an output the one used by curses windows and loops
+             * \param output The output to use (nullptr to go back to ncurses)
+             */
+            static void set_active(bengine::terminal_output *output) {
+                bengine::terminal_output::active = output;
+            }
+
+            /** Get the width of the terminal
+             * \returns The width of the terminal (cols)
+             */
+            virtual int get_cols() const = 0;
+            /** Get the height of the terminal
+             * \returns The height of the terminal (rows)
+             */
+            virtual int get_lines() const = 0;
+
+            /** Put a single cell onto the terminal
+             * \param x x-position (col) of the cell
+             * \param y y-position (row) of the cell
+             * \param character The character to put in the cell
+             * \param color_pair The color pair to use for the cell
+             * \param attributes The attributes of the cell as a bengine::curses_window::cell_attributes mask
+             */
+            virtual void put_cell(const int &x, const int &y, const wchar_t &character, const unsigned char &color_pair, const unsigned short &attributes) = 0;
+            // \brief Blank out the entire terminal
+            virtual void clear() = 0;
+            // \brief Flush everything that has been put onto the terminal so that it can be seen
+            virtual void refresh() = 0;
+
+            /** Read the next input from the terminal
+             * \param blocking Whether to wait for input if there is none or not
+             * \returns The input that was read, or ERR if there was none
+             */
+            virtual int read_input(const bool &blocking = false) = 0;
+            /** Push an input back so that it will be the next one read
+             * \param input The input to push back
+             */
+            virtual void push_input(const int &input) = 0;
+
+            /** Start reporting mouse events as KEY_MOUSE inputs
+             * \param report_motion Whether to also report the mouse moving while no buttons are held (needed for hovering)
+             */
+            virtual void enable_mouse(const bool &report_motion) = 0;
+            // \brief Stop reporting mouse events
+            virtual void disable_mouse() = 0;
+            /** Read the mouse event that goes along with a KEY_MOUSE input
+             * \param event Where to put the mouse event
+             * \returns Whether there was a mouse event to read or not
+             */
+            virtual bool read_mouse(bengine::terminal_output::mouse_event &event) = 0;
+
+            /** Wait for some amount of time
+             * \param milliseconds How long to wait (ms)
+             */
+            virtual void sleep(const int &milliseconds) = 0;
+    };
+    bengine::terminal_output *bengine::terminal_output::active = nullptr;
+
+    // \brief A bengine::terminal_output that goes straight to ncurses' stdscr
+    class ncurses_output : public bengine::terminal_output {
+        private:
+            // \brief The ncurses attributes matching each bit of bengine::curses_window::cell_attributes (BOX_DRAWING_MERGABLE has no ncurses counterpart)
+            static const attr_t attribute_key[10];
+
+        public:
+            // \brief bengine::ncurses_output constructor
+            ncurses_output() {}
+            // \brief bengine::ncurses_output deconstructor
+            ~ncurses_output() {}
+
+            int get_cols() const override {
+                return COLS;
+            }
+            int get_lines() const override {
+                return LINES;
+            }
+
+            void put_cell(const int &x, const int &y, const wchar_t &character, const unsigned char &color_pair, const unsigned short &attributes) override {
+                attr_t ncurses_attributes = A_NORMAL;
+                for (unsigned char bit = 0; bit < 10; bit++) {
+                    if ((attributes >> bit) & 1) {
+                        ncurses_attributes |= bengine::ncurses_output::attribute_key[bit];
+                    }
+                }
+                attr_set(ncurses_attributes, color_pair, NULL);
+
+                if (character == L'%') {
+                    mvaddch(y, x, '%');
+                } else {
+                    const wchar_t string[2] = {character, L'\0'};
+                    mvaddnwstr(y, x, string, 1);
+                }
+
+                attr_set(A_NORMAL, 0, NULL);
+            }
+            void clear() override {
+                ::clear();
+            }
+            void refresh() override {
+                ::refresh();
+            }
+
+            int read_input(const bool &blocking = false) override {
+                if (!blocking) {
+                    return getch();
+                }
+                nodelay(stdscr, false);
+                const int output = getch();
+                nodelay(stdscr, true);
+                return output;
+            }
+            void push_input(const int &input) override {
+                ungetch(input);
+            }
+
+            void enable_mouse(const bool &report_motion) override {
+                mousemask(ALL_MOUSE_EVENTS | (report_motion ? REPORT_MOUSE_POSITION : 0), NULL);
+                mouseinterval(0);
+                // ncurses only gets motion events from xterm-like terminals once "any event" tracking (1003) is turned on
+                std::printf(report_motion ? "\033[?1003h" : "\033[?1003l");
+                std::fflush(stdout);
+            }
+            void disable_mouse() override {
+                mousemask(0, NULL);
+                std::printf("\033[?1003l");
+                std::fflush(stdout);
+            }
+            bool read_mouse(bengine::terminal_output::mouse_event &event) override {
+                MEVENT ncurses_event;
+                if (getmouse(&ncurses_event) != OK) {
+                    return false;
+                }
+                event.x = ncurses_event.x;
+                event.y = ncurses_event.y;
+                event.buttons = ncurses_event.bstate;
+                return true;
+            }
+
+            void sleep(const int &milliseconds) override {
+                napms(milliseconds);
+            }
+    };
+    const attr_t bengine::ncurses_output::attribute_key[10] = {A_BOLD, A_ITALIC, A_UNDERLINE, A_REVERSE, A_BLINK, A_DIM, A_INVIS, A_STANDOUT, A_PROTECT, A_ALTCHARSET};
+
+    inline bengine::terminal_output& bengine::terminal_output::get_active() {
+        static bengine::ncurses_output fallback;
+        return bengine::terminal_output::active == nullptr ? fallback : *bengine::terminal_output::active;
+    }
+}
+
+#endif // BENGINE_TERMINAL_OUTPUT_hpp
@@ -0,0 +1,437 @@
+#ifndef BENGINE_TEXT_CACHE_hpp
+#define BENGINE_TEXT_CACHE_hpp
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bengine_texture_atlas.hpp"
+
+namespace bengine {
+    // \brief The glyphs of a single TTF_Font (which is also a single size), rendered once each and packed into a bengine::texture_atlas
+    class glyph_atlas {
+        public:
+            // \brief Where a glyph is in the atlas and how far it moves the pen
+            struct glyph {
+                SDL_Texture *texture = NULL;
+                SDL_Rect frame = {};
+                int advance = 0;
+            };
+
+        private:
+            TTF_Font *font = NULL;
+            // \brief Glyphs are rendered in white so that any color can be applied through vertex colors
+            bengine::texture_atlas atlas;
+            std::unordered_map<Uint16, bengine::glyph_atlas::glyph> glyphs;
+
+        public:
+            /** bengine::glyph_atlas constructor
+             * \param renderer The renderer to make the atlas pages with
+             * \param font The font (and size) to render glyphs with
+             */
+            glyph_atlas(SDL_Renderer *renderer, TTF_Font *font) : atlas(renderer, 1024, 1) {
+                this->font = font;
+            }
+            // \brief bengine::glyph_atlas deconstructor
+            ~glyph_atlas() {}
+
+            /** Get the amount of glyphs that have been rendered
+             * \returns The amount of glyphs that have been rendered
+             */
+            std::size_t get_glyph_count() const {
+                return this->glyphs.size();
+            }
+
+            /** Get a glyph, rendering and packing it if it hasn't been used before
+             * \param character The character to get the glyph of
+             * \param hit Where to put whether the glyph was already in the atlas or not
+             * \returns The glyph (with a NULL texture if it couldn't be rendered, which still advances the pen)
+             */
+            const bengine::glyph_atlas::glyph& get_glyph(const Uint16 &character, bool &hit) {
+                std::unordered_map<Uint16, bengine::glyph_atlas::glyph>::const_iterator found = this->glyphs.find(character);
+                hit = found != this->glyphs.end();
+                if (hit) {
+                    return found->second;
+                }
+
+                bengine::glyph_atlas::glyph &glyph = this->glyphs[character];
+                TTF_GlyphMetrics(this->font, character, NULL, NULL, NULL, NULL, &glyph.advance);
+                SDL_Surface *surface = TTF_RenderGlyph_Blended(this->font, character, {255, 255, 255, 255});
+                if (surface != NULL) {
+                    const bengine::basic_texture packed = this->atlas.add(std::to_string(character), surface);
+                    glyph.texture = packed.get_texture();
+                    glyph.frame = packed.get_frame();
+                    SDL_FreeSurface(surface);
+                }
+                return glyph;
+            }
+    };
+
+    /** Caches everything needed to draw text quickly:
+     * - a bengine::glyph_atlas per font, so that changing text can be drawn as glyph quads that all come from the same texture
+     * - a least-recently-used cache of whole-string textures, for static labels that are drawn the same way every frame
+     */
+    class text_cache {
+        public:
+            // \brief Counts of how well the caches are doing and how long text took
+            struct statistics {
+                unsigned long glyph_hits = 0;
+                unsigned long glyph_misses = 0;
+                unsigned long string_hits = 0;
+                unsigned long string_misses = 0;
+                // \brief The amount of glyph quads that were made
+                unsigned long glyphs_drawn = 0;
+                // \brief The amount of cached strings that were drawn
+                unsigned long strings_drawn = 0;
+                // \brief The time spent laying out, rasterizing, and drawing text (ms)
+                double milliseconds = 0;
+
+                /** Get the fraction of glyph lookups that were already rendered
+                 * \returns The glyph hit rate (0-1)
+                 */
+                double get_glyph_hit_rate() const {
+                    return this->glyph_hits + this->glyph_misses == 0 ? 0 : static_cast<double>(this->glyph_hits) / (this->glyph_hits + this->glyph_misses);
+                }
+                /** Get the fraction of string lookups that were already rendered
+                 * \returns The string hit rate (0-1)
+                 */
+                double get_string_hit_rate() const {
+                    return this->string_hits + this->string_misses == 0 ? 0 : static_cast<double>(this->string_hits) / (this->string_hits + this->string_misses);
+                }
+            };
+            // \brief Glyph quads that share a texture, ready to be submitted together
+            struct glyph_batch {
+                SDL_Texture *texture = NULL;
+                // \brief Four vertices per quad (top-left, top-right, bottom-right, bottom-left)
+                std::vector<SDL_Vertex> vertices;
+            };
+
+        private:
+            // \brief A whole string rendered to its own texture
+            struct cached_string {
+                std::string key;
+                SDL_Texture *texture = NULL;
+                int width = 0;
+                int height = 0;
+            };
+
+            SDL_Renderer *renderer = NULL;
+            std::unordered_map<TTF_Font*, std::unique_ptr<bengine::glyph_atlas>> glyph_atlases;
+
+            // \brief Cached strings from most to least recently used
+            std::list<bengine::text_cache::cached_string> strings;
+            std::unordered_map<std::string, std::list<bengine::text_cache::cached_string>::iterator> string_lookup;
+            // \brief The most strings that will be kept before the least recently used get destroyed
+            std::size_t string_capacity;
+            // \brief Textures that have been evicted but might still be waiting to be drawn (destroyed at the end of the frame)
+            std::vector<SDL_Texture*> retired_textures;
+            // \brief Glyph atlases that have been forgotten but might still have glyphs waiting to be drawn (destroyed at the end of the frame)
+            std::vector<std::unique_ptr<bengine::glyph_atlas>> retired_atlases;
+
+            std::vector<bengine::text_cache::glyph_batch> batches;
+            std::vector<int> indices;
+
+            bengine::text_cache::statistics frame_statistics;
+            bengine::text_cache::statistics last_frame_statistics;
+            bengine::text_cache::statistics total_statistics;
+            // \brief When the current timed section started (performance counter ticks)
+            Uint64 timer_start = 0;
+
+            static std::string make_key(TTF_Font *font, const char16_t *text, const SDL_Color &color, const Uint32 &wrap_width) {
+                std::string output(reinterpret_cast<const char*>(&font), sizeof(font));
+                output.append(reinterpret_cast<const char*>(&color), sizeof(color));
+                output.append(reinterpret_cast<const char*>(&wrap_width), sizeof(wrap_width));
+                output.append(reinterpret_cast<const char*>(text), std::char_traits<char16_t>::length(text) * sizeof(char16_t));
+                return output;
+            }
+            static unsigned long measure_word(bengine::glyph_atlas &atlas, const char16_t *text, std::size_t position) {
+                unsigned long output = 0;
+                bool hit;
+                for (; text[position] != u'\0' && text[position] != u' ' && text[position] != u'\n'; position++) {
+                    output += atlas.get_glyph(text[position], hit).advance;
+                }
+                return output;
+            }
+            // \brief Destroy every retired texture and glyph atlas
+            void destroy_retired() {
+                for (std::size_t i = 0; i < this->retired_textures.size(); i++) {
+                    SDL_DestroyTexture(this->retired_textures[i]);
+                }
+                this->retired_textures.clear();
+                this->retired_atlases.clear();
+            }
+
+        public:
+            /** bengine::text_cache constructor
+             * \param renderer The renderer to make textures with
+             * \param string_capacity The most whole-string textures to keep at once
+             */
+            text_cache(SDL_Renderer *renderer = NULL, const std::size_t &string_capacity = 128) {
+                this->renderer = renderer;
+                this->string_capacity = string_capacity;
+            }
+            // \brief bengine::text_cache deconstructor
+            ~text_cache() {
+                this->clear();
+                this->destroy_retired();
+            }
+            text_cache(const bengine::text_cache&) = delete;
+            bengine::text_cache& operator=(const bengine::text_cache&) = delete;
+
+            /** Set the renderer that textures are made with (clears the cache, since old textures belong to the old renderer)
+             * \param renderer The renderer to make textures with
+             */
+            void set_renderer(SDL_Renderer *renderer) {
+                this->clear();
+                this->destroy_retired();
+                this->renderer = renderer;
+            }
+            /** Get the most whole-string textures that will be kept at once
+             * \returns The most whole-string textures that will be kept at once
+             */
+            std::size_t get_string_capacity() const {
+                return this->string_capacity;
+            }
+            /** Set the most whole-string textures that will be kept at once
+             * \param capacity The most whole-string textures to keep at once
+             */
+            void set_string_capacity(const std::size_t &capacity) {
+                this->string_capacity = capacity;
+                while (this->strings.size() > this->string_capacity) {
+                    this->evict();
+                }
+            }
+            /** Get the amount of whole-string textures being kept
+             * \returns The amount of whole-string textures being kept
+             */
+            std::size_t get_string_count() const {
+                return this->strings.size();
+            }
+
+            // \brief Forget every cached glyph and string (their textures are destroyed at the end of the frame, since some might still be waiting to be drawn)
+            void clear() {
+                for (std::unordered_map<TTF_Font*, std::unique_ptr<bengine::glyph_atlas>>::iterator it = this->glyph_atlases.begin(); it != this->glyph_atlases.end(); it++) {
+                    this->retired_atlases.push_back(std::move(it->second));
+                }
+                this->glyph_atlases.clear();
+                while (!this->strings.empty()) {
+                    this->evict();
+                }
+            }
+            /** Forget everything cached for a font (must be done before closing a font that has been drawn with)
+             * \param font The font to forget
+             */
+            void forget_font(TTF_Font *font) {
+                std::unordered_map<TTF_Font*, std::unique_ptr<bengine::glyph_atlas>>::iterator atlas = this->glyph_atlases.find(font);
+                if (atlas != this->glyph_atlases.end()) {
+                    this->retired_atlases.push_back(std::move(atlas->second));
+                    this->glyph_atlases.erase(atlas);
+                }
+                for (std::list<bengine::text_cache::cached_string>::iterator it = this->strings.begin(); it != this->strings.end();) {
+                    if (it->key.compare(0, sizeof(font), reinterpret_cast<const char*>(&font), sizeof(font)) == 0) {
+                        this->retired_textures.push_back(it->texture);
+                        this->string_lookup.erase(it->key);
+                        it = this->strings.erase(it);
+                    } else {
+                        it++;
+                    }
+                }
+            }
+            // \brief Destroy the least recently used string
+            void evict() {
+                if (this->strings.empty()) {
+                    return;
+                }
+                this->retired_textures.push_back(this->strings.back().texture);
+                this->string_lookup.erase(this->strings.back().key);
+                this->strings.pop_back();
+            }
+
+            // \brief Start timing a piece of text work (added to the frame's milliseconds by bengine::text_cache::stop_timer())
+            void start_timer() {
+                this->timer_start = SDL_GetPerformanceCounter();
+            }
+            // \brief Stop timing a piece of text work
+            void stop_timer() {
+                this->frame_statistics.milliseconds += (SDL_GetPerformanceCounter() - this->timer_start) * 1000.0 / SDL_GetPerformanceFrequency();
+            }
+            // \brief Finish the frame, destroying any evicted textures and forgotten glyph atlases (they can't be waiting to be drawn anymore) and moving the frame's counts into the last frame's
+            void end_frame() {
+                this->destroy_retired();
+
+                this->total_statistics.glyph_hits += this->frame_statistics.glyph_hits;
+                this->total_statistics.glyph_misses += this->frame_statistics.glyph_misses;
+                this->total_statistics.string_hits += this->frame_statistics.string_hits;
+                this->total_statistics.string_misses += this->frame_statistics.string_misses;
+                this->total_statistics.glyphs_drawn += this->frame_statistics.glyphs_drawn;
+                this->total_statistics.strings_drawn += this->frame_statistics.strings_drawn;
+                this->total_statistics.milliseconds += this->frame_statistics.milliseconds;
+                this->last_frame_statistics = this->frame_statistics;
+                this->frame_statistics = bengine::text_cache::statistics();
+            }
+            /** Get the counts of the last finished frame
+             * \returns The counts of the last finished frame
+             */
+            bengine::text_cache::statistics get_frame_statistics() const {
+                return this->last_frame_statistics;
+            }
+            /** Get the counts of every finished frame combined
+             * \returns The counts of every finished frame combined
+             */
+            bengine::text_cache::statistics get_total_statistics() const {
+                return this->total_statistics;
+            }
+
+            /** Get a whole string rendered to a texture, rendering it only if it isn't already cached
+             * \param font The font to use
+             * \param text The text to render
+             * \param color The color of the text
+             * \param wrap_width The maximum width of the text (px) (zero prevents any wrapping)
+             * \param width Where to put the width of the texture (px)
+             * \param height Where to put the height of the texture (px)
+             * \returns The texture (owned by the cache and valid until the end of the frame it gets evicted on), or NULL if the text couldn't be rendered
+             */
+            SDL_Texture* get_string(TTF_Font *font, const char16_t *text, const SDL_Color &color, const Uint32 &wrap_width, int &width, int &height) {
+                const std::string key = bengine::text_cache::make_key(font, text, color, wrap_width);
+                const std::unordered_map<std::string, std::list<bengine::text_cache::cached_string>::iterator>::iterator found = this->string_lookup.find(key);
+                if (found != this->string_lookup.end()) {
+                    this->frame_statistics.string_hits++;
+                    this->frame_statistics.strings_drawn++;
+                    this->strings.splice(this->strings.begin(), this->strings, found->second);
+                    width = found->second->width;
+                    height = found->second->height;
+                    return found->second->texture;
+                }
+                this->frame_statistics.string_misses++;
+
+                SDL_Surface *surface = TTF_RenderUNICODE_Blended_Wrapped(font, reinterpret_cast<const Uint16*>(text), color, wrap_width);
+                if (surface == NULL) {
+                    std::cout << "Text cache failed to render text [bengine::text_cache::get_string]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                    return NULL;
+                }
+                bengine::text_cache::cached_string string;
+                string.key = key;
+                string.texture = SDL_CreateTextureFromSurface(this->renderer, surface);
+                string.width = surface->w;
+                string.height = surface->h;
+                SDL_FreeSurface(surface);
+                if (string.texture == NULL) {
+                    std::cout << "Text cache failed to create a texture [bengine::text_cache::get_string]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                    return NULL;
+                }
+
+                if (this->string_capacity == 0) {
+                    // nothing is kept, but the texture still has to last until the end of the frame
+                    this->retired_textures.push_back(string.texture);
+                } else {
+                    while (this->strings.size() >= this->string_capacity) {
+                        this->evict();
+                    }
+                    this->strings.push_front(string);
+                    this->string_lookup[key] = this->strings.begin();
+                }
+                this->frame_statistics.strings_drawn++;
+                width = string.width;
+                height = string.height;
+                return string.texture;
+            }
+
+            /** Lay text out as glyph quads, grouped by the texture they come from
+             * \param font The font to use
+             * \param text The text to lay out ('\n' starts a new line)
+             * \param x x-position of the top-left corner of the text (px)
+             * \param y y-position of the top-left corner of the text (px)
+             * \param wrap_width The maximum width of the text before wrapping at a space (px) (zero prevents any wrapping)
+             * \param color The color of the text
+             * \param x_scale How much to stretch the text horizontally
+             * \param y_scale How much to stretch the text vertically
+             * \returns The glyph quads (valid until the next call)
+             */
+            const std::vector<bengine::text_cache::glyph_batch>& layout_glyphs(TTF_Font *font, const char16_t *text, const float &x, const float &y, const Uint32 &wrap_width, const SDL_Color &color, const float &x_scale = 1, const float &y_scale = 1) {
+                for (std::size_t i = 0; i < this->batches.size(); i++) {
+                    this->batches[i].vertices.clear();
+                }
+
+                std::unique_ptr<bengine::glyph_atlas> &atlas = this->glyph_atlases[font];
+                if (!atlas) {
+                    atlas.reset(new bengine::glyph_atlas(this->renderer, font));
+                }
+                const int line_skip = TTF_FontLineSkip(font);
+
+                // measuring words for wrapping can render glyphs too, so misses are counted by how many new glyphs there are at the end
+                const std::size_t glyph_count = atlas->get_glyph_count();
+                unsigned long lookups = 0;
+                long pen_x = 0, pen_y = 0;
+                bool hit;
+                for (std::size_t i = 0; text[i] != u'\0'; i++) {
+                    if (text[i] == u'\n') {
+                        pen_x = 0;
+                        pen_y += line_skip;
+                        continue;
+                    }
+                    // wrap before a word that wouldn't fit (words wider than the whole line are left to overflow)
+                    if (wrap_width > 0 && pen_x > 0 && (i == 0 || text[i - 1] == u' ') && text[i] != u' ' && pen_x + bengine::text_cache::measure_word(*atlas, text, i) > wrap_width) {
+                        pen_x = 0;
+                        pen_y += line_skip;
+                    }
+
+                    const bengine::glyph_atlas::glyph &glyph = atlas->get_glyph(text[i], hit);
+                    lookups++;
+                    if (glyph.texture != NULL) {
+                        std::size_t batch = 0;
+                        for (; batch < this->batches.size() && this->batches[batch].texture != glyph.texture; batch++);
+                        if (batch == this->batches.size()) {
+                            this->batches.emplace_back();
+                            this->batches.back().texture = glyph.texture;
+                        }
+
+                        int texture_width, texture_height;
+                        SDL_QueryTexture(glyph.texture, NULL, NULL, &texture_width, &texture_height);
+                        const float u1 = static_cast<float>(glyph.frame.x) / texture_width, u2 = static_cast<float>(glyph.frame.x + glyph.frame.w) / texture_width;
+                        const float v1 = static_cast<float>(glyph.frame.y) / texture_height, v2 = static_cast<float>(glyph.frame.y + glyph.frame.h) / texture_height;
+                        const float x1 = x + pen_x * x_scale, y1 = y + pen_y * y_scale, x2 = x1 + glyph.frame.w * x_scale, y2 = y1 + glyph.frame.h * y_scale;
+
+                        std::vector<SDL_Vertex> &vertices = this->batches[batch].vertices;
+                        vertices.push_back({{x1, y1}, color, {u1, v1}});
+                        vertices.push_back({{x2, y1}, color, {u2, v1}});
+                        vertices.push_back({{x2, y2}, color, {u2, v2}});
+                        vertices.push_back({{x1, y2}, color, {u1, v2}});
+                        this->frame_statistics.glyphs_drawn++;
+                    }
+                    pen_x += glyph.advance;
+                }
+                const unsigned long misses = atlas->get_glyph_count() - glyph_count;
+                this->frame_statistics.glyph_misses += misses;
+                this->frame_statistics.glyph_hits += lookups - misses;
+                return this->batches;
+            }
+            /** Submit glyph quads laid out by bengine::text_cache::layout_glyphs(), using one SDL_RenderGeometry call per texture
+             * \returns 0 on success or -1 if a submission failed
+             */
+            int submit_glyphs() {
+                int output = 0;
+                for (std::size_t i = 0; i < this->batches.size(); i++) {
+                    const std::vector<SDL_Vertex> &vertices = this->batches[i].vertices;
+                    if (vertices.empty()) {
+                        continue;
+                    }
+                    // the index pattern is the same for every quad, so it only needs to grow
+                    for (int quad = this->indices.size() / 6; quad < static_cast<int>(vertices.size() / 4); quad++) {
+                        this->indices.insert(this->indices.end(), {quad * 4, quad * 4 + 1, quad * 4 + 2, quad * 4, quad * 4 + 2, quad * 4 + 3});
+                    }
+                    if (SDL_RenderGeometry(this->renderer, this->batches[i].texture, vertices.data(), vertices.size(), this->indices.data(), vertices.size() / 4 * 6) != 0) {
+                        output = -1;
+                    }
+                }
+                return output;
+            }
+    };
+}
+
+#endif // BENGINE_TEXT_CACHE_hpp
@@ -3,6 +3,7 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <utility>
 
 namespace bengine {
     // \brief A wrapper class for the SDL_Texture that pretty much just contains the source texture and frame
@@ -12,28 +13,87 @@ namespace bengine {
             SDL_Texture *source = nullptr;
             // \brief The portion of the source texture to actually display
             SDL_Rect frame = {};
+            // \brief Whether the source texture gets destroyed along with this (false for textures that belong to something else, like a bengine::texture_atlas)
+            bool owns_source = true;
+
+            /** Destroy the source texture if it is owned (before replacing it)
+             * \param replacement The texture that is replacing the source (kept alive if it happens to be the same one)
+             */
+            void release_source(SDL_Texture *replacement) {
+                if (this->owns_source && this->source != replacement) {
+                    SDL_DestroyTexture(this->source);
+                }
+                this->owns_source = false;
+            }
 
         public:
             /** bengine::basic_texture constructor
              * \param texture The SDL_Texture to use as a source
              * \param frame The portion of the source texture to actually display
+             * \param owns_texture Whether the source texture should be destroyed along with this or not
              */
-            basic_texture(SDL_Texture *texture = NULL, const SDL_Rect &frame = {}) {
+            basic_texture(SDL_Texture *texture = NULL, const SDL_Rect &frame = {}, const bool &owns_texture = true) {
                 this->set_texture(texture);
                 this->set_frame(frame);
+                this->owns_source = owns_texture;
             }
             // \brief bengine::basic_texture deconstructor; pretty much just handles some SDL cleanup
             ~basic_texture() {
-                SDL_DestroyTexture(this->source);
+                if (this->owns_source) {
+                    SDL_DestroyTexture(this->source);
+                }
                 this->source = nullptr;
             }
 
-            /** Assignment operator overload
+            /** Copy constructor; the copy shares the source texture but never owns it (only one texture can destroy it)
+             * \param rhs The bengine::basic_texture to copy
+             */
+            basic_texture(const bengine::basic_texture &rhs) {
+                this->set_texture(rhs.get_texture());
+                this->set_frame(rhs.get_frame());
+                this->owns_source = false;
+            }
+            /** Move constructor; ownership of the source texture moves over as well
+             * \param rhs The bengine::basic_texture to move from
+             */
+            basic_texture(bengine::basic_texture &&rhs) noexcept {
+                this->set_texture(rhs.get_texture());
+                this->set_frame(rhs.get_frame());
+                this->owns_source = rhs.owns_source;
+                rhs.owns_source = false;
+            }
+
+            /** Assignment operator overload; destroys the current source texture if it is owned, then shares the new one without owning it
              * \param rhs The bengine::basic_texture to inherit from
              */
             void operator=(const bengine::basic_texture &rhs) {
+                if (this == &rhs) {
+                    return;
+                }
+                this->release_source(rhs.get_texture());
                 this->set_texture(rhs.get_texture());
                 this->set_frame(rhs.get_frame());
+                this->owns_source = false;
+            }
+            /** Move assignment operator overload; destroys the current source texture if it is owned, then takes over the new one (and whether it is owned)
+             * \param rhs The bengine::basic_texture to move from
+             */
+            void operator=(bengine::basic_texture &&rhs) noexcept {
+                if (this == &rhs) {
+                    return;
+                }
+                this->release_source(rhs.get_texture());
+                this->set_texture(rhs.get_texture());
+                this->set_frame(rhs.get_frame());
+                this->owns_source = rhs.owns_source;
+                rhs.owns_source = false;
+            }
+
+            /** Get whether the source texture gets destroyed along with this or not
+             * \returns Whether the source texture gets destroyed along with this or not
+             */
+            bool is_owning_texture() const {
+                return this->owns_source;
             }
 
             /** Get the source texture
@@ -78,23 +138,34 @@ namespace bengine {
              * \param texture The SDL_Texture to use as a source
              * \param frame The portion of the source texture to actually display
              * \param color_mod The color modification for the texture
+             * \param owns_texture Whether the source texture should be destroyed along with this or not
              */
-            modded_texture(SDL_Texture *texture = nullptr, const SDL_Rect &frame = {}, const SDL_Color &color_mod = {255, 255, 255, 255}) {
+            modded_texture(SDL_Texture *texture = nullptr, const SDL_Rect &frame = {}, const SDL_Color &color_mod = {255, 255, 255, 255}, const bool &owns_texture = true) {
                 this->set_texture(texture);
                 this->set_frame(frame);
                 this->set_color_mod(color_mod);
+                this->owns_source = owns_texture;
             }
-            // \brief bengine::modded_texture deconstructor
-            ~modded_texture() {
-                bengine::basic_texture::~basic_texture();
-            }
+            // \brief bengine::modded_texture deconstructor (bengine::basic_texture's deconstructor handles the source texture)
+            ~modded_texture() {}
+            // \brief Copy constructor; the copy shares the source texture but never owns it
+            modded_texture(const bengine::modded_texture &rhs) = default;
+            // \brief Move constructor; ownership of the source texture moves over as well
+            modded_texture(bengine::modded_texture &&rhs) = default;
 
-            /** Assignment operator overload
+            /** Assignment operator overload; destroys the current source texture if it is owned, then shares the new one without owning it
              * \param rhs The bengine::modded_texture to inherit from
              */
             void operator=(const bengine::modded_texture &rhs) {
-                this->set_texture(rhs.get_texture());
-                this->set_frame(rhs.get_frame());
+                bengine::basic_texture::operator=(rhs);
+                this->set_color_mod(rhs.get_color_mod());
+                this->set_blend_mode(rhs.get_blend_mode());
+            }
+            /** Move assignment operator overload; destroys the current source texture if it is owned, then takes over the new one
+             * \param rhs The bengine::modded_texture to move from
+             */
+            void operator=(bengine::modded_texture &&rhs) noexcept {
+                bengine::basic_texture::operator=(std::move(rhs));
                 this->set_color_mod(rhs.get_color_mod());
                 this->set_blend_mode(rhs.get_blend_mode());
             }
@@ -205,27 +276,37 @@ namespace bengine {
              * \param pivot The point for the texture to be rotated about relative to the source frame's top-left corner
              * \param angle The angle for the texture to be rotated at
              * \param color_mod The color modification for the texture
+             * \param owns_texture Whether the source texture should be destroyed along with this or not
              */
-            shifting_texture(SDL_Texture *texture = NULL, const SDL_Rect &frame = {}, const SDL_Point &pivot = {}, const double &angle = 0, const SDL_Color &color_mod = {255, 255, 255, 255}) {
+            shifting_texture(SDL_Texture *texture = NULL, const SDL_Rect &frame = {}, const SDL_Point &pivot = {}, const double &angle = 0, const SDL_Color &color_mod = {255, 255, 255, 255}, const bool &owns_texture = true) {
                 this->set_texture(texture);
                 this->set_frame(frame);
-                this->set_color_mod(this->color_mod);
+                this->set_color_mod(color_mod);
                 this->set_pivot(pivot);
                 this->set_angle(angle);
+                this->owns_source = owns_texture;
             }
-            // \brief bengine::shifting_texture deconstructor
-            ~shifting_texture() {
-                bengine::modded_texture::~modded_texture();
-            }
+            // \brief bengine::shifting_texture deconstructor (bengine::basic_texture's deconstructor handles the source texture)
+            ~shifting_texture() {}
+            // \brief Copy constructor; the copy shares the source texture but never owns it
+            shifting_texture(const bengine::shifting_texture &rhs) = default;
+            // \brief Move constructor; ownership of the source texture moves over as well
+            shifting_texture(bengine::shifting_texture &&rhs) = default;
 
-            /** Assignment operator overload
+            /** Assignment operator overload; destroys the current source texture if it is owned, then shares the new one without owning it
              * \param rhs The bengine::shifting_texture to inherit from
              */
             void operator=(const bengine::shifting_texture &rhs) {
-                this->set_texture(rhs.get_texture());
-                this->set_frame(rhs.get_frame());
-                this->set_color_mod(rhs.get_color_mod());
-                this->set_blend_mode(rhs.get_blend_mode());
+                bengine::modded_texture::operator=(rhs);
+                this->set_pivot(rhs.get_pivot());
+                this->set_angle(rhs.get_angle());
+                this->set_flip(rhs.get_flip());
+            }
+            /** Move assignment operator overload; destroys the current source texture if it is owned, then takes over the new one
+             * \param rhs The bengine::shifting_texture to move from
+             */
+            void operator=(bengine::shifting_texture &&rhs) noexcept {
+                bengine::modded_texture::operator=(std::move(rhs));
                 this->set_pivot(rhs.get_pivot());
                 this->set_angle(rhs.get_angle());
                 this->set_flip(rhs.get_flip());
@@ -0,0 +1,490 @@
+#ifndef BENGINE_TEXTURE_ATLAS_hpp
+#define BENGINE_TEXTURE_ATLAS_hpp
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bengine_texture.hpp"
+
+namespace bengine {
+    // \brief Packs rectangles into a fixed-size area using the skyline bottom-left heuristic (places each rectangle as low as it can go, keeping track of the top edge of everything placed so far)
+    class skyline_packer {
+        private:
+            // \brief A horizontal segment of the skyline
+            struct segment {
+                int x;
+                int y;
+                int width;
+            };
+
+            int width = 0;
+            int height = 0;
+            // \brief The segments of the skyline from left to right (they always cover the full width)
+            std::vector<bengine::skyline_packer::segment> skyline;
+            // \brief The area covered by packed rectangles (px^2)
+            long long used_area = 0;
+
+            /** Find the height that a rectangle would rest at if its left edge was placed on a segment
+             * \param index The index of the segment to place the rectangle on
+             * \param w The width of the rectangle (px)
+             * \param h The height of the rectangle (px)
+             * \returns The y-position that the rectangle would rest at, or -1 if it doesn't fit
+             */
+            int fit(const std::size_t &index, const int &w, const int &h) const {
+                if (this->skyline[index].x + w > this->width) {
+                    return -1;
+                }
+                int y = 0, remaining = w;
+                for (std::size_t i = index; remaining > 0; i++) {
+                    y = this->skyline[i].y > y ? this->skyline[i].y : y;
+                    if (y + h > this->height) {
+                        return -1;
+                    }
+                    remaining -= this->skyline[i].width;
+                }
+                return y;
+            }
+
+        public:
+            /** bengine::skyline_packer constructor
+             * \param width The width of the area to pack into (px)
+             * \param height The height of the area to pack into (px)
+             */
+            skyline_packer(const int &width = 0, const int &height = 0) {
+                this->reset(width, height);
+            }
+            // \brief bengine::skyline_packer deconstructor
+            ~skyline_packer() {}
+
+            /** Throw away everything that has been packed, optionally changing the size of the area
+             * \param width The width of the area to pack into (px)
+             * \param height The height of the area to pack into (px)
+             */
+            void reset(const int &width, const int &height) {
+                this->width = width;
+                this->height = height;
+                this->skyline.clear();
+                this->skyline.push_back({0, 0, width});
+                this->used_area = 0;
+            }
+
+            /** Get the width of the area being packed into
+             * \returns The width of the area being packed into (px)
+             */
+            int get_width() const {
+                return this->width;
+            }
+            /** Get the height of the area being packed into
+             * \returns The height of the area being packed into (px)
+             */
+            int get_height() const {
+                return this->height;
+            }
+            /** Get how much of the area is covered by packed rectangles
+             * \returns The fraction of the area that is covered by packed rectangles (0-1)
+             */
+            double get_occupancy() const {
+                return this->width == 0 || this->height == 0 ? 0 : static_cast<double>(this->used_area) / (static_cast<long long>(this->width) * this->height);
+            }
+
+            /** Find a place for a rectangle and mark it as taken
+             * \param w The width of the rectangle (px)
+             * \param h The height of the rectangle (px)
+             * \param output Where to put the position of the rectangle
+             * \returns Whether the rectangle could be placed or not
+             */
+            bool insert(const int &w, const int &h, SDL_Point &output) {
+                if (w <= 0 || h <= 0) {
+                    return false;
+                }
+
+                // lowest resting height wins, with the narrowest segment breaking ties to leave bigger gaps open
+                std::size_t best_index = this->skyline.size();
+                int best_y = this->height, best_width = this->width + 1;
+                for (std::size_t i = 0; i < this->skyline.size(); i++) {
+                    const int y = this->fit(i, w, h);
+                    if (y >= 0 && (y < best_y || (y == best_y && this->skyline[i].width < best_width))) {
+                        best_index = i;
+                        best_y = y;
+                        best_width = this->skyline[i].width;
+                    }
+                }
+                if (best_index == this->skyline.size()) {
+                    return false;
+                }
+                output = {this->skyline[best_index].x, best_y};
+
+                // raise the skyline under the new rectangle, trimming (or removing) any segments that it covers
+                this->skyline.insert(this->skyline.begin() + best_index, {output.x, best_y + h, w});
+                for (std::size_t i = best_index + 1; i < this->skyline.size();) {
+                    const int overlap = this->skyline[i - 1].x + this->skyline[i - 1].width - this->skyline[i].x;
+                    if (overlap <= 0) {
+                        break;
+                    }
+                    if (overlap < this->skyline[i].width) {
+                        this->skyline[i].x += overlap;
+                        this->skyline[i].width -= overlap;
+                        break;
+                    }
+                    this->skyline.erase(this->skyline.begin() + i);
+                }
+                // merge neighbours that ended up at the same height
+                for (std::size_t i = 0; i + 1 < this->skyline.size();) {
+                    if (this->skyline[i].y == this->skyline[i + 1].y) {
+                        this->skyline[i].width += this->skyline[i + 1].width;
+                        this->skyline.erase(this->skyline.begin() + i + 1);
+                    } else {
+                        i++;
+                    }
+                }
+
+                this->used_area += static_cast<long long>(w) * h;
+                return true;
+            }
+    };
+
+    /** Packs many images into a few large textures (pages) so that drawing them doesn't need to switch textures as often
+     * Images can be added at any time; they are packed into the first page with room and only that portion of the page is uploaded, with new pages being made as needed
+     * The textures handed out don't own their page, so they stay valid for as long as the atlas does
+     */
+    class texture_atlas {
+        private:
+            // \brief A single texture that images are packed into, along with a copy of its pixels so that it can be cached
+            struct page {
+                SDL_Texture *texture = NULL;
+                SDL_Surface *surface = NULL;
+                bengine::skyline_packer packer;
+            };
+            // \brief Where an image ended up
+            struct entry {
+                std::size_t page;
+                SDL_Rect frame;
+            };
+
+            // \brief The renderer that the pages are made with
+            SDL_Renderer *renderer = NULL;
+            // \brief The size of each page (px) (images that don't fit get a page of their own)
+            int page_size;
+            // \brief Empty space kept around every image so that filtering doesn't bleed neighbouring images together (px)
+            int padding;
+
+            std::vector<bengine::texture_atlas::page> pages;
+            std::unordered_map<std::string, bengine::texture_atlas::entry> entries;
+            // \brief When each image file was last modified, used to check whether a cache is still valid
+            std::unordered_map<std::string, long long> source_times;
+
+            // \brief The version of the cache's index file
+            static constexpr unsigned char cache_version = 1;
+
+            // \brief Print the output of SDL_GetError with a timestamp and some extra formatting
+            void print_error() const {
+                std::cout << "\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+            }
+
+            /** Get when a file was last modified
+             * \param path The path of the file
+             * \returns When the file was last modified (in the filesystem's own units), or -1 if it couldn't be read
+             */
+            static long long get_source_time(const std::string &path) {
+                std::error_code error;
+                const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+                return error ? -1 : static_cast<long long>(time.time_since_epoch().count());
+            }
+
+            /** Make a new, empty page
+             * \param width The width of the page (px)
+             * \param height The height of the page (px)
+             * \returns The index of the new page, or -1 if it couldn't be made
+             */
+            int create_page(const int &width, const int &height) {
+                bengine::texture_atlas::page page;
+                if ((page.surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32)) == NULL) {
+                    std::cout << "Texture atlas failed to create a page surface [bengine::texture_atlas::create_page]";
+                    this->print_error();
+                    return -1;
+                }
+                if ((page.texture = SDL_CreateTexture(this->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, width, height)) == NULL) {
+                    std::cout << "Texture atlas failed to create a page texture [bengine::texture_atlas::create_page]";
+                    this->print_error();
+                    SDL_FreeSurface(page.surface);
+                    return -1;
+                }
+                SDL_SetTextureBlendMode(page.texture, SDL_BLENDMODE_BLEND);
+                // the surface starts out cleared, so the texture is made to match it
+                SDL_UpdateTexture(page.texture, NULL, page.surface->pixels, page.surface->pitch);
+                page.packer.reset(width, height);
+                this->pages.emplace_back(page);
+                return this->pages.size() - 1;
+            }
+            /** Upload part of a page's surface to its texture
+             * \param index The index of the page
+             * \param area The part of the page to upload (px)
+             */
+            void upload(const std::size_t &index, const SDL_Rect &area) {
+                const bengine::texture_atlas::page &page = this->pages[index];
+                const char *pixels = static_cast<const char*>(page.surface->pixels) + area.y * page.surface->pitch + area.x * 4;
+                if (SDL_UpdateTexture(page.texture, &area, pixels, page.surface->pitch) != 0) {
+                    std::cout << "Texture atlas failed to upload to a page [bengine::texture_atlas::upload]";
+                    this->print_error();
+                }
+            }
+
+        public:
+            /** bengine::texture_atlas constructor
+             * \param renderer The renderer to make the pages with (see bengine::render_window::get_renderer())
+             * \param page_size The size of each page (px); 2048 is supported nearly everywhere
+             * \param padding Empty space to keep around every image (px)
+             */
+            texture_atlas(SDL_Renderer *renderer, const int &page_size = 2048, const int &padding = 1) {
+                this->renderer = renderer;
+                this->page_size = page_size;
+                this->padding = padding;
+            }
+            // \brief bengine::texture_atlas deconstructor; destroys every page, so textures handed out by the atlas shouldn't be used past this
+            ~texture_atlas() {
+                this->clear();
+            }
+            texture_atlas(const bengine::texture_atlas&) = delete;
+            bengine::texture_atlas& operator=(const bengine::texture_atlas&) = delete;
+
+            // \brief Destroy every page and forget every image
+            void clear() {
+                for (std::size_t i = 0; i < this->pages.size(); i++) {
+                    SDL_DestroyTexture(this->pages[i].texture);
+                    SDL_FreeSurface(this->pages[i].surface);
+                }
+                this->pages.clear();
+                this->entries.clear();
+                this->source_times.clear();
+            }
+
+            /** Get the amount of pages
+             * \returns The amount of pages
+             */
+            std::size_t get_page_count() const {
+                return this->pages.size();
+            }
+            /** Get a page's texture
+             * \param index The index of the page
+             * \returns The page's texture (owned by the atlas)
+             */
+            SDL_Texture* get_page_texture(const std::size_t &index) const {
+                return this->pages[index].texture;
+            }
+            /** Get how much of a page is covered by images (including their padding)
+             * \param index The index of the page
+             * \returns The fraction of the page that is covered (0-1)
+             */
+            double get_page_occupancy(const std::size_t &index) const {
+                return this->pages[index].packer.get_occupancy();
+            }
+            /** Get the amount of images in the atlas
+             * \returns The amount of images in the atlas
+             */
+            std::size_t get_image_count() const {
+                return this->entries.size();
+            }
+            /** Get whether an image is in the atlas or not
+             * \param name The name of the image (its path if it was loaded from a file)
+             * \returns Whether the image is in the atlas or not
+             */
+            bool contains(const std::string &name) const {
+                return this->entries.find(name) != this->entries.end();
+            }
+
+            /** Get an image that is already in the atlas
+             * \param name The name of the image (its path if it was loaded from a file)
+             * \returns A bengine::basic_texture that doesn't own its texture, with its frame set to the image (empty if the image isn't in the atlas)
+             */
+            bengine::basic_texture get(const std::string &name) const {
+                const std::unordered_map<std::string, bengine::texture_atlas::entry>::const_iterator found = this->entries.find(name);
+                if (found == this->entries.end()) {
+                    return bengine::basic_texture(NULL, {}, false);
+                }
+                return bengine::basic_texture(this->pages[found->second.page].texture, found->second.frame, false);
+            }
+
+            /** Pack a surface into the atlas (the surface isn't freed)
+             * \param name The name to give the image
+             * \param surface The pixels of the image
+             * \returns A bengine::basic_texture that doesn't own its texture, with its frame set to the image (empty on failure)
+             */
+            bengine::basic_texture add(const std::string &name, SDL_Surface *surface) {
+                if (this->contains(name)) {
+                    return this->get(name);
+                }
+                if (surface == NULL) {
+                    return bengine::basic_texture(NULL, {}, false);
+                }
+
+                const int w = surface->w + this->padding * 2, h = surface->h + this->padding * 2;
+                SDL_Point position;
+                std::size_t index = 0;
+                for (; index < this->pages.size(); index++) {
+                    if (this->pages[index].packer.insert(w, h, position)) {
+                        break;
+                    }
+                }
+                if (index == this->pages.size()) {
+                    const int created = this->create_page(w > this->page_size ? w : this->page_size, h > this->page_size ? h : this->page_size);
+                    if (created < 0) {
+                        return bengine::basic_texture(NULL, {}, false);
+                    }
+                    index = created;
+                    this->pages[index].packer.insert(w, h, position);
+                }
+
+                // copy the pixels over as-is (no blending) in the page's format
+                const SDL_Rect frame = {position.x + this->padding, position.y + this->padding, surface->w, surface->h};
+                SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+                if (converted == NULL) {
+                    std::cout << "Texture atlas failed to convert \"" << name << "\" [bengine::texture_atlas::add]";
+                    this->print_error();
+                    return bengine::basic_texture(NULL, {}, false);
+                }
+                SDL_SetSurfaceBlendMode(converted, SDL_BLENDMODE_NONE);
+                SDL_Rect destination = frame;
+                SDL_BlitSurface(converted, NULL, this->pages[index].surface, &destination);
+                SDL_FreeSurface(converted);
+                this->upload(index, frame);
+
+                this->entries[name] = {index, frame};
+                return bengine::basic_texture(this->pages[index].texture, frame, false);
+            }
+            /** Load an image file and pack it into the atlas (does nothing if the file has already been added)
+             * \param filepath The path to the image file, which is also used as its name
+             * \returns A bengine::basic_texture that doesn't own its texture, with its frame set to the image (empty on failure)
+             */
+            bengine::basic_texture load(const std::string &filepath) {
+                if (this->contains(filepath)) {
+                    return this->get(filepath);
+                }
+                SDL_Surface *surface = IMG_Load(filepath.c_str());
+                if (surface == NULL) {
+                    std::cout << "Texture atlas failed to load \"" << filepath << "\" [bengine::texture_atlas::load]";
+                    this->print_error();
+                    return bengine::basic_texture(NULL, {}, false);
+                }
+                bengine::basic_texture output = this->add(filepath, surface);
+                SDL_FreeSurface(surface);
+                if (output.get_texture() != NULL) {
+                    this->source_times[filepath] = bengine::texture_atlas::get_source_time(filepath);
+                }
+                return output;
+            }
+
+            /** Save the atlas so that it can be loaded again without repacking; writes "[path]" (the index) and one "[path].[page].png" per page
+             * \param path The path of the index file
+             * \returns 0 on success or -1 if something couldn't be written
+             */
+            int save_cache(const std::string &path) const {
+                std::ofstream index(path, std::ios::trunc);
+                if (!index.is_open()) {
+                    std::cout << "Texture atlas failed to open \"" << path << "\" [bengine::texture_atlas::save_cache]\n";
+                    return -1;
+                }
+                index << "bengine_texture_atlas " << static_cast<int>(bengine::texture_atlas::cache_version) << "\n";
+                index << this->page_size << " " << this->padding << " " << this->pages.size() << "\n";
+                for (std::size_t i = 0; i < this->pages.size(); i++) {
+                    const std::string page_path = path + "." + std::to_string(i) + ".png";
+                    if (IMG_SavePNG(this->pages[i].surface, page_path.c_str()) != 0) {
+                        std::cout << "Texture atlas failed to save \"" << page_path << "\" [bengine::texture_atlas::save_cache]";
+                        this->print_error();
+                        return -1;
+                    }
+                    index << this->pages[i].surface->w << " " << this->pages[i].surface->h << "\n";
+                }
+                // names go last on each line since they can contain spaces
+                index << this->entries.size() << "\n";
+                for (std::unordered_map<std::string, bengine::texture_atlas::entry>::const_iterator it = this->entries.begin(); it != this->entries.end(); it++) {
+                    const std::unordered_map<std::string, long long>::const_iterator time = this->source_times.find(it->first);
+                    index << it->second.page << " " << it->second.frame.x << " " << it->second.frame.y << " " << it->second.frame.w << " " << it->second.frame.h << " " << (time == this->source_times.end() ? 0 : time->second) << " " << it->first << "\n";
+                }
+                return index.good() ? 0 : -1;
+            }
+            /** Replace the atlas with one saved by bengine::texture_atlas::save_cache()
+             * New images can still be added afterwards, but they will only go into new pages since the cache doesn't keep the packing state
+             * \param path The path of the index file
+             * \returns 0 on success, -1 if a file couldn't be read, -2 if the index isn't valid, or -3 if any of the image files were changed after the cache was saved (the atlas is left empty unless 0 is returned)
+             */
+            int load_cache(const std::string &path) {
+                this->clear();
+                std::ifstream index(path);
+                if (!index.is_open()) {
+                    return -1;
+                }
+
+                std::string magic;
+                int version = 0, page_size = 0, padding = 0;
+                std::size_t page_count = 0, entry_count = 0;
+                // the atlas keeps its own page size and padding unless the header is valid
+                if (!(index >> magic >> version >> page_size >> padding >> page_count) || magic != "bengine_texture_atlas" || version != bengine::texture_atlas::cache_version || page_size <= 0 || padding < 0) {
+                    std::cout << "Texture atlas failed to read \"" << path << "\" as a cache [bengine::texture_atlas::load_cache]\n";
+                    return -2;
+                }
+                this->page_size = page_size;
+                this->padding = padding;
+                std::vector<SDL_Point> page_sizes(page_count);
+                for (std::size_t i = 0; i < page_count; i++) {
+                    if (!(index >> page_sizes[i].x >> page_sizes[i].y)) {
+                        return -2;
+                    }
+                }
+                if (!(index >> entry_count)) {
+                    return -2;
+                }
+                for (std::size_t i = 0; i < entry_count; i++) {
+                    bengine::texture_atlas::entry entry;
+                    long long time;
+                    std::string name;
+                    if (!(index >> entry.page >> entry.frame.x >> entry.frame.y >> entry.frame.w >> entry.frame.h >> time) || entry.page >= page_count) {
+                        this->clear();
+                        return -2;
+                    }
+                    index.get();
+                    std::getline(index, name);
+                    if (time != 0 && bengine::texture_atlas::get_source_time(name) != time) {
+                        this->clear();
+                        return -3;
+                    }
+                    this->entries[name] = entry;
+                    if (time != 0) {
+                        this->source_times[name] = time;
+                    }
+                }
+
+                for (std::size_t i = 0; i < page_count; i++) {
+                    const std::string page_path = path + "." + std::to_string(i) + ".png";
+                    SDL_Surface *loaded = IMG_Load(page_path.c_str());
+                    if (loaded == NULL || this->create_page(page_sizes[i].x, page_sizes[i].y) < 0) {
+                        std::cout << "Texture atlas failed to load \"" << page_path << "\" [bengine::texture_atlas::load_cache]";
+                        this->print_error();
+                        SDL_FreeSurface(loaded);
+                        this->clear();
+                        return -1;
+                    }
+                    SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+                    SDL_FreeSurface(loaded);
+                    if (converted == NULL) {
+                        this->clear();
+                        return -1;
+                    }
+                    SDL_SetSurfaceBlendMode(converted, SDL_BLENDMODE_NONE);
+                    SDL_BlitSurface(converted, NULL, this->pages[i].surface, NULL);
+                    SDL_FreeSurface(converted);
+                    this->upload(i, {0, 0, page_sizes[i].x, page_sizes[i].y});
+                    // nothing more is packed into cached pages
+                    this->pages[i].packer.reset(0, 0);
+                }
+                return 0;
+            }
+    };
+}
+
+#endif // BENGINE_TEXTURE_ATLAS_hpp
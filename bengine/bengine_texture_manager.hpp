@@ -0,0 +1,378 @@
+#ifndef BENGINE_TEXTURE_MANAGER_hpp
+#define BENGINE_TEXTURE_MANAGER_hpp
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bengine_texture.hpp"
+
+namespace bengine {
+    // \brief Refers to a texture held by a bengine::texture_manager; a handle goes stale (instead of dangling) once its texture is evicted, since the slot's generation changes
+    struct texture_handle {
+        Uint32 index = 0;
+        // \brief Generations start at 1, so a default handle never refers to anything
+        Uint32 generation = 0;
+
+        bool operator==(const bengine::texture_handle &rhs) const {
+            return this->index == rhs.index && this->generation == rhs.generation;
+        }
+        bool operator!=(const bengine::texture_handle &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+    /** Loads textures once per path and hands out handles to them, counting how many holders each texture has
+     * Textures that nobody holds anymore aren't destroyed right away; they're kept (least recently released first in line for eviction) until the memory they use goes over the budget, so that textures which are released and reacquired often (like between scenes) don't get reloaded from disk
+     */
+    class texture_manager {
+        private:
+            struct slot {
+                SDL_Texture *texture = NULL;
+                std::string path;
+                Uint32 generation = 1;
+                Uint32 references = 0;
+                // \brief Roughly how much video memory the texture uses (4 bytes per pixel)
+                std::size_t bytes = 0;
+                int width = 0;
+                int height = 0;
+                // \brief Where the slot is in the unused list (only meaningful when it has no references)
+                std::list<Uint32>::iterator unused_position;
+            };
+
+            SDL_Renderer *renderer = NULL;
+            std::vector<bengine::texture_manager::slot> slots;
+            // \brief Slots that aren't holding a texture
+            std::vector<Uint32> free_slots;
+            std::unordered_map<std::string, Uint32> paths;
+            // \brief Slots with textures that nobody holds, most recently released at the front
+            std::list<Uint32> unused;
+
+            // \brief How much memory textures can use before unused ones start getting evicted (bytes)
+            std::size_t budget = 0;
+            std::size_t memory_usage = 0;
+
+            /** Get the slot that a handle refers to
+             * \param handle The handle to look up
+             * \returns The slot, or NULL if the handle is stale
+             */
+            bengine::texture_manager::slot* find(const bengine::texture_handle &handle) {
+                if (handle.index >= this->slots.size() || this->slots[handle.index].generation != handle.generation || this->slots[handle.index].texture == NULL) {
+                    return NULL;
+                }
+                return &this->slots[handle.index];
+            }
+            const bengine::texture_manager::slot* find(const bengine::texture_handle &handle) const {
+                return const_cast<bengine::texture_manager*>(this)->find(handle);
+            }
+            /** Destroy a slot's texture and make every handle to it stale
+             * \param index The slot to empty
+             */
+            void evict(const Uint32 &index) {
+                bengine::texture_manager::slot &current = this->slots[index];
+                SDL_DestroyTexture(current.texture);
+                this->paths.erase(current.path);
+                this->memory_usage -= current.bytes;
+                current.texture = NULL;
+                current.path.clear();
+                current.references = 0;
+                current.bytes = 0;
+                // generation 0 is never used, so that default handles stay stale even after wrapping around
+                current.generation = current.generation + 1 != 0 ? current.generation + 1 : 1;
+                this->free_slots.push_back(index);
+            }
+
+        public:
+            /** bengine::texture_manager constructor
+             * \param renderer The renderer to make textures with
+             * \param budget How much memory textures can use before unused ones start getting evicted (bytes)
+             */
+            texture_manager(SDL_Renderer *renderer = NULL, const std::size_t &budget = 256 * 1024 * 1024) {
+                this->renderer = renderer;
+                this->budget = budget;
+            }
+            // \brief bengine::texture_manager deconstructor
+            ~texture_manager() {
+                this->clear();
+            }
+            texture_manager(const bengine::texture_manager&) = delete;
+            bengine::texture_manager& operator=(const bengine::texture_manager&) = delete;
+
+            /** Set the renderer that textures are made with (clears the manager, since old textures belong to the old renderer)
+             * \param renderer The renderer to make textures with
+             */
+            void set_renderer(SDL_Renderer *renderer) {
+                this->clear();
+                this->renderer = renderer;
+            }
+
+            /** Get a handle to the texture at a path, loading it if it isn't already loaded (every acquire needs a matching release)
+             * \param path The path of the image to load
+             * \returns A handle to the texture (stale if the image couldn't be loaded)
+             */
+            bengine::texture_handle acquire(const std::string &path) {
+                std::unordered_map<std::string, Uint32>::const_iterator found = this->paths.find(path);
+                if (found != this->paths.end()) {
+                    bengine::texture_manager::slot &current = this->slots[found->second];
+                    if (current.references++ == 0) {
+                        this->unused.erase(current.unused_position);
+                    }
+                    return {found->second, current.generation};
+                }
+
+                SDL_Surface *surface = IMG_Load(path.c_str());
+                if (surface == NULL) {
+                    std::cout << "Texture manager failed to load \"" << path << "\" [bengine::texture_manager::acquire]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                    return {};
+                }
+                SDL_Texture *texture = SDL_CreateTextureFromSurface(this->renderer, surface);
+                const int width = surface->w, height = surface->h;
+                SDL_FreeSurface(surface);
+                if (texture == NULL) {
+                    std::cout << "Texture manager failed to create a texture for \"" << path << "\" [bengine::texture_manager::acquire]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                    return {};
+                }
+
+                Uint32 index;
+                if (this->free_slots.empty()) {
+                    index = static_cast<Uint32>(this->slots.size());
+                    this->slots.emplace_back();
+                } else {
+                    index = this->free_slots.back();
+                    this->free_slots.pop_back();
+                }
+                bengine::texture_manager::slot &current = this->slots[index];
+                current.texture = texture;
+                current.path = path;
+                current.references = 1;
+                current.bytes = static_cast<std::size_t>(width) * height * 4;
+                current.width = width;
+                current.height = height;
+                this->paths[path] = index;
+                this->memory_usage += current.bytes;
+                this->trim();
+                return {index, current.generation};
+            }
+            /** Add another holder to a texture (for sharing a handle that was already acquired)
+             * \param handle The handle to the texture
+             * \returns 0 on success or -1 if the handle is stale
+             */
+            int retain(const bengine::texture_handle &handle) {
+                bengine::texture_manager::slot *current = this->find(handle);
+                if (current == NULL) {
+                    return -1;
+                }
+                if (current->references++ == 0) {
+                    this->unused.erase(current->unused_position);
+                }
+                return 0;
+            }
+            /** Remove a holder from a texture; once nobody holds it, it is kept until it needs to be evicted to stay under the budget
+             * \param handle The handle to the texture
+             * \returns 0 on success or -1 if the handle is stale (or the texture has no holders)
+             */
+            int release(const bengine::texture_handle &handle) {
+                bengine::texture_manager::slot *current = this->find(handle);
+                if (current == NULL || current->references == 0) {
+                    return -1;
+                }
+                if (--current->references == 0) {
+                    this->unused.push_front(handle.index);
+                    current->unused_position = this->unused.begin();
+                    this->trim();
+                }
+                return 0;
+            }
+
+            /** Check whether a handle still refers to a texture
+             * \param handle The handle to check
+             * \returns Whether the handle still refers to a texture or not
+             */
+            bool is_valid(const bengine::texture_handle &handle) const {
+                return this->find(handle) != NULL;
+            }
+            /** Get the texture that a handle refers to (don't destroy it or hold on to it past releasing the handle)
+             * \param handle The handle to the texture
+             * \returns The texture, or NULL if the handle is stale
+             */
+            SDL_Texture* get(const bengine::texture_handle &handle) const {
+                const bengine::texture_manager::slot *current = this->find(handle);
+                return current == NULL ? NULL : current->texture;
+            }
+            /** Get the texture that a handle refers to as a bengine::basic_texture
+             * \param handle The handle to the texture
+             * \returns A bengine::basic_texture that doesn't own its texture, with its frame set to the whole texture (empty if the handle is stale)
+             */
+            bengine::basic_texture get_basic_texture(const bengine::texture_handle &handle) const {
+                const bengine::texture_manager::slot *current = this->find(handle);
+                if (current == NULL) {
+                    return bengine::basic_texture(NULL, {}, false);
+                }
+                return bengine::basic_texture(current->texture, {0, 0, current->width, current->height}, false);
+            }
+            /** Get how many holders a texture has
+             * \param handle The handle to the texture
+             * \returns How many holders the texture has (0 if the handle is stale)
+             */
+            Uint32 get_references(const bengine::texture_handle &handle) const {
+                const bengine::texture_manager::slot *current = this->find(handle);
+                return current == NULL ? 0 : current->references;
+            }
+
+            /** Get how much memory textures can use before unused ones start getting evicted
+             * \returns The budget (bytes)
+             */
+            std::size_t get_budget() const {
+                return this->budget;
+            }
+            /** Set how much memory textures can use before unused ones start getting evicted (textures that are still held are never evicted, so usage can go over it)
+             * \param budget The budget (bytes)
+             */
+            void set_budget(const std::size_t &budget) {
+                this->budget = budget;
+                this->trim();
+            }
+            /** Get roughly how much memory the loaded textures use
+             * \returns The memory used (bytes)
+             */
+            std::size_t get_memory_usage() const {
+                return this->memory_usage;
+            }
+            /** Get the amount of loaded textures (held or not)
+             * \returns The amount of loaded textures
+             */
+            std::size_t get_texture_count() const {
+                return this->paths.size();
+            }
+            /** Get the amount of loaded textures that nobody holds
+             * \returns The amount of unused textures
+             */
+            std::size_t get_unused_count() const {
+                return this->unused.size();
+            }
+
+            // \brief Evict the least recently released textures until usage is back under the budget
+            void trim() {
+                while (this->memory_usage > this->budget && !this->unused.empty()) {
+                    const Uint32 index = this->unused.back();
+                    this->unused.pop_back();
+                    this->evict(index);
+                }
+            }
+            // \brief Evict every texture that nobody holds
+            void purge() {
+                while (!this->unused.empty()) {
+                    const Uint32 index = this->unused.back();
+                    this->unused.pop_back();
+                    this->evict(index);
+                }
+            }
+            // \brief Destroy every texture, held or not (every outstanding handle goes stale)
+            void clear() {
+                this->unused.clear();
+                for (Uint32 i = 0; i < this->slots.size(); i++) {
+                    if (this->slots[i].texture != NULL) {
+                        this->evict(i);
+                    }
+                }
+            }
+    };
+
+    // \brief Holds a texture from a bengine::texture_manager for as long as it exists (copies hold it too); it must not outlive its manager
+    class texture_reference {
+        private:
+            bengine::texture_manager *manager = NULL;
+            bengine::texture_handle handle;
+
+        public:
+            // \brief bengine::texture_reference constructor (refers to nothing)
+            texture_reference() {}
+            /** bengine::texture_reference constructor
+             * \param manager The manager to acquire the texture from
+             * \param path The path of the image to load
+             */
+            texture_reference(bengine::texture_manager &manager, const std::string &path) {
+                this->manager = &manager;
+                this->handle = manager.acquire(path);
+            }
+            // \brief bengine::texture_reference deconstructor
+            ~texture_reference() {
+                this->reset();
+            }
+            texture_reference(const bengine::texture_reference &rhs) {
+                this->manager = rhs.manager;
+                this->handle = rhs.handle;
+                if (this->manager != NULL) {
+                    this->manager->retain(this->handle);
+                }
+            }
+            texture_reference(bengine::texture_reference &&rhs) noexcept {
+                this->manager = rhs.manager;
+                this->handle = rhs.handle;
+                rhs.manager = NULL;
+                rhs.handle = {};
+            }
+            bengine::texture_reference& operator=(const bengine::texture_reference &rhs) {
+                if (this != &rhs) {
+                    // retaining first keeps the texture alive when both refer to the same one
+                    if (rhs.manager != NULL) {
+                        rhs.manager->retain(rhs.handle);
+                    }
+                    this->reset();
+                    this->manager = rhs.manager;
+                    this->handle = rhs.handle;
+                }
+                return *this;
+            }
+            bengine::texture_reference& operator=(bengine::texture_reference &&rhs) noexcept {
+                if (this != &rhs) {
+                    this->reset();
+                    this->manager = rhs.manager;
+                    this->handle = rhs.handle;
+                    rhs.manager = NULL;
+                    rhs.handle = {};
+                }
+                return *this;
+            }
+
+            // \brief Stop holding the texture
+            void reset() {
+                if (this->manager != NULL) {
+                    this->manager->release(this->handle);
+                }
+                this->manager = NULL;
+                this->handle = {};
+            }
+
+            /** Get the handle to the held texture
+             * \returns The handle to the held texture
+             */
+            bengine::texture_handle get_handle() const {
+                return this->handle;
+            }
+            /** Check whether the held texture is still loaded
+             * \returns Whether the held texture is still loaded or not
+             */
+            bool is_valid() const {
+                return this->manager != NULL && this->manager->is_valid(this->handle);
+            }
+            /** Get the held texture
+             * \returns The held texture, or NULL if there isn't one
+             */
+            SDL_Texture* get() const {
+                return this->manager == NULL ? NULL : this->manager->get(this->handle);
+            }
+            /** Get the held texture as a bengine::basic_texture
+             * \returns A bengine::basic_texture that doesn't own its texture, with its frame set to the whole texture
+             */
+            bengine::basic_texture get_basic_texture() const {
+                return this->manager == NULL ? bengine::basic_texture(NULL, {}, false) : this->manager->get_basic_texture(this->handle);
+            }
+    };
+}
+
+#endif // BENGINE_TEXTURE_MANAGER_hpp
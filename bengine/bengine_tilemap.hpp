@@ -0,0 +1,405 @@
+#ifndef BENGINE_TILEMAP_hpp
+#define BENGINE_TILEMAP_hpp
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <vector>
+
+#include "bengine_helpers.hpp"
+
+namespace bengine {
+    /** Draws a grid of tiles (like the ones made by bengine::autotiler) by splitting it into fixed-size chunks and rendering each chunk into its own texture once
+     * Drawing the map then only takes one copy per visible chunk, and changing a tile only re-renders the chunks it touches; chunk textures are only made for chunks that have been visible and get reused once there are too many, so huge maps don't need a texture for every chunk
+     */
+    class tilemap {
+        public:
+            // \brief Where one chunk's texture goes
+            struct chunk_view {
+                SDL_Texture *texture = NULL;
+                // \brief The part of the chunk texture that is used (edge chunks can be smaller than the others) (px)
+                SDL_Rect src = {0, 0, 0, 0};
+                // \brief Where the chunk is relative to the top-left corner of the map (px)
+                SDL_Rect dst = {0, 0, 0, 0};
+            };
+
+        private:
+            struct chunk {
+                SDL_Texture *texture = NULL;
+                // \brief Whether the chunk's tiles changed since it was last rendered
+                bool dirty = true;
+                // \brief Whether the chunk has no tiles at all (so it never needs a texture)
+                bool empty = false;
+                // \brief The last update that the chunk was visible during (for picking which texture to reuse)
+                unsigned long last_used = 0;
+            };
+
+            // \brief Tile values (-1 = no tile, anything else is an index into the tileset)
+            std::vector<std::vector<char>> grid;
+            int tile_width = 16;
+            int tile_height = 16;
+            // \brief The width and height of each chunk (tiles)
+            int chunk_size = 32;
+            int chunk_columns = 0;
+            int chunk_rows = 0;
+            std::vector<bengine::tilemap::chunk> chunks;
+
+            SDL_Texture *tileset = NULL;
+            // \brief The amount of tiles in each row of the tileset
+            int tileset_columns = 1;
+
+            // \brief The most chunk textures to keep at once (more than this are only made if that many chunks are visible at once)
+            std::size_t max_chunk_textures = 64;
+            // \brief Indices of the chunks that currently have a texture
+            std::vector<std::size_t> textured_chunks;
+            unsigned long update_count = 0;
+            // \brief Chunks that are visible during the current update (reused between calls)
+            std::vector<std::size_t> visible;
+
+            /** Divide rounding towards negative infinity (so that positions left of or above the map land in negative chunks)
+             * \param numerator The number to divide
+             * \param denominator The positive number to divide by
+             * \returns The rounded-down quotient
+             */
+            static int floor_divide(const int &numerator, const int &denominator) {
+                return numerator >= 0 ? numerator / denominator : -((-numerator + denominator - 1) / denominator);
+            }
+            // \brief Work out how many chunks the grid is split into (every chunk has to be rendered again)
+            void resize_chunks() {
+                this->clear();
+                const int columns = this->grid.empty() ? 0 : static_cast<int>(this->grid[0].size());
+                const int rows = static_cast<int>(this->grid.size());
+                this->chunk_columns = (columns + this->chunk_size - 1) / this->chunk_size;
+                this->chunk_rows = (rows + this->chunk_size - 1) / this->chunk_size;
+                this->chunks.assign(static_cast<std::size_t>(this->chunk_columns) * this->chunk_rows, bengine::tilemap::chunk());
+            }
+            /** Get the size of a chunk (edge chunks get cut off by the edges of the grid)
+             * \param column The column of the chunk
+             * \param row The row of the chunk
+             * \returns The chunk's width and height relative to the top-left corner of the map (px)
+             */
+            SDL_Rect get_chunk_area(const int &column, const int &row) const {
+                const int columns = static_cast<int>(this->grid[0].size()), rows = static_cast<int>(this->grid.size());
+                const int first_column = column * this->chunk_size, first_row = row * this->chunk_size;
+                const int last_column = first_column + this->chunk_size < columns ? first_column + this->chunk_size : columns;
+                const int last_row = first_row + this->chunk_size < rows ? first_row + this->chunk_size : rows;
+                return {first_column * this->tile_width, first_row * this->tile_height, (last_column - first_column) * this->tile_width, (last_row - first_row) * this->tile_height};
+            }
+            /** Give a chunk a texture, reusing the least recently visible chunk's texture if there are already too many
+             * \param renderer The renderer to make the texture with
+             * \param index The index of the chunk
+             * \returns 0 on success or -1 if the texture couldn't be made
+             */
+            int assign_texture(SDL_Renderer *renderer, const std::size_t &index) {
+                if (this->textured_chunks.size() >= this->max_chunk_textures) {
+                    std::size_t oldest = this->textured_chunks.size();
+                    for (std::size_t i = 0; i < this->textured_chunks.size(); i++) {
+                        const unsigned long last_used = this->chunks[this->textured_chunks[i]].last_used;
+                        if (last_used != this->update_count && (oldest == this->textured_chunks.size() || last_used < this->chunks[this->textured_chunks[oldest]].last_used)) {
+                            oldest = i;
+                        }
+                    }
+                    // every chunk texture is the same size, so taking one over just means rendering the new chunk into it
+                    if (oldest != this->textured_chunks.size()) {
+                        bengine::tilemap::chunk &previous = this->chunks[this->textured_chunks[oldest]];
+                        this->chunks[index].texture = previous.texture;
+                        previous.texture = NULL;
+                        previous.dirty = true;
+                        this->textured_chunks[oldest] = index;
+                        return 0;
+                    }
+                }
+
+                SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, this->chunk_size * this->tile_width, this->chunk_size * this->tile_height);
+                if (texture == NULL) {
+                    std::cout << "Tilemap failed to create a chunk texture [bengine::tilemap::assign_texture]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                    return -1;
+                }
+                SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+                this->chunks[index].texture = texture;
+                this->textured_chunks.push_back(index);
+                return 0;
+            }
+            /** Render a chunk's tiles into its texture (the renderer has to be targeting the texture already)
+             * \param renderer The renderer targeting the chunk's texture
+             * \param column The column of the chunk
+             * \param row The row of the chunk
+             */
+            void render_chunk(SDL_Renderer *renderer, const int &column, const int &row) {
+                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+                SDL_RenderClear(renderer);
+
+                const int columns = static_cast<int>(this->grid[0].size()), rows = static_cast<int>(this->grid.size());
+                const int first_column = column * this->chunk_size, first_row = row * this->chunk_size;
+                for (int y = first_row; y < first_row + this->chunk_size && y < rows; y++) {
+                    for (int x = first_column; x < first_column + this->chunk_size && x < columns; x++) {
+                        if (this->grid[y][x] < 0) {
+                            continue;
+                        }
+                        const int tile = static_cast<unsigned char>(this->grid[y][x]);
+                        const SDL_Rect src = {tile % this->tileset_columns * this->tile_width, tile / this->tileset_columns * this->tile_height, this->tile_width, this->tile_height};
+                        const SDL_Rect dst = {(x - first_column) * this->tile_width, (y - first_row) * this->tile_height, this->tile_width, this->tile_height};
+                        SDL_RenderCopy(renderer, this->tileset, &src, &dst);
+                    }
+                }
+            }
+            /** Check whether a chunk has any tiles in it
+             * \param column The column of the chunk
+             * \param row The row of the chunk
+             * \returns Whether the chunk has no tiles or not
+             */
+            bool is_chunk_empty(const int &column, const int &row) const {
+                const int columns = static_cast<int>(this->grid[0].size()), rows = static_cast<int>(this->grid.size());
+                for (int y = row * this->chunk_size; y < (row + 1) * this->chunk_size && y < rows; y++) {
+                    for (int x = column * this->chunk_size; x < (column + 1) * this->chunk_size && x < columns; x++) {
+                        if (this->grid[y][x] >= 0) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+
+        public:
+            /** bengine::tilemap constructor
+             * \param tile_width The width of each tile (px)
+             * \param tile_height The height of each tile (px)
+             * \param chunk_size The width and height of each chunk (tiles) (bigger chunks mean fewer copies but more re-rendering when a tile changes)
+             */
+            tilemap(const int &tile_width = 16, const int &tile_height = 16, const int &chunk_size = 32) {
+                this->tile_width = tile_width > 0 ? tile_width : 1;
+                this->tile_height = tile_height > 0 ? tile_height : 1;
+                this->chunk_size = chunk_size > 0 ? chunk_size : 1;
+            }
+            // \brief bengine::tilemap deconstructor
+            ~tilemap() {
+                this->clear();
+            }
+            tilemap(const bengine::tilemap&) = delete;
+            bengine::tilemap& operator=(const bengine::tilemap&) = delete;
+
+            /** Set the texture that tiles are taken from (every chunk gets rendered again)
+             * \param tileset The texture that tiles are taken from (not owned by the tilemap)
+             * \param columns The amount of tiles in each row of the tileset (tile n is at column n % columns, row n / columns)
+             */
+            void set_tileset(SDL_Texture *tileset, const int &columns) {
+                this->tileset = tileset;
+                this->tileset_columns = columns > 0 ? columns : 1;
+                this->invalidate_all();
+            }
+            /** Replace every tile (every chunk gets rendered again)
+             * \param grid Tile values (-1 = no tile, anything else is an index into the tileset), like the grids made by bengine::autotiler::populate_4_bit_grid()
+             */
+            void set_grid(const std::vector<std::vector<char>> &grid) {
+                this->grid = grid;
+                this->resize_chunks();
+            }
+            /** Get every tile (modify them through the tilemap so that the right chunks get rendered again)
+             * \returns Tile values (-1 = no tile, anything else is an index into the tileset)
+             */
+            const std::vector<std::vector<char>>& get_grid() const {
+                return this->grid;
+            }
+            /** Get the width of the map
+             * \returns The width of the map (tiles)
+             */
+            int get_columns() const {
+                return this->grid.empty() ? 0 : static_cast<int>(this->grid[0].size());
+            }
+            /** Get the height of the map
+             * \returns The height of the map (tiles)
+             */
+            int get_rows() const {
+                return static_cast<int>(this->grid.size());
+            }
+            /** Get a tile
+             * \param x x-position (col) of the tile
+             * \param y y-position (row) of the tile
+             * \returns The tile's value (-1 = no tile or out of bounds)
+             */
+            char get_tile(const int &x, const int &y) const {
+                if (x < 0 || y < 0 || x >= this->get_columns() || y >= this->get_rows()) {
+                    return -1;
+                }
+                return this->grid[y][x];
+            }
+            /** Set a tile directly (without autotiling)
+             * \param x x-position (col) of the tile
+             * \param y y-position (row) of the tile
+             * \param value The tile's new value (-1 = no tile, anything else is an index into the tileset)
+             */
+            void set_tile(const int &x, const int &y, const char &value) {
+                if (x < 0 || y < 0 || x >= this->get_columns() || y >= this->get_rows() || this->grid[y][x] == value) {
+                    return;
+                }
+                this->grid[y][x] = value;
+                this->invalidate_tiles(x, y, 1, 1);
+            }
+            /** Add or remove a tile in a 4-bit autotiled map (see bengine::autotiler::modify_4_bit_grid()); only the chunks that the tile and its neighbors are in get rendered again
+             * \param x x-position (col) of the tile
+             * \param y y-position (row) of the tile
+             * \param state Whether to add or remove a tile
+             * \param use_solid_boundaries Whether to consider the edges of the map as full or empty tiles
+             * \returns The value of the updated tile
+             */
+            char modify_4_bit_tile(const int &x, const int &y, const bool &state = true, const bool &use_solid_boundaries = false) {
+                if (x < 0 || y < 0) {
+                    return -1;
+                }
+                const char output = bengine::autotiler::modify_4_bit_grid(this->grid, x, y, state, use_solid_boundaries);
+                this->invalidate_tiles(x - 1, y - 1, 3, 3);
+                return output;
+            }
+            /** Add or remove a tile in an 8-bit autotiled map (see bengine::autotiler::modify_8_bit_grid()); only the chunks that the tile and its neighbors are in get rendered again
+             * \param x x-position (col) of the tile
+             * \param y y-position (row) of the tile
+             * \param state Whether to add or remove a tile
+             * \param use_solid_boundaries Whether to consider the edges of the map as full or empty tiles
+             * \returns The value of the updated tile
+             */
+            char modify_8_bit_tile(const int &x, const int &y, const bool &state = true, const bool &use_solid_boundaries = false) {
+                if (x < 0 || y < 0) {
+                    return -1;
+                }
+                const char output = bengine::autotiler::modify_8_bit_grid(this->grid, x, y, state, use_solid_boundaries);
+                this->invalidate_tiles(x - 1, y - 1, 3, 3);
+                return output;
+            }
+
+            /** Mark the chunks that some tiles are in as needing to be rendered again
+             * \param x x-position (col) of the top-left tile
+             * \param y y-position (row) of the top-left tile
+             * \param w The amount of columns
+             * \param h The amount of rows
+             */
+            void invalidate_tiles(const int &x, const int &y, const int &w, const int &h) {
+                const int left = (x > 0 ? x : 0) / this->chunk_size, top = (y > 0 ? y : 0) / this->chunk_size;
+                const int right = (x + w - 1) / this->chunk_size, bottom = (y + h - 1) / this->chunk_size;
+                for (int row = top; row <= bottom && row < this->chunk_rows; row++) {
+                    for (int column = left; column <= right && column < this->chunk_columns; column++) {
+                        this->chunks[static_cast<std::size_t>(row) * this->chunk_columns + column].dirty = true;
+                    }
+                }
+            }
+            // \brief Mark every chunk as needing to be rendered again (like after SDL_RENDER_TARGETS_RESET, which loses the contents of every target texture)
+            void invalidate_all() {
+                for (std::size_t i = 0; i < this->chunks.size(); i++) {
+                    this->chunks[i].dirty = true;
+                }
+            }
+            // \brief Destroy every chunk texture (they get made again as chunks become visible)
+            void clear() {
+                for (std::size_t i = 0; i < this->textured_chunks.size(); i++) {
+                    SDL_DestroyTexture(this->chunks[this->textured_chunks[i]].texture);
+                    this->chunks[this->textured_chunks[i]].texture = NULL;
+                }
+                this->textured_chunks.clear();
+                this->invalidate_all();
+            }
+
+            /** Get the most chunk textures that are kept at once
+             * \returns The most chunk textures that are kept at once
+             */
+            std::size_t get_max_chunk_textures() const {
+                return this->max_chunk_textures;
+            }
+            /** Set the most chunk textures that are kept at once (each one is chunk_size * tile_width by chunk_size * tile_height pixels); it should be at least the amount of chunks that can be visible at once, since more get made when they are
+             * \param count The most chunk textures to keep at once
+             */
+            void set_max_chunk_textures(const std::size_t &count) {
+                this->max_chunk_textures = count;
+            }
+            /** Get the amount of chunk textures that currently exist
+             * \returns The amount of chunk textures
+             */
+            std::size_t get_chunk_texture_count() const {
+                return this->textured_chunks.size();
+            }
+
+            /** Render the visible chunks that changed (or haven't been rendered yet) into their textures and find where every visible chunk goes; the renderer's target (along with its drawing color and blend mode) is changed while this happens and set back afterwards, which removes its clip rectangle
+             * \param renderer The renderer to make and render chunk textures with
+             * \param area The visible part of the map relative to its top-left corner (px)
+             * \param views Filled with the visible chunks that have tiles in them
+             * \returns The amount of chunks that got rendered, or -1 if something went wrong
+             */
+            int update(SDL_Renderer *renderer, const SDL_Rect &area, std::vector<bengine::tilemap::chunk_view> &views) {
+                views.clear();
+                if (this->chunks.empty() || area.w <= 0 || area.h <= 0) {
+                    return 0;
+                }
+                this->update_count++;
+
+                const int chunk_width = this->chunk_size * this->tile_width, chunk_height = this->chunk_size * this->tile_height;
+                const int left = bengine::math_helper::clamp_value_to_range<int>(bengine::tilemap::floor_divide(area.x, chunk_width), 0, this->chunk_columns);
+                const int top = bengine::math_helper::clamp_value_to_range<int>(bengine::tilemap::floor_divide(area.y, chunk_height), 0, this->chunk_rows);
+                const int right = bengine::math_helper::clamp_value_to_range<int>(bengine::tilemap::floor_divide(area.x + area.w - 1, chunk_width) + 1, 0, this->chunk_columns);
+                const int bottom = bengine::math_helper::clamp_value_to_range<int>(bengine::tilemap::floor_divide(area.y + area.h - 1, chunk_height) + 1, 0, this->chunk_rows);
+
+                // textures are handed out before anything is rendered so that a visible chunk never loses its texture to another visible chunk
+                this->visible.clear();
+                for (int row = top; row < bottom; row++) {
+                    for (int column = left; column < right; column++) {
+                        const std::size_t index = static_cast<std::size_t>(row) * this->chunk_columns + column;
+                        bengine::tilemap::chunk &current = this->chunks[index];
+                        current.last_used = this->update_count;
+                        if (current.dirty) {
+                            current.empty = this->is_chunk_empty(column, row);
+                            // empty chunks have nothing to render, so they are clean until a tile in them changes
+                            if (current.empty) {
+                                current.dirty = false;
+                            }
+                        }
+                        if (!current.empty) {
+                            this->visible.push_back(index);
+                        }
+                    }
+                }
+                int output = 0;
+                SDL_Texture *previous_target = NULL;
+                SDL_BlendMode previous_blend_mode;
+                Uint8 r, g, b, a;
+                bool switched = false;
+                for (std::size_t i = 0; i < this->visible.size(); i++) {
+                    bengine::tilemap::chunk &current = this->chunks[this->visible[i]];
+                    if (current.texture == NULL && this->assign_texture(renderer, this->visible[i]) != 0) {
+                        output = -1;
+                        break;
+                    }
+                    if (!current.dirty) {
+                        continue;
+                    }
+                    if (!switched) {
+                        previous_target = SDL_GetRenderTarget(renderer);
+                        SDL_GetRenderDrawBlendMode(renderer, &previous_blend_mode);
+                        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+                        switched = true;
+                    }
+                    if (SDL_SetRenderTarget(renderer, current.texture) != 0) {
+                        std::cout << "Tilemap failed to target a chunk texture [bengine::tilemap::update]\nERROR [" << SDL_GetTicks() << "]: " << SDL_GetError() << "\n";
+                        output = -1;
+                        break;
+                    }
+                    this->render_chunk(renderer, static_cast<int>(this->visible[i] % this->chunk_columns), static_cast<int>(this->visible[i] / this->chunk_columns));
+                    current.dirty = false;
+                    output++;
+                }
+                if (switched) {
+                    SDL_SetRenderTarget(renderer, previous_target);
+                    SDL_SetRenderDrawBlendMode(renderer, previous_blend_mode);
+                    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+                }
+                if (output < 0) {
+                    return output;
+                }
+
+                for (std::size_t i = 0; i < this->visible.size(); i++) {
+                    const int column = static_cast<int>(this->visible[i] % this->chunk_columns), row = static_cast<int>(this->visible[i] / this->chunk_columns);
+                    const SDL_Rect dst = this->get_chunk_area(column, row);
+                    views.push_back({this->chunks[this->visible[i]].texture, {0, 0, dst.w, dst.h}, dst});
+                }
+                return output;
+            }
+    };
+}
+
+#endif // BENGINE_TILEMAP_hpp
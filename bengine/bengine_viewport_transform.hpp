@@ -0,0 +1,158 @@
+#ifndef BENGINE_VIEWPORT_TRANSFORM_hpp
+#define BENGINE_VIEWPORT_TRANSFORM_hpp
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+
+namespace bengine {
+    /** A 2x3 affine matrix used to map coordinates from one space to another (like from a window's base dimensions to its current ones)
+     * | x' |   | xx  xy  x_offset |   | x |
+     * | y' | = | yx  yy  y_offset | * | y |
+     *                                 | 1 |
+     */
+    class viewport_transform {
+        private:
+            float xx = 1;
+            float xy = 0;
+            float x_offset = 0;
+            float yx = 0;
+            float yy = 1;
+            float y_offset = 0;
+
+        public:
+            /** bengine::viewport_transform constructor (identity by default)
+             * \param xx How much an x-input affects the x-output
+             * \param xy How much a y-input affects the x-output
+             * \param x_offset What gets added to the x-output
+             * \param yx How much an x-input affects the y-output
+             * \param yy How much a y-input affects the y-output
+             * \param y_offset What gets added to the y-output
+             */
+            viewport_transform(const float &xx = 1, const float &xy = 0, const float &x_offset = 0, const float &yx = 0, const float &yy = 1, const float &y_offset = 0) {
+                this->xx = xx;
+                this->xy = xy;
+                this->x_offset = x_offset;
+                this->yx = yx;
+                this->yy = yy;
+                this->y_offset = y_offset;
+            }
+            // \brief bengine::viewport_transform deconstructor
+            ~viewport_transform() {}
+
+            /** Make a transform that scales and then offsets
+             * \param x_scale How much to scale x-values
+             * \param y_scale How much to scale y-values
+             * \param x_offset What to add to x-values after scaling
+             * \param y_offset What to add to y-values after scaling
+             * \returns The transform
+             */
+            static bengine::viewport_transform scale_offset(const float &x_scale, const float &y_scale, const float &x_offset = 0, const float &y_offset = 0) {
+                return bengine::viewport_transform(x_scale, 0, x_offset, 0, y_scale, y_offset);
+            }
+
+            /** Get whether the transform keeps rectangles axis-aligned (no rotation or shearing) or not
+             * \returns Whether the transform keeps rectangles axis-aligned or not
+             */
+            bool is_axis_aligned() const {
+                return this->xy == 0 && this->yx == 0;
+            }
+            /** Get whether the transform changes anything or not
+             * \returns Whether the transform is the identity or not
+             */
+            bool is_identity() const {
+                return this->is_axis_aligned() && this->xx == 1 && this->yy == 1 && this->x_offset == 0 && this->y_offset == 0;
+            }
+            /** Get how much the transform scales x-values (assuming it is axis-aligned)
+             * \returns How much the transform scales x-values
+             */
+            float get_x_scale() const {
+                return this->xx;
+            }
+            /** Get how much the transform scales y-values (assuming it is axis-aligned)
+             * \returns How much the transform scales y-values
+             */
+            float get_y_scale() const {
+                return this->yy;
+            }
+
+            /** Apply the transform to a point
+             * \param x x-position of the point
+             * \param y y-position of the point
+             * \returns The transformed point
+             */
+            SDL_FPoint apply(const float &x, const float &y) const {
+                return {this->xx * x + this->xy * y + this->x_offset, this->yx * x + this->yy * y + this->y_offset};
+            }
+            /** Apply the transform to a rectangle, flipping negative widths/heights (rotated/sheared transforms give the bounding box of the result)
+             * \param rect The rectangle to transform
+             * \returns The transformed rectangle
+             */
+            SDL_FRect apply(const SDL_Rect &rect) const {
+                SDL_FRect output;
+                if (this->is_axis_aligned()) {
+                    output = {this->xx * rect.x + this->x_offset, this->yy * rect.y + this->y_offset, this->xx * rect.w, this->yy * rect.h};
+                } else {
+                    const SDL_FPoint corners[4] = {this->apply(rect.x, rect.y), this->apply(rect.x + rect.w, rect.y), this->apply(rect.x + rect.w, rect.y + rect.h), this->apply(rect.x, rect.y + rect.h)};
+                    float left = corners[0].x, right = corners[0].x, top = corners[0].y, bottom = corners[0].y;
+                    for (unsigned char i = 1; i < 4; i++) {
+                        left = corners[i].x < left ? corners[i].x : left;
+                        right = corners[i].x > right ? corners[i].x : right;
+                        top = corners[i].y < top ? corners[i].y : top;
+                        bottom = corners[i].y > bottom ? corners[i].y : bottom;
+                    }
+                    return {left, top, right - left, bottom - top};
+                }
+                if (output.w < 0) {
+                    output.x += output.w;
+                    output.w = -output.w;
+                }
+                if (output.h < 0) {
+                    output.y += output.h;
+                    output.h = -output.h;
+                }
+                return output;
+            }
+            /** Apply the transform to many rectangles at once
+             * \param input The rectangles to transform
+             * \param count The amount of rectangles
+             * \param output Where to put the transformed rectangles (must have room for count rectangles)
+             */
+            void apply(const SDL_Rect *input, const std::size_t &count, SDL_FRect *output) const {
+                if (!this->is_axis_aligned()) {
+                    for (std::size_t i = 0; i < count; i++) {
+                        output[i] = this->apply(input[i]);
+                    }
+                    return;
+                }
+                // the common case is kept branch-free apart from the flips so that it vectorizes
+                for (std::size_t i = 0; i < count; i++) {
+                    float x = this->xx * input[i].x + this->x_offset, y = this->yy * input[i].y + this->y_offset, w = this->xx * input[i].w, h = this->yy * input[i].h;
+                    x = w < 0 ? x + w : x;
+                    y = h < 0 ? y + h : y;
+                    output[i] = {x, y, w < 0 ? -w : w, h < 0 ? -h : h};
+                }
+            }
+            /** Apply only the scaling part of the transform to an offset (for things like pivots that are relative to another point)
+             * \param x x-value of the offset
+             * \param y y-value of the offset
+             * \returns The transformed offset
+             */
+            SDL_FPoint apply_to_offset(const float &x, const float &y) const {
+                return {this->xx * x + this->xy * y, this->yx * x + this->yy * y};
+            }
+
+            /** Get the transform that undoes this one
+             * \returns The inverse transform (the identity if this one can't be undone)
+             */
+            bengine::viewport_transform inverse() const {
+                const float determinant = this->xx * this->yy - this->xy * this->yx;
+                if (determinant == 0) {
+                    return bengine::viewport_transform();
+                }
+                const float ixx = this->yy / determinant, ixy = -this->xy / determinant, iyx = -this->yx / determinant, iyy = this->xx / determinant;
+                return bengine::viewport_transform(ixx, ixy, -(ixx * this->x_offset + ixy * this->y_offset), iyx, iyy, -(iyx * this->x_offset + iyy * this->y_offset));
+            }
+    };
+}
+
+#endif // BENGINE_VIEWPORT_TRANSFORM_hpp
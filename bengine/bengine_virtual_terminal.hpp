@@ -0,0 +1,401 @@
+#ifndef BENGINE_VIRTUAL_TERMINAL_hpp
+#define BENGINE_VIRTUAL_TERMINAL_hpp
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bengine_terminal_output.hpp"
+
+namespace bengine {
+    /** An in-memory bengine::terminal_output so that curses windows and loops can run without a tty (for tests and benchmarks)
+     * Input can be queued from any thread (a blocking read waits for it, like a real terminal waits for a key press); everything else belongs to the thread running the loop
+     */
+    class virtual_terminal : public bengine::terminal_output {
+        public:
+            // \brief A single cell of the virtual terminal
+            struct cell {
+                wchar_t character = L' ';
+                unsigned char color_pair = 0;
+                unsigned short attributes = 0;
+
+                bool operator==(const bengine::virtual_terminal::cell &rhs) const {
+                    return this->character == rhs.character && this->color_pair == rhs.color_pair && this->attributes == rhs.attributes;
+                }
+                bool operator!=(const bengine::virtual_terminal::cell &rhs) const {
+                    return !(*this == rhs);
+                }
+            };
+
+        private:
+            // \brief Width of the virtual terminal (cols)
+            int cols = 80;
+            // \brief Height of the virtual terminal (rows)
+            int lines = 24;
+            // \brief Every cell of the virtual terminal, row by row
+            std::vector<bengine::virtual_terminal::cell> cells = std::vector<bengine::virtual_terminal::cell>(80 * 24);
+
+            // \brief Guards the queued inputs and mouse events, along with the mouse settings that decide which mouse events get queued
+            mutable std::mutex input_mutex;
+            // \brief Wakes up blocking reads when input is queued
+            std::condition_variable input_queued;
+            // \brief Inputs waiting to be read, oldest first
+            std::deque<int> inputs;
+            // \brief Mouse events waiting to be read (one for each KEY_MOUSE input), oldest first
+            std::deque<bengine::terminal_output::mouse_event> mouse_events;
+            // \brief Whether mouse events are being reported or not
+            bool mouse_enabled = false;
+            // \brief Whether mouse motion is being reported or not
+            bool mouse_motion_enabled = false;
+
+            // \brief The amount of cells that have been put onto the terminal
+            unsigned long long cells_written = 0;
+            // \brief The amount of times that the terminal has been refreshed
+            unsigned long long refresh_count = 0;
+            // \brief The amount of time that would have been spent sleeping (ms)
+            unsigned long long milliseconds_slept = 0;
+
+        public:
+            // \brief bengine::virtual_terminal constructor (80x24)
+            virtual_terminal() {}
+            /** bengine::virtual_terminal constructor
+             * \param cols Width of the virtual terminal
+             * \param lines Height of the virtual terminal
+             */
+            virtual_terminal(const int &cols, const int &lines) {
+                this->resize(cols, lines);
+            }
+            // \brief bengine::virtual_terminal deconstructor
+            ~virtual_terminal() {}
+
+            int get_cols() const override {
+                return this->cols;
+            }
+            int get_lines() const override {
+                return this->lines;
+            }
+            /** Change the size of the virtual terminal, clearing it in the process
+             * \param cols The new width
+             * \param lines The new height
+             */
+            void resize(const int &cols, const int &lines) {
+                this->cols = cols < 1 ? 1 : cols;
+                this->lines = lines < 1 ? 1 : lines;
+                this->cells.assign(this->cols * this->lines, bengine::virtual_terminal::cell());
+            }
+
+            void put_cell(const int &x, const int &y, const wchar_t &character, const unsigned char &color_pair, const unsigned short &attributes) override {
+                if (x < 0 || x >= this->cols || y < 0 || y >= this->lines) {
+                    return;
+                }
+                bengine::virtual_terminal::cell &cell = this->cells[y * this->cols + x];
+                cell.character = character;
+                cell.color_pair = color_pair;
+                cell.attributes = attributes;
+                this->cells_written++;
+            }
+            void clear() override {
+                this->cells.assign(this->cols * this->lines, bengine::virtual_terminal::cell());
+            }
+            void refresh() override {
+                this->refresh_count++;
+            }
+
+            // \brief Read the next queued input (a blocking read waits until another thread queues something; otherwise ERR is returned if nothing is queued)
+            int read_input(const bool &blocking = false) override {
+                std::unique_lock<std::mutex> lock(this->input_mutex);
+                if (blocking) {
+                    this->input_queued.wait(lock, [this]() {return !this->inputs.empty();});
+                } else if (this->inputs.empty()) {
+                    return ERR;
+                }
+                const int output = this->inputs.front();
+                this->inputs.pop_front();
+                return output;
+            }
+            void push_input(const int &input) override {
+                {
+                    std::lock_guard<std::mutex> lock(this->input_mutex);
+                    this->inputs.push_front(input);
+                }
+                this->input_queued.notify_all();
+            }
+            /** Queue up an input to be read after every other queued input
+             * \param input The input to queue
+             */
+            void queue_input(const int &input) {
+                {
+                    std::lock_guard<std::mutex> lock(this->input_mutex);
+                    this->inputs.push_back(input);
+                }
+                this->input_queued.notify_all();
+            }
+            /** Queue up a string of inputs (one per character) to be read after every other queued input
+             * \param inputs The inputs to queue
+             */
+            void queue_input(const std::string &inputs) {
+                {
+                    std::lock_guard<std::mutex> lock(this->input_mutex);
+                    for (std::size_t i = 0; i < inputs.length(); i++) {
+                        this->inputs.push_back(static_cast<unsigned char>(inputs[i]));
+                    }
+                }
+                this->input_queued.notify_all();
+            }
+            /** Get the amount of inputs that are waiting to be read
+             * \returns The amount of inputs that are waiting to be read
+             */
+            std::size_t get_queued_input_count() const {
+                std::lock_guard<std::mutex> lock(this->input_mutex);
+                return this->inputs.size();
+            }
+
+            void enable_mouse(const bool &report_motion) override {
+                std::lock_guard<std::mutex> lock(this->input_mutex);
+                this->mouse_enabled = true;
+                this->mouse_motion_enabled = report_motion;
+            }
+            void disable_mouse() override {
+                std::lock_guard<std::mutex> lock(this->input_mutex);
+                this->mouse_enabled = false;
+                this->mouse_motion_enabled = false;
+            }
+            bool read_mouse(bengine::terminal_output::mouse_event &event) override {
+                std::lock_guard<std::mutex> lock(this->input_mutex);
+                if (this->mouse_events.empty()) {
+                    return false;
+                }
+                event = this->mouse_events.front();
+                this->mouse_events.pop_front();
+                return true;
+            }
+            /** Queue up a mouse event (and the KEY_MOUSE input that goes with it) to be read after every other queued input; ignored unless the mouse has been enabled, and motion is ignored unless motion reporting has been enabled
+             * \param x x-position (col) of the mouse
+             * \param y y-position (row) of the mouse
+             * \param buttons Which buttons changed/what happened as an ncurses mouse mask (BUTTON1_PRESSED, REPORT_MOUSE_POSITION, etc)
+             */
+            void queue_mouse(const int &x, const int &y, const unsigned long &buttons) {
+                {
+                    std::lock_guard<std::mutex> lock(this->input_mutex);
+                    if (!this->mouse_enabled || (!this->mouse_motion_enabled && buttons == REPORT_MOUSE_POSITION)) {
+                        return;
+                    }
+                    this->inputs.push_back(KEY_MOUSE);
+                    this->mouse_events.push_back({x, y, buttons});
+                }
+                this->input_queued.notify_all();
+            }
+            /** Get whether mouse events are being reported or not (queue_mouse() ignores mouse events while they aren't)
+             * \returns Whether mouse events are being reported or not
+             */
+            bool is_mouse_enabled() const {
+                std::lock_guard<std::mutex> lock(this->input_mutex);
+                return this->mouse_enabled;
+            }
+
+            // \brief Doesn't actually sleep; the time is only tallied so that loops run at full speed
+            void sleep(const int &milliseconds) override {
+                this->milliseconds_slept += milliseconds < 0 ? 0 : milliseconds;
+            }
+
+            /** Get a cell of the virtual terminal
+             * \param x x-position (col) of the cell
+             * \param y y-position (row) of the cell
+             * \returns The cell, or a blank cell if out of bounds
+             */
+            bengine::virtual_terminal::cell get_cell(const int &x, const int &y) const {
+                if (x < 0 || x >= this->cols || y < 0 || y >= this->lines) {
+                    return bengine::virtual_terminal::cell();
+                }
+                return this->cells[y * this->cols + x];
+            }
+            /** Get the character of a cell of the virtual terminal
+             * \param x x-position (col) of the cell
+             * \param y y-position (row) of the cell
+             * \returns The character of the cell, or a space if out of bounds
+             */
+            wchar_t get_character(const int &x, const int &y) const {
+                return this->get_cell(x, y).character;
+            }
+            /** Get the characters of a single row of the virtual terminal
+             * \param y The row to get
+             * \returns The characters of the row, or an empty string if out of bounds
+             */
+            std::wstring get_row(const int &y) const {
+                std::wstring output;
+                if (y < 0 || y >= this->lines) {
+                    return output;
+                }
+                output.reserve(this->cols);
+                for (int x = 0; x < this->cols; x++) {
+                    output += this->cells[y * this->cols + x].character;
+                }
+                return output;
+            }
+            /** Get the characters of the entire virtual terminal
+             * \returns One string per row of the virtual terminal
+             */
+            std::vector<std::wstring> get_frame() const {
+                std::vector<std::wstring> output;
+                output.reserve(this->lines);
+                for (int y = 0; y < this->lines; y++) {
+                    output.emplace_back(this->get_row(y));
+                }
+                return output;
+            }
+
+            /** Get the amount of cells that have been put onto the terminal since the statistics were last reset
+             * \returns The amount of cells that have been put onto the terminal
+             */
+            unsigned long long get_cells_written() const {
+                return this->cells_written;
+            }
+            /** Get the amount of times that the terminal has been refreshed since the statistics were last reset
+             * \returns The amount of times that the terminal has been refreshed
+             */
+            unsigned long long get_refresh_count() const {
+                return this->refresh_count;
+            }
+            /** Get the amount of time that would have been spent sleeping since the statistics were last reset
+             * \returns The amount of time that would have been spent sleeping (ms)
+             */
+            unsigned long long get_milliseconds_slept() const {
+                return this->milliseconds_slept;
+            }
+            // \brief Zero the amount of cells written, refreshes, and time slept
+            void reset_statistics() {
+                this->cells_written = 0;
+                this->refresh_count = 0;
+                this->milliseconds_slept = 0;
+            }
+
+            /** Count how many characters of a region differ from a golden frame; rows/cols missing from the golden frame are treated as spaces
+             * \param expected The golden frame (one string per row)
+             * \param x x-position (col) of the top-left corner of the region to compare against
+             * \param y y-position (row) of the top-left corner of the region to compare against
+             * \returns The amount of characters that differ
+             */
+            std::size_t count_mismatches(const std::vector<std::wstring> &expected, const int &x = 0, const int &y = 0) const {
+                std::size_t output = 0;
+                std::size_t width = 0;
+                for (std::size_t row = 0; row < expected.size(); row++) {
+                    width = expected[row].length() > width ? expected[row].length() : width;
+                }
+                for (std::size_t row = 0; row < expected.size(); row++) {
+                    for (std::size_t col = 0; col < width; col++) {
+                        if (this->get_character(x + col, y + row) != (col < expected[row].length() ? expected[row][col] : L' ')) {
+                            output++;
+                        }
+                    }
+                }
+                return output;
+            }
+            /** Check whether a region matches a golden frame exactly (characters only)
+             * \param expected The golden frame (one string per row)
+             * \param x x-position (col) of the top-left corner of the region to compare against
+             * \param y y-position (row) of the top-left corner of the region to compare against
+             * \returns Whether the region matches or not
+             */
+            bool matches_frame(const std::vector<std::wstring> &expected, const int &x = 0, const int &y = 0) const {
+                return this->count_mismatches(expected, x, y) == 0;
+            }
+            /** Describe every row of a region that doesn't match a golden frame, showing the expected and actual rows
+             * \param expected The golden frame (one string per row)
+             * \param x x-position (col) of the top-left corner of the region to compare against
+             * \param y y-position (row) of the top-left corner of the region to compare against
+             * \returns A human-readable diff (empty if the region matches)
+             */
+            std::wstring describe_mismatches(const std::vector<std::wstring> &expected, const int &x = 0, const int &y = 0) const {
+                std::wstring output;
+                for (std::size_t row = 0; row < expected.size(); row++) {
+                    std::wstring actual;
+                    for (std::size_t col = 0; col < expected[row].length(); col++) {
+                        actual += this->get_character(x + col, y + row);
+                    }
+                    if (actual != expected[row]) {
+                        output += L"row " + std::to_wstring(row) + L"\n  expected |" + expected[row] + L"|\n  actual   |" + actual + L"|\n";
+                    }
+                }
+                return output;
+            }
+
+            /** Write the characters of the entire virtual terminal to a UTF-8 file so that it can be used as a golden frame later
+             * \param path The path of the file to write to
+             * \returns 0 on success or -1 if the file couldn't be opened
+             */
+            int save_frame(const std::string &path) const {
+                std::ofstream file(path, std::ios::binary);
+                if (!file.is_open()) {
+                    std::cout << "Virtual terminal failed to open \"" << path << "\" [bengine::virtual_terminal::save_frame]\n";
+                    return -1;
+                }
+                for (int y = 0; y < this->lines; y++) {
+                    file << bengine::virtual_terminal::encode_utf8(this->get_row(y)) << '\n';
+                }
+                return 0;
+            }
+            /** Read a golden frame from a UTF-8 file
+             * \param path The path of the file to read from
+             * \param frame Where to put the frame (one string per row)
+             * \returns 0 on success or -1 if the file couldn't be opened
+             */
+            static int load_frame(const std::string &path, std::vector<std::wstring> &frame) {
+                std::ifstream file(path, std::ios::binary);
+                if (!file.is_open()) {
+                    std::cout << "Virtual terminal failed to open \"" << path << "\" [bengine::virtual_terminal::load_frame]\n";
+                    return -1;
+                }
+                frame.clear();
+                std::string line;
+                while (std::getline(file, line)) {
+                    frame.emplace_back(bengine::virtual_terminal::decode_utf8(line));
+                }
+                return 0;
+            }
+
+            static std::string encode_utf8(const std::wstring &input) {
+                std::string output;
+                output.reserve(input.length());
+                for (std::size_t i = 0; i < input.length(); i++) {
+                    const unsigned long code = static_cast<unsigned long>(input[i]);
+                    if (code < 0x80) {
+                        output += static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        output += static_cast<char>(0xC0 | (code >> 6));
+                        output += static_cast<char>(0x80 | (code & 0x3F));
+                    } else if (code < 0x10000) {
+                        output += static_cast<char>(0xE0 | (code >> 12));
+                        output += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        output += static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        output += static_cast<char>(0xF0 | (code >> 18));
+                        output += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                        output += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        output += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                }
+                return output;
+            }
+            static std::wstring decode_utf8(const std::string &input) {
+                std::wstring output;
+                output.reserve(input.length());
+                for (std::size_t i = 0; i < input.length();) {
+                    const unsigned char lead = static_cast<unsigned char>(input[i]);
+                    unsigned char extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+                    unsigned long code = extra == 0 ? lead : lead & (0x3F >> extra);
+                    i++;
+                    for (; extra > 0 && i < input.length(); extra--, i++) {
+                        code = (code << 6) | (static_cast<unsigned char>(input[i]) & 0x3F);
+                    }
+                    output += static_cast<wchar_t>(code);
+                }
+                return output;
+            }
+    };
+}
+
+#endif // BENGINE_VIRTUAL_TERMINAL_hpp
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "bengine_curses.hpp"
+
+// renders every cell of a terminal-sized window each frame, changing a line of text as it goes
+class full_text_scene : public bengine::curses_loop {
+    private:
+        bengine::curses_window window;
+        unsigned long long frame = 0;
+
+        void handle_event() {}
+        void compute() {
+            const unsigned short row = this->frame++ % this->window.get_height();
+            this->window.write_string(0, row, L"The quick brown fox jumps over the lazy dog " + std::to_wstring(this->frame), bengine::curses_window::make_write_args(bengine::curses_window::write_arg_options::COLOR | bengine::curses_window::write_arg_options::WRAPPING_MODE, {static_cast<unsigned short>(1 + this->frame % 15), bengine::curses_window::wrapping_modes::NONE}));
+            this->visuals_changed = true;
+        }
+        void render() {
+            this->window.apply_to_screen();
+        }
+
+    public:
+        full_text_scene(bengine::virtual_terminal &terminal) : bengine::curses_loop(terminal) {
+            for (unsigned short y = 0; y < this->window.get_height(); y++) {
+                for (unsigned short x = 0; x < this->window.get_width(); x++) {
+                    this->window.write_character(x, y, L'a' + (x + y) % 26);
+                }
+            }
+        }
+};
+
+// a grid of box-drawn panels that get redrawn and put on the screen each frame
+class box_panel_scene : public bengine::curses_loop {
+    private:
+        std::vector<bengine::curses_window> panels;
+        unsigned long long frame = 0;
+
+        void handle_event() {}
+        void compute() {
+            bengine::curses_window &panel = this->panels[this->frame++ % this->panels.size()];
+            const unsigned short settings = (this->frame % 2 == 0 ? bengine::curses_window::LIGHT_ROUNDED : bengine::curses_window::HEAVY_BOTH);
+            panel.draw_horizontal_line(0, 0, panel.get_width(), settings);
+            panel.draw_horizontal_line(0, panel.get_height() - 1, panel.get_width(), settings);
+            panel.draw_vertical_line(0, 0, panel.get_height(), settings);
+            panel.draw_vertical_line(panel.get_width() - 1, 0, panel.get_height(), settings);
+            this->visuals_changed = true;
+        }
+        void render() {
+            for (std::size_t i = 0; i < this->panels.size(); i++) {
+                this->panels[i].apply_to_screen();
+            }
+        }
+
+    public:
+        box_panel_scene(bengine::virtual_terminal &terminal) : bengine::curses_loop(terminal) {
+            const unsigned short panel_width = terminal.get_cols() / 8, panel_height = terminal.get_lines() / 4;
+            for (unsigned short y = 0; y < 4; y++) {
+                for (unsigned short x = 0; x < 8; x++) {
+                    this->panels.emplace_back(x * panel_width, y * panel_height, panel_width, panel_height);
+                    this->panels.back().write_string(2, 1, L"panel " + std::to_wstring(y * 8 + x));
+                }
+            }
+        }
+};
+
+// many small overlapping windows with colored and attributed text
+class small_window_scene : public bengine::curses_loop {
+    private:
+        std::vector<bengine::curses_window> windows;
+        unsigned long long frame = 0;
+
+        void handle_event() {}
+        void compute() {
+            this->frame++;
+            for (std::size_t i = 0; i < this->windows.size(); i++) {
+                this->windows[i].set_x_pos((i * 7 + this->frame) % 180);
+                this->windows[i].set_y_pos((i * 3 + this->frame / 4) % 55);
+            }
+            this->visuals_changed = true;
+        }
+        void render() {
+            for (std::size_t i = 0; i < this->windows.size(); i++) {
+                this->windows[i].apply_to_screen();
+            }
+        }
+
+    public:
+        small_window_scene(bengine::virtual_terminal &terminal) : bengine::curses_loop(terminal) {
+            for (unsigned char i = 0; i < 64; i++) {
+                this->windows.emplace_back(0, 0, 20, 5);
+                this->windows.back().write_string(0, 0, L"window " + std::to_wstring(i) + L" ░▒▓█ ┌─┐", bengine::curses_window::make_write_args(bengine::curses_window::write_arg_options::COLOR | bengine::curses_window::write_arg_options::ATTRIBUTES, {static_cast<unsigned short>(1 + i % 15), static_cast<unsigned short>(1 << (i % 10))}));
+            }
+        }
+};
+
+template <class scene> void run_scene(const char *name, const unsigned long long &frames) {
+    bengine::virtual_terminal terminal(200, 60);
+    scene benchmark(terminal);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const unsigned long long frames_run = benchmark.run_frames(frames);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%-14s %8llu frames %10.3f ms %12.0f frames/s %14.0f cells/s\n", name, frames_run, seconds * 1000, frames_run / seconds, terminal.get_cells_written() / seconds);
+}
+
+int main(int argc, char *argv[]) {
+    const unsigned long long frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+
+    std::printf("bengine curses benchmark (200x60 virtual terminal, %llu frames per scene)\n", frames);
+    run_scene<full_text_scene>("full_text", frames);
+    run_scene<box_panel_scene>("box_panels", frames);
+    run_scene<small_window_scene>("small_windows", frames);
+    return 0;
+}
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bengine.hpp"
+
+// every allocation made while the benchmark runs goes through here so that each frame's allocations can be counted
+static std::atomic<unsigned long long> allocation_count(0);
+
+// (kept out of line so that GCC doesn't see malloc and free through the inlined operators and warn about mismatched allocations)
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *output = std::malloc(size > 0 ? size : 1)) {
+        return output;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size > 0 ? size : 1);
+}
+void* operator new[](std::size_t size, const std::nothrow_t &nothrow) noexcept {
+    return operator new(size, nothrow);
+}
+__attribute__((noinline)) void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+void operator delete[](void *pointer) noexcept {
+    operator delete(pointer);
+}
+void operator delete(void *pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+void operator delete[](void *pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+/** Make a texture filled with a checkerboard (so that the benchmark doesn't need any image files)
+ * \param renderer The renderer to make the texture with
+ * \param width The width of the texture (px)
+ * \param height The height of the texture (px)
+ * \param cell The size of each checkerboard cell (px)
+ * \returns The texture, or NULL if it couldn't be made
+ */
+static SDL_Texture* make_checkerboard(SDL_Renderer *renderer, const int &width, const int &height, const int &cell) {
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (surface == NULL) {
+        return NULL;
+    }
+    for (int y = 0; y < height; y += cell) {
+        for (int x = 0; x < width; x += cell) {
+            const SDL_Rect area = {x, y, cell, cell};
+            SDL_FillRect(surface, &area, (x / cell + y / cell) % 2 == 0 ? SDL_MapRGBA(surface->format, 230, 120, 40, 255) : SDL_MapRGBA(surface->format, 40, 120, 230, 255));
+        }
+    }
+    SDL_Texture *output = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    return output;
+}
+
+// the timings and counts of a single frame
+struct frame_sample {
+    double compute = 0;
+    double render = 0;
+    unsigned long long draw_calls = 0;
+    unsigned long long allocations = 0;
+};
+
+// a bengine::loop that can be stepped one frame at a time so that every frame gets sampled
+class render_scene : public bengine::loop {
+    public:
+        render_scene() : bengine::loop("bench_render", 1280, 720, SDL_WINDOW_SHOWN, -1, false) {
+            this->profiler.enable();
+        }
+
+        frame_sample step() {
+            frame_sample output;
+            const unsigned long long draw_calls = this->window.get_draw_call_count();
+            const unsigned long long allocations = allocation_count.load(std::memory_order_relaxed);
+            this->run_frames(1);
+            output.compute = this->profiler.get_sample(bengine::frame_profiler::phases::COMPUTE);
+            output.render = this->profiler.get_sample(bengine::frame_profiler::phases::RENDER) + this->profiler.get_sample(bengine::frame_profiler::phases::PRESENT);
+            output.draw_calls = this->window.get_draw_call_count() - draw_calls;
+            output.allocations = allocation_count.load(std::memory_order_relaxed) - allocations;
+            return output;
+        }
+        const char* get_renderer_name() const {
+            SDL_RendererInfo info;
+            return SDL_GetRendererInfo(this->window.get_renderer(), &info) == 0 ? info.name : "unknown";
+        }
+};
+
+// thousands of immediate rectangles, lines, and circles
+class shapes_scene : public render_scene {
+    private:
+        unsigned long long frame = 0;
+
+        void compute() {
+            this->frame++;
+            this->visuals_changed = true;
+        }
+        void render() {
+            for (int i = 0; i < 2000; i++) {
+                const int x = (i * 37 + static_cast<int>(this->frame) * 3) % 1260, y = (i * 53) % 700;
+                this->window.fill_rectangle(x, y, 20, 20, bengine::render_window::get_color_from_preset(static_cast<bengine::render_window::preset_color>(i % 16)));
+            }
+            for (int i = 0; i < 500; i++) {
+                this->window.draw_line(i * 2, 0, 1279 - i * 2, 719, bengine::render_window::get_color_from_preset(bengine::render_window::preset_color::WHITE));
+            }
+            for (int i = 0; i < 200; i++) {
+                this->window.fill_circle((i * 61 + static_cast<int>(this->frame)) % 1280, (i * 29) % 720, 12);
+            }
+        }
+};
+
+// thousands of rotating bengine::shifting_textures, each its own copy
+class textures_scene : public render_scene {
+    private:
+        bengine::shifting_texture sprite;
+        std::vector<bengine::shifting_texture> sprites;
+        unsigned long long frame = 0;
+
+        void compute() {
+            this->frame++;
+            for (std::size_t i = 0; i < this->sprites.size(); i++) {
+                this->sprites[i].set_angle((this->frame + i) % 360);
+            }
+            this->visuals_changed = true;
+        }
+        void render() {
+            for (std::size_t i = 0; i < this->sprites.size(); i++) {
+                this->window.render_shifting_texture(this->sprites[i], {static_cast<int>(i * 41 % 1248), static_cast<int>(i * 23 % 688), 32, 32});
+            }
+        }
+
+    public:
+        textures_scene() : sprite(make_checkerboard(this->window.get_renderer(), 32, 32, 8), {0, 0, 32, 32}, {16, 16}) {
+            this->sprites.assign(2000, this->sprite);
+        }
+};
+
+// the same amount of rotating sprites as textures_scene, but through a bengine::sprite_batch
+class sprite_batch_scene : public render_scene {
+    private:
+        bengine::shifting_texture sprite;
+        std::vector<bengine::sprite_batch::instance> instances;
+        bengine::sprite_batch batch;
+        unsigned long long frame = 0;
+
+        void compute() {
+            this->frame++;
+            this->batch.clear();
+            for (std::size_t i = 0; i < this->instances.size(); i++) {
+                this->instances[i].angle = (this->frame + i) % 360;
+            }
+            this->batch.add(this->sprite, this->instances);
+            this->visuals_changed = true;
+        }
+        void render() {
+            this->window.render_sprite_batch(this->batch);
+        }
+
+    public:
+        sprite_batch_scene() : sprite(make_checkerboard(this->window.get_renderer(), 32, 32, 8), {0, 0, 32, 32}, {16, 16}) {
+            this->instances.resize(2000);
+            for (std::size_t i = 0; i < this->instances.size(); i++) {
+                this->instances[i].dst = {static_cast<int>(i * 41 % 1248), static_cast<int>(i * 23 % 688), 32, 32};
+                this->instances[i].pivot = {16, 16};
+            }
+            this->batch.reserve(this->instances.size());
+        }
+};
+
+// shapes and textures interleaved on different layers with deferred rendering, so they get sorted and batched when presenting
+class deferred_scene : public render_scene {
+    private:
+        bengine::shifting_texture sprite;
+        unsigned long long frame = 0;
+
+        void compute() {
+            this->frame++;
+            this->visuals_changed = true;
+        }
+        void render() {
+            for (int i = 0; i < 2000; i++) {
+                const int x = (i * 37 + static_cast<int>(this->frame) * 3) % 1260, y = (i * 53) % 700;
+                this->window.set_draw_layer(i % 2);
+                if (i % 2 == 0) {
+                    this->window.fill_rectangle(x, y, 20, 20, bengine::render_window::get_color_from_preset(static_cast<bengine::render_window::preset_color>(i % 16)));
+                } else {
+                    this->window.render_shifting_texture(this->sprite, {x, y, 32, 32});
+                }
+            }
+            this->window.set_draw_layer(0);
+        }
+
+    public:
+        deferred_scene() : sprite(make_checkerboard(this->window.get_renderer(), 32, 32, 8), {0, 0, 32, 32}, {16, 16}) {
+            this->window.start_deferred_rendering();
+        }
+};
+
+// a large scrolling bengine::tilemap with a tile changing every frame
+class tilemap_scene : public render_scene {
+    private:
+        SDL_Texture *tileset = NULL;
+        bengine::tilemap map = bengine::tilemap(16, 16);
+        unsigned long long frame = 0;
+
+        void compute() {
+            this->frame++;
+            this->map.set_tile(this->frame % 256, this->frame / 256 % 256, static_cast<char>(this->frame % 16));
+            this->visuals_changed = true;
+        }
+        void render() {
+            this->window.render_tilemap(this->map, -static_cast<int>(this->frame % 2816), -static_cast<int>(this->frame / 2 % 3376));
+        }
+
+    public:
+        tilemap_scene() {
+            this->tileset = make_checkerboard(this->window.get_renderer(), 64, 64, 16);
+            this->map.set_tileset(this->tileset, 4);
+            std::vector<std::vector<char>> grid(256, std::vector<char>(256));
+            for (int y = 0; y < 256; y++) {
+                for (int x = 0; x < 256; x++) {
+                    grid[y][x] = static_cast<char>((x * 7 + y * 3) % 16);
+                }
+            }
+            this->map.set_grid(grid);
+        }
+        ~tilemap_scene() {
+            SDL_DestroyTexture(this->tileset);
+        }
+};
+
+// a 100k particle fountain, with the whole system integrated, aged, and compacted every frame
+class particles_scene : public render_scene {
+    private:
+        bengine::particle_system particles;
+        unsigned int seed = 1;
+
+        float random() {
+            this->seed = this->seed * 1103515245u + 12345u;
+            return (this->seed >> 8 & 0xFFFF) / 65535.0f;
+        }
+        void compute() {
+            this->particles.update(static_cast<float>(this->delta_time));
+            bengine::particle_system::particle particle;
+            particle.x_pos = 640;
+            particle.y_pos = 600;
+            while (this->particles.get_count() < this->particles.get_max_particles()) {
+                particle.x_vel = this->random() * 400 - 200;
+                particle.y_vel = this->random() * -600;
+                particle.lifetime = 0.5f + this->random() * 2;
+                particle.color = 0xFF000000 | static_cast<std::uint32_t>(this->random() * 0xFFFFFF);
+                this->particles.emit(particle);
+            }
+            this->visuals_changed = true;
+        }
+        void render() {
+            this->window.render_particles(this->particles, 2, true);
+        }
+
+    public:
+        particles_scene() {
+            this->delta_time = 1.0 / 60;
+            this->particles.set_max_particles(100000);
+            this->particles.reserve(100000);
+            this->particles.set_gravity(0, 400);
+        }
+};
+
+/** Get a percentile of some samples
+ * \param samples The samples (gets sorted)
+ * \param percentile The percentile to get (0-1)
+ * \returns The sample at that percentile
+ */
+static double get_percentile(std::vector<double> &samples, const double &percentile) {
+    if (samples.empty()) {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<std::size_t>(percentile * (samples.size() - 1) + 0.5)];
+}
+
+template <class scene> void run_scene(const char *name, const unsigned long long &frames) {
+    // SDL_Quit clears every hint, so this has to be set before each scene's window gets made
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    scene benchmark;
+    // the first frame makes textures, caches circles, and grows buffers, which isn't what's being measured
+    benchmark.step();
+
+    std::vector<double> compute, render;
+    compute.reserve(frames);
+    render.reserve(frames);
+    unsigned long long draw_calls = 0, allocations = 0;
+    for (unsigned long long i = 0; i < frames; i++) {
+        const frame_sample sample = benchmark.step();
+        compute.push_back(sample.compute);
+        render.push_back(sample.render);
+        draw_calls += sample.draw_calls;
+        allocations += sample.allocations;
+    }
+
+    std::printf("%-12s %-10s %6llu frames | compute ms p50 %7.3f p95 %7.3f max %7.3f | render ms p50 %7.3f p95 %7.3f max %7.3f | %8.1f draw calls/frame %8.2f allocations/frame\n", name, benchmark.get_renderer_name(), frames, get_percentile(compute, 0.5), get_percentile(compute, 0.95), get_percentile(compute, 1), get_percentile(render, 0.5), get_percentile(render, 0.95), get_percentile(render, 1), static_cast<double>(draw_calls) / frames, static_cast<double>(allocations) / frames);
+}
+
+int main(int argc, char *argv[]) {
+    const unsigned long long frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 300;
+    if (frames == 0) {
+        return 0;
+    }
+    // no window ever shows up and nothing needs a GPU, so this runs on headless machines (set SDL_VIDEODRIVER to something else to watch)
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+    std::printf("bengine render benchmark (1280x720, %llu frames per scene)\n", frames);
+    run_scene<shapes_scene>("shapes", frames);
+    run_scene<textures_scene>("textures", frames);
+    run_scene<sprite_batch_scene>("sprite_batch", frames);
+    run_scene<deferred_scene>("deferred", frames);
+    run_scene<tilemap_scene>("tilemap", frames);
+    run_scene<particles_scene>("particles", frames);
+    return 0;
+}